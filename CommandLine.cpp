@@ -0,0 +1,560 @@
+/**
+* @file CommandLine.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "CommandLine.h"
+#include "MWayTree.h"
+#include "DataFile.h"
+#include "ImportPipeline.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Opções globais (--nome=valor em qualquer posição da linha de comando).
+ */
+struct CliOptions {
+    string index = "mvias.bin";
+    string data = "data.bin";
+    int order = 3;
+    int pageSize = 0;
+    WalMode wal = WalMode::FsyncPerOp;
+    bool mapped = true;
+    size_t cacheNodes = 0;
+    IoBackend io = IoBackend::Pread;
+    bool quiet = false;
+    string metricsFile;
+};
+
+/**
+ * @brief I/O acumulado de um comando (pode envolver mais de uma operação do índice e dos dados).
+ */
+struct CommandIo {
+    long long idxReads = 0;
+    long long idxWrites = 0;
+    long long cacheHits = 0;
+    long long cacheMisses = 0;
+    long long mapped = 0;
+    long long dataReads = 0;
+    long long dataWrites = 0;
+
+    void addIndex(const IndexCounters& c) {
+        idxReads += c.reads;
+        idxWrites += c.writes;
+        cacheHits += c.cacheHits;
+        cacheMisses += c.cacheMisses;
+        mapped += c.mappedReads;
+    }
+
+    void addData(pair<long long,long long> c) {
+        dataReads += c.first;
+        dataWrites += c.second;
+    }
+};
+
+/**
+ * @brief Índice e arquivo de dados abertos para uma sequência de comandos, com totais para o resumo.
+ */
+class Session {
+public:
+    explicit Session(const CliOptions& o) : opts(o) {}
+
+    bool open();
+    void close();
+
+    /**
+     * @brief Executa um comando já separado em tokens (rest = resto da linha após a chave, usado por put).
+     * @return false se o comando for inválido.
+     */
+    bool execute(const vector<string>& tokens, const string& rest);
+
+    /**
+     * @brief Grava as métricas acumuladas (índice e data.bin) como um objeto JSON em uma linha.
+     */
+    void writeMetrics(ostream& os) const;
+
+    /**
+     * @brief Comando metrics: tokens[1] opcional é o arquivo de saída ou "reset".
+     */
+    void metrics(const vector<string>& tokens);
+
+    int errors = 0;
+    long long ops = 0;
+
+private:
+    const CliOptions& opts;
+    MWayTree<> tree;
+    DataFile data;
+
+    void report(const string& line, double us, const CommandIo& io);
+    void get(int key);
+    void put(int key, const string& rest);
+    void del(int key);
+    void scan(int lo, int hi);
+    void verify();
+    void stats();
+};
+
+using Clock = chrono::steady_clock;
+
+double elapsedUs(Clock::time_point t0) {
+    return chrono::duration<double, micro>(Clock::now() - t0).count();
+}
+
+bool parseInt(const string& s, int& out) {
+    try {
+        size_t used = 0;
+        long long v = stoll(s, &used);
+        if (used != s.size() || v < numeric_limits<int>::min() || v > numeric_limits<int>::max()) return false;
+        out = static_cast<int>(v);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+void trim(string& s) {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    size_t b = s.find_last_not_of(" \t\r\n");
+    s = (a == string::npos) ? string() : s.substr(a, b - a + 1);
+}
+
+bool Session::open() {
+    if (NodeFormat::isLegacyFile(opts.index) && !NodeFormat::convertLegacy(opts.index, opts.index)) {
+        cerr << "Falha ao converter " << opts.index << " do formato antigo." << endl;
+        return false;
+    }
+    tree.setIoBackend(opts.io);
+    data.setIoBackend(opts.io);
+    if (!tree.openBinary(opts.index)) {
+        cerr << "Falha ao abrir indice " << opts.index << endl;
+        return false;
+    }
+    if (tree.getRecoveredTransactions() > 0)
+        cerr << "Recuperacao: " << tree.getRecoveredTransactions() << " transacoes reaplicadas do log." << endl;
+    if (opts.cacheNodes > 0) tree.setCacheCapacity(opts.cacheNodes);
+    tree.setWalMode(opts.wal);
+    tree.setMappedReads(opts.mapped);
+    if (!filesystem::exists(opts.data)) ofstream(opts.data, ios::binary | ios::trunc).close();
+    if (!data.open(opts.data)) {
+        cerr << "Falha ao abrir arquivo de dados " << opts.data << endl;
+        tree.closeBinary();
+        return false;
+    }
+    data.setHashIndex(true);
+    return true;
+}
+
+void Session::close() {
+    tree.commit();
+    data.close();
+    tree.closeBinary();
+}
+
+void Session::report(const string& line, double us, const CommandIo& io) {
+    ops++;
+    if (opts.quiet) return;
+    printf("%s us=%.2f idx_r=%lld idx_w=%lld hits=%lld misses=%lld mapped=%lld data_r=%lld data_w=%lld\n",
+           line.c_str(), us, io.idxReads, io.idxWrites, io.cacheHits, io.cacheMisses, io.mapped, io.dataReads,
+           io.dataWrites);
+}
+
+void Session::get(int key) {
+    CommandIo io;
+    auto t0 = Clock::now();
+    int recPos = NO_RECORD;
+    bool found = std::get<2>(tree.mSearch(key, nullptr, &recPos));
+    io.addIndex(tree.getCounters());
+    Record rec{};
+    bool hit = false;
+    if (found) {
+        hit = recPos != NO_RECORD && data.readAt(recPos, rec) && rec.key == key;
+        io.addData(data.getCounters());
+        if (!hit) {
+            hit = data.find(key, rec);
+            io.addData(data.getCounters());
+        }
+    }
+    double us = elapsedUs(t0);
+    string line = "get key=" + to_string(key) + " found=" + (found ? "1" : "0");
+    if (found) line += " rec=" + to_string(recPos);
+    if (hit) line += " payload=\"" + string(rec.payload) + "\"";
+    report(line, us, io);
+}
+
+/**
+ * @brief Insere no data.bin e no índice; rest no formato "Nome;Depto" gera payload de funcionario.
+ */
+void Session::put(int key, const string& rest) {
+    CommandIo io;
+    auto t0 = Clock::now();
+    int recPos = NO_RECORD;
+    bool exists = std::get<2>(tree.mSearch(key, nullptr, &recPos));
+    io.addIndex(tree.getCounters());
+    bool ok = false;
+    if (!exists) {
+        size_t sep = rest.find(';');
+        if (!rest.empty()) {
+            string nome = rest.substr(0, sep);
+            string depto = sep == string::npos ? string() : rest.substr(sep + 1);
+            trim(nome);
+            trim(depto);
+            ok = data.insertEmployee(key, nome, depto, recPos);
+        } else {
+            Record newRec{};
+            newRec.key = key;
+            char dept = "ABCDE"[((key % 5) + 5) % 5];
+            snprintf(newRec.payload, sizeof(newRec.payload), "Funcionario %d | depto=%c", key, dept);
+            ok = data.insert(newRec, recPos);
+        }
+        io.addData(data.getCounters());
+        if (ok) {
+            tree.insertB(key, recPos);
+            io.addIndex(tree.getCounters());
+        }
+    }
+    double us = elapsedUs(t0);
+    if (!exists && !ok) errors++;
+    report("put key=" + to_string(key) + " inserted=" + (ok ? "1" : "0") +
+           (exists || ok ? " rec=" + to_string(recPos) : string()), us, io);
+}
+
+void Session::del(int key) {
+    CommandIo io;
+    auto t0 = Clock::now();
+    int recPos = NO_RECORD;
+    bool removedIdx = tree.deleteB(key, &recPos);
+    io.addIndex(tree.getCounters());
+    bool removedData = false;
+    if (removedIdx) {
+        removedData = (recPos != NO_RECORD) ? data.removeAt(recPos, key) : data.remove(key);
+        io.addData(data.getCounters());
+    }
+    double us = elapsedUs(t0);
+    report("del key=" + to_string(key) + " removed=" + (removedIdx ? "1" : "0") +
+           " data_removed=" + (removedData ? "1" : "0"), us, io);
+}
+
+void Session::scan(int lo, int hi) {
+    CommandIo io;
+    auto t0 = Clock::now();
+    tree.resetCounters();
+    size_t count = tree.rangeScan(lo, hi, [](const int&, int) { return true; });
+    io.addIndex(tree.getCounters());
+    double us = elapsedUs(t0);
+    report("scan lo=" + to_string(lo) + " hi=" + to_string(hi) + " keys=" + to_string(count), us, io);
+}
+
+void Session::verify() {
+    CommandIo io;
+    auto t0 = Clock::now();
+    bool ok = tree.verifyIntegrity(!opts.quiet);
+    double us = elapsedUs(t0);
+    if (!ok) errors++;
+    report(string("verify ok=") + (ok ? "1" : "0"), us, io);
+}
+
+void Session::stats() {
+    CommandIo io;
+    auto t0 = Clock::now();
+    int order = 0, root = 0;
+    MWayTree<>::readHeader(opts.index, order, root);
+    FreeSpaceStats fs = tree.getFreeSpaceStats();
+    tree.resetCounters();
+    size_t keys = tree.rangeScan(numeric_limits<int>::min(), numeric_limits<int>::max(),
+                                 [](const int&, int) { return true; });
+    io.addIndex(tree.getCounters());
+    vector<int> active;
+    data.listActiveKeys(active);
+    double us = elapsedUs(t0);
+    error_code ec;
+    auto dataBytes = filesystem::file_size(opts.data, ec);
+    report("stats m=" + to_string(order) + " root=" + to_string(root) + " keys=" + to_string(keys) +
+           " nodes=" + to_string(fs.totalNodes) + " free_nodes=" + to_string(fs.freeNodes) +
+           " index_bytes=" + to_string(fs.fileBytes) + " free_bytes=" + to_string(fs.freeBytes) +
+           " data_active=" + to_string(active.size()) + " data_bytes=" + to_string(ec ? 0 : dataBytes), us, io);
+}
+
+void Session::writeMetrics(ostream& os) const {
+    const TreeMetrics& tm = tree.getMetrics();
+    os << "{\"index\":{\"search\":";
+    tm.search.writeJson(os);
+    os << ",\"insert\":";
+    tm.insert.writeJson(os);
+    os << ",\"delete\":";
+    tm.remove.writeJson(os);
+    os << "},\"data\":{\"find\":";
+    data.getFindMetrics().writeJson(os);
+    os << "}}\n";
+}
+
+/**
+ * @brief metrics [arquivo|reset]: imprime (ou grava em arquivo) a fotografia das métricas, ou as zera.
+ */
+void Session::metrics(const vector<string>& tokens) {
+    if (tokens.size() > 1 && tokens[1] == "reset") {
+        tree.resetMetrics();
+        data.resetMetrics();
+        return;
+    }
+    if (tokens.size() > 1) {
+        ofstream out(tokens[1]);
+        writeMetrics(out);
+        if (!out) {
+            cerr << "Falha ao gravar " << tokens[1] << endl;
+            errors++;
+        }
+        return;
+    }
+    writeMetrics(cout);
+}
+
+bool Session::execute(const vector<string>& tokens, const string& rest) {
+    if (tokens.empty()) return true;
+    const string& cmd = tokens[0];
+    if (cmd == "metrics") {
+        if (tokens.size() > 2) return false;
+        metrics(tokens);
+        return true;
+    }
+    vector<int> args;
+    size_t numeric = (cmd == "put") ? min<size_t>(tokens.size(), 2) : tokens.size();
+    for (size_t i = 1; i < numeric; ++i) {
+        int v = 0;
+        if (!parseInt(tokens[i], v)) return false;
+        args.push_back(v);
+    }
+    if (cmd == "get" && !args.empty()) {
+        for (int k : args) get(k);
+    } else if (cmd == "del" && !args.empty()) {
+        for (int k : args) del(k);
+    } else if (cmd == "put" && args.size() == 1) {
+        put(args[0], rest);
+    } else if (cmd == "scan" && args.size() == 2) {
+        scan(args[0], args[1]);
+    } else if (cmd == "verify" && args.empty()) {
+        verify();
+    } else if (cmd == "stats" && args.empty()) {
+        stats();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Separa uma linha de comando; rest recebe o texto após o segundo token (nome;depto do put).
+ */
+vector<string> tokenize(const string& line, string& rest) {
+    istringstream in(line);
+    vector<string> tokens;
+    string t;
+    while (in >> t) tokens.push_back(t);
+    rest.clear();
+    if (tokens.size() > 2) {
+        size_t at = line.find(tokens[1], line.find(tokens[0]) + tokens[0].size());
+        at = line.find_first_not_of(" \t", at + tokens[1].size());
+        if (at != string::npos) rest = line.substr(at);
+        trim(rest);
+    }
+    return tokens;
+}
+
+void printUsage() {
+    cerr << "uso: MWaysSearch [opcoes] <comando> [argumentos]\n"
+            "comandos:\n"
+            "  build [arquivo.txt]        cria o indice (vazio ou a partir de um .txt de nos) e o data.bin\n"
+            "  load [employees.txt|-]     cria data.bin a partir de linhas id;Nome;Depto e carrega o indice em lote\n"
+            "  get CHAVE...               busca chaves (indice + registro)\n"
+            "  put CHAVE [Nome;Depto]     insere chave e registro\n"
+            "  del CHAVE...               remove chaves do indice e do data.bin\n"
+            "  scan INICIO FIM            conta as chaves do intervalo\n"
+            "  verify                     verifica a integridade do indice\n"
+            "  stats                      resume indice e arquivo de dados\n"
+            "  metrics [arquivo|reset]    metricas acumuladas em JSON (contadores e latencias por operacao)\n"
+            "  batch [arquivo|-]          executa um comando por linha (get/put/del/scan/verify/stats/metrics)\n"
+            "opcoes:\n"
+            "  --index=ARQ (mvias.bin)  --data=ARQ (data.bin)  --m=ORDEM (3)  --page=BYTES (0)\n"
+            "  --wal=off|op|group (op)  --mapped=0|1 (1)  --cache=NOS  --io=pread|uring (pread)  --quiet\n"
+            "  --metrics=ARQ            grava as metricas acumuladas em JSON ao final\n";
+}
+
+bool parseOption(const string& arg, CliOptions& o) {
+    if (arg == "--quiet") {
+        o.quiet = true;
+        return true;
+    }
+    size_t eq = arg.find('=');
+    if (eq == string::npos) return false;
+    string name = arg.substr(2, eq - 2);
+    string value = arg.substr(eq + 1);
+    if (name == "index") o.index = value;
+    else if (name == "data") o.data = value;
+    else if (name == "m") return parseInt(value, o.order) && o.order >= 3 && o.order <= MAX_M;
+    else if (name == "page") return parseInt(value, o.pageSize) && o.pageSize >= 0;
+    else if (name == "mapped") o.mapped = value != "0";
+    else if (name == "metrics") o.metricsFile = value;
+    else if (name == "cache") o.cacheNodes = static_cast<size_t>(atoll(value.c_str()));
+    else if (name == "io") return parseIoBackend(value, o.io);
+    else if (name == "wal") {
+        if (value == "off") o.wal = WalMode::Off;
+        else if (value == "op") o.wal = WalMode::FsyncPerOp;
+        else if (value == "group") o.wal = WalMode::GroupCommit;
+        else return false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Linha de resultado de uma importação (leituras da entrada e bytes gravados).
+ */
+void printImport(const char* op, int order, double us, const ImportStats& is) {
+    printf("%s m=%d keys=%lld us=%.2f input_passes=%d input_bytes=%lld bytes_written=%lld data_bytes=%lld "
+           "index_bytes=%lld sort_bytes=%lld\n", op, order, is.records, us, is.inputPasses, is.inputBytes,
+           is.bytesWritten(), is.dataBytes, is.indexBytes, is.sortBytes);
+}
+
+int build(const CliOptions& o, const vector<string>& args) {
+    auto t0 = Clock::now();
+    bool ok;
+    ImportStats is;
+    if (!args.empty()) {
+        ok = importNodeText(args[0], o.index, o.data, o.order, is, o.pageSize);
+    } else {
+        ok = MWayTree<>::createEmpty(o.index, o.order, o.pageSize);
+        if (ok) ofstream(o.data, ios::binary | ios::trunc).close();
+        remove(HashIndex::pathFor(o.data).c_str());
+    }
+    double us = elapsedUs(t0);
+    if (!ok) {
+        cerr << "Falha ao criar " << o.index << "/" << o.data << endl;
+        return 1;
+    }
+    int order = 0, root = 0;
+    MWayTree<>::readHeader(o.index, order, root);
+    if (!o.quiet && !args.empty()) printImport("build", order, us, is);
+    else if (!o.quiet) printf("build m=%d us=%.2f\n", order, us);
+    return 0;
+}
+
+int load(const CliOptions& o, const vector<string>& args) {
+    auto t0 = Clock::now();
+    ImportStats is;
+    bool ok;
+    if (args.empty() || args[0] == "-") {
+        ok = importEmployees(cin, o.index, o.data, o.order, is, o.pageSize);
+    } else {
+        ok = importEmployees(args[0], o.index, o.data, o.order, is, o.pageSize);
+    }
+    DataFile data;
+    if (!ok || !data.open(o.data) || !data.setHashIndex(true)) {
+        cerr << "Falha na carga de " << o.index << "/" << o.data << endl;
+        return 1;
+    }
+    data.close();
+    double us = elapsedUs(t0);
+    int order = 0, root = 0;
+    MWayTree<>::readHeader(o.index, order, root);
+    if (!o.quiet) printImport("load", order, us, is);
+    return 0;
+}
+
+}
+
+int runCommandLine(int argc, char** argv) {
+    CliOptions opts;
+    vector<string> positional;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--", 0) == 0) {
+            if (!parseOption(arg, opts)) {
+                cerr << "Opcao invalida: " << arg << endl;
+                printUsage();
+                return 2;
+            }
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.empty() || positional[0] == "help") {
+        printUsage();
+        return positional.empty() ? 2 : 0;
+    }
+    const string cmd = positional[0];
+    vector<string> args(positional.begin() + 1, positional.end());
+    if (cmd == "build") return build(opts, args);
+    if (cmd == "load") return load(opts, args);
+    if (cmd != "batch" && cmd != "get" && cmd != "put" && cmd != "del" && cmd != "scan" && cmd != "verify" &&
+        cmd != "stats" && cmd != "metrics") {
+        cerr << "Comando desconhecido: " << cmd << endl;
+        printUsage();
+        return 2;
+    }
+    if (!filesystem::exists(opts.index)) {
+        cerr << "Indice inexistente: " << opts.index << " (use build ou load)." << endl;
+        return 1;
+    }
+
+    Session session(opts);
+    if (!session.open()) return 1;
+    auto t0 = Clock::now();
+    int invalid = 0;
+    if (cmd == "batch") {
+        ifstream file;
+        if (!args.empty() && args[0] != "-") {
+            file.open(args[0]);
+            if (!file.is_open()) {
+                cerr << "Falha ao abrir " << args[0] << endl;
+                session.close();
+                return 1;
+            }
+        }
+        istream& in = file.is_open() ? static_cast<istream&>(file) : cin;
+        string line, rest;
+        int lineNo = 0;
+        while (getline(in, line)) {
+            ++lineNo;
+            size_t hash = line.find('#');
+            if (hash != string::npos) line.resize(hash);
+            vector<string> tokens = tokenize(line, rest);
+            if (!session.execute(tokens, rest)) {
+                cerr << "linha " << lineNo << ": comando invalido: " << line << endl;
+                invalid++;
+            }
+        }
+    } else {
+        string rest;
+        for (size_t i = 1; i < args.size(); ++i) rest += (rest.empty() ? "" : " ") + args[i];
+        vector<string> tokens = positional;
+        if (!session.execute(tokens, rest)) {
+            cerr << "Argumentos invalidos para " << cmd << endl;
+            printUsage();
+            session.close();
+            return 2;
+        }
+    }
+    if (!opts.metricsFile.empty()) session.metrics({"metrics", opts.metricsFile});
+    session.close();
+    double seconds = chrono::duration<double>(Clock::now() - t0).count();
+    printf("total ops=%lld invalid=%d errors=%d seconds=%.6f ops_per_sec=%.1f\n", session.ops, invalid,
+           session.errors, seconds, seconds > 0 ? static_cast<double>(session.ops) / seconds : 0.0);
+    return (invalid > 0 || session.errors > 0) ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+/**
+* @file CommandLine.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+/**
+ * @brief Modo não interativo: executa um subcomando (build, load, get, put, del, scan, verify, stats, batch).
+ * @details Nenhuma impressão da árvore; cada comando gera uma linha "op chave=valor ..." com o resultado,
+ *          o tempo em µs e os contadores de I/O, e a execução termina com uma linha de resumo.
+ *          batch lê um comando por linha de um arquivo ou de stdin, permitindo reproduzir traces.
+ * @param argc Quantidade de argumentos (argv[1] em diante: opções --nome=valor e o subcomando).
+ * @param argv Argumentos do processo.
+ * @return Código de saída (0 sucesso, 1 falha de operação, 2 uso inválido).
+ */
+int runCommandLine(int argc, char** argv);
+
+#endif
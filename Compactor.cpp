@@ -0,0 +1,311 @@
+/**
+* @file Compactor.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "Compactor.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+using namespace std;
+
+Compactor::Compactor(MWayTree<>& tree_, DataFile& data_, CompactLayout layout_)
+    : tree(tree_), data(data_), layout(layout_) {
+}
+
+Compactor::~Compactor() {
+    closeStreams();
+    if (!indexTmp.empty()) std::remove(indexTmp.c_str());
+    if (!dataTmp.empty()) std::remove(dataTmp.c_str());
+}
+
+void Compactor::closeStreams() {
+    if (indexIn.is_open()) indexIn.close();
+    if (dataIn.is_open()) dataIn.close();
+    if (indexOut.is_open()) indexOut.close();
+    if (dataOut.is_open()) dataOut.close();
+}
+
+/**
+ * @brief (Re)inicia a compactação: grava pendências do índice, registra as gerações e abre os originais.
+ * @return false se algum arquivo não puder ser aberto.
+ */
+bool Compactor::begin() {
+    closeStreams();
+    bfs.clear();
+    firstChild.clear();
+    childCount.clear();
+    order.clear();
+    newPos.clear();
+    entries.clear();
+    cursor = 0;
+    recordsRead = 0;
+
+    tree.sync();
+    treeGeneration = tree.getGeneration();
+    dataGeneration = data.getGeneration();
+    indexTmp = tree.getFilename() + ".compact";
+    dataTmp = data.getFilename() + ".compact";
+
+    indexIn.open(tree.getFilename(), ios::binary);
+    dataIn.open(data.getFilename(), ios::binary);
+    if (!indexIn.is_open() || !dataIn.is_open()) return false;
+    nodeBuf.assign(static_cast<size_t>(tree.fmt.stride), 0);
+
+    stats.nodesBefore = tree.nodeCount;
+    stats.indexBytesBefore = tree.fmt.dataStart + static_cast<long long>(tree.nodeCount) * tree.fmt.stride;
+    stats.nodesAfter = 0;
+    stats.recordsBefore = 0;
+    stats.recordsAfter = 0;
+
+    if (tree.root != 0) bfs.push_back(tree.root);
+    newPos.assign(static_cast<size_t>(tree.nodeCount) + 1, 0);
+    if (tree.root != 0) newPos[tree.root] = -1;
+    phase = Phase::Scan;
+    return true;
+}
+
+/**
+ * @brief Leitura direta do arquivo original (não passa pelo cache de nós da árvore).
+ */
+bool Compactor::readOldNode(int position, Node& node) {
+    indexIn.seekg(tree.fmt.offsetOf(position), ios::beg);
+    indexIn.read(nodeBuf.data(), tree.fmt.stride);
+    if (!indexIn.good()) return false;
+    tree.fmt.decode(nodeBuf.data(), node);
+    return true;
+}
+
+/**
+ * @brief Percorre a árvore em largura a partir da raiz; os filhos de cada nó ficam contíguos em bfs.
+ * @details newPos marca (-1) os nós já enfileirados; posição repetida ou fora do arquivo indica índice
+ *          inconsistente.
+ */
+bool Compactor::scanStep(size_t budget) {
+    for (size_t done = 0; done < budget && cursor < bfs.size(); ++done, ++cursor) {
+        Node node{};
+        if (!readOldNode(bfs[cursor], node) || node.n < 0 || node.n > tree.m - 1) return false;
+        firstChild.push_back(static_cast<int>(bfs.size()));
+        int count = 0;
+        for (int i = 0; i <= node.n; ++i) {
+            int c = node.children[i];
+            if (c == 0) continue;
+            if (c < 1 || c > tree.nodeCount || newPos[c] != 0) return false;
+            newPos[c] = -1;
+            bfs.push_back(c);
+            count++;
+        }
+        childCount.push_back(count);
+    }
+    if (cursor < bfs.size()) return true;
+
+    buildOrder();
+    for (size_t i = 0; i < order.size(); ++i) newPos[bfs[order[i]]] = static_cast<int>(i) + 1;
+    stats.nodesAfter = static_cast<int>(order.size());
+    cursor = 0;
+    phase = Phase::CollectData;
+    return true;
+}
+
+/**
+ * @brief Define a ordem física; van Emde Boas cai para BFS se a árvore não estiver balanceada.
+ */
+void Compactor::buildOrder() {
+    order.clear();
+    if (layout == CompactLayout::VanEmdeBoas && !bfs.empty()) {
+        int height = 1;
+        for (int idx = 0; childCount[idx] > 0; idx = firstChild[idx]) height++;
+        vebOrder(0, height);
+        vector<char> seen(bfs.size(), 0);
+        bool ok = order.size() == bfs.size();
+        for (size_t i = 0; ok && i < order.size(); ++i) {
+            ok = order[i] >= 0 && order[i] < static_cast<int>(bfs.size()) && !seen[order[i]];
+            if (ok) seen[order[i]] = 1;
+        }
+        if (ok) return;
+        order.clear();
+    }
+    for (size_t i = 0; i < bfs.size(); ++i) order.push_back(static_cast<int>(i));
+}
+
+/**
+ * @brief Layout van Emde Boas da subárvore de altura 'height' em bfs[idx]: metade superior, depois cada
+ *        subárvore inferior da esquerda para a direita.
+ * @details Em BFS os descendentes de um nó em um mesmo nível são contíguos, então as raízes das
+ *          subárvores inferiores formam o intervalo [lo, hi) obtido descendo 'top' níveis.
+ */
+void Compactor::vebOrder(int idx, int height) {
+    if (height == 1) {
+        order.push_back(idx);
+        return;
+    }
+    int top = height / 2;
+    int bottom = height - top;
+    vebOrder(idx, top);
+    int lo = idx;
+    int hi = idx + 1;
+    for (int d = 0; d < top && lo < hi; ++d) {
+        int nlo = firstChild[lo];
+        int nhi = firstChild[hi - 1] + childCount[hi - 1];
+        lo = nlo;
+        hi = nhi;
+    }
+    for (int c = lo; c < hi; ++c) vebOrder(c, bottom);
+}
+
+/**
+ * @brief Lê o arquivo de dados sequencialmente coletando (chave, registro) dos ativos; ao fim ordena por chave.
+ */
+bool Compactor::collectStep(size_t budget) {
+    Record r{};
+    for (size_t done = 0; done < budget; ++done) {
+        if (!dataIn.read(reinterpret_cast<char*>(&r), sizeof(Record))) {
+            dataIn.clear();
+            stable_sort(entries.begin(), entries.end(),
+                        [](const pair<int,int>& a, const pair<int,int>& b) { return a.first < b.first; });
+            stats.recordsBefore = recordsRead;
+            stats.recordsAfter = static_cast<int>(entries.size());
+            stats.dataBytesBefore = static_cast<long long>(recordsRead) * sizeof(Record);
+            dataOut.open(dataTmp, ios::binary | ios::trunc);
+            if (!dataOut.is_open()) return false;
+            cursor = 0;
+            phase = Phase::CopyData;
+            return true;
+        }
+        if (r.active == 1) entries.emplace_back(r.key, recordsRead);
+        recordsRead++;
+    }
+    return true;
+}
+
+/**
+ * @brief Copia os registros ativos para o temporário em ordem de chave (novo número = índice em entries).
+ */
+bool Compactor::copyStep(size_t budget) {
+    Record r{};
+    for (size_t done = 0; done < budget && cursor < entries.size(); ++done, ++cursor) {
+        dataIn.seekg(static_cast<streamoff>(entries[cursor].second) * sizeof(Record), ios::beg);
+        if (!dataIn.read(reinterpret_cast<char*>(&r), sizeof(Record))) return false;
+        dataOut.write(reinterpret_cast<const char*>(&r), sizeof(Record));
+    }
+    if (cursor < entries.size()) return true;
+
+    dataOut.close();
+    if (!dataOut) return false;
+    stats.dataBytesAfter = static_cast<long long>(entries.size()) * sizeof(Record);
+
+    indexOut.open(indexTmp, ios::binary | ios::trunc);
+    if (!indexOut.is_open()) return false;
+    const NodeFormat& f = tree.fmt;
+    vector<char> hdr(static_cast<size_t>(f.dataStart), 0);
+    f.encodeHeader(order.empty() ? 0 : 1, hdr.data());
+    indexOut.write(hdr.data(), f.dataStart);
+    cursor = 0;
+    phase = Phase::WriteIndex;
+    return static_cast<bool>(indexOut);
+}
+
+/**
+ * @brief Novo número de registro da chave (primeiro ativo com a chave) ou NO_RECORD.
+ */
+int Compactor::newRecordOf(int key) const {
+    auto it = lower_bound(entries.begin(), entries.end(), key,
+                          [](const pair<int,int>& e, int k) { return e.first < k; });
+    if (it == entries.end() || it->first != key) return NO_RECORD;
+    return static_cast<int>(it - entries.begin());
+}
+
+/**
+ * @brief Grava os nós na nova ordem (escrita sequencial), remapeando filhos e ponteiros de registro.
+ */
+bool Compactor::writeStep(size_t budget) {
+    const NodeFormat& f = tree.fmt;
+    for (size_t done = 0; done < budget && cursor < order.size(); ++done, ++cursor) {
+        Node node{};
+        if (!readOldNode(bfs[order[cursor]], node)) return false;
+        for (int i = 0; i <= node.n; ++i) {
+            if (node.children[i] != 0) node.children[i] = newPos[node.children[i]];
+        }
+        for (int i = 0; i < node.n; ++i) node.recs[i] = newRecordOf(node.keys[i]);
+        f.encode(node, nodeBuf.data());
+        indexOut.write(nodeBuf.data(), f.stride);
+    }
+    if (cursor < order.size()) return static_cast<bool>(indexOut);
+
+    indexOut.close();
+    if (!indexOut) return false;
+    stats.indexBytesAfter = f.dataStart + static_cast<long long>(order.size()) * f.stride;
+    phase = Phase::Ready;
+    return true;
+}
+
+/**
+ * @brief Um passo de trabalho; recomeça do zero se o índice ou os dados mudaram desde o passo anterior.
+ * @param budget Unidades por passo.
+ * @return false em falha de I/O ou índice inconsistente.
+ */
+bool Compactor::step(size_t budget) {
+    if (budget == 0) budget = 1;
+    if (phase != Phase::Start &&
+        (tree.getGeneration() != treeGeneration || data.getGeneration() != dataGeneration)) {
+        stats.restarts++;
+        phase = Phase::Start;
+    }
+    if (phase == Phase::Start && !begin()) return false;
+    stats.steps++;
+    switch (phase) {
+        case Phase::Scan:        return scanStep(budget);
+        case Phase::CollectData: return collectStep(budget);
+        case Phase::CopyData:    return copyStep(budget);
+        case Phase::WriteIndex:  return writeStep(budget);
+        default:                 return true;
+    }
+}
+
+/**
+ * @brief Troca os arquivos por rename e reabre índice e dados.
+ * @details O arquivo de dados é trocado primeiro; se o processo parar entre as duas trocas, o índice antigo
+ *          aponta registros com numeração nova e a busca cai na varredura sequencial (a chave do registro
+ *          lido não confere).
+ */
+bool Compactor::finish() {
+    if (!done()) return false;
+    if (tree.getGeneration() != treeGeneration || data.getGeneration() != dataGeneration) {
+        stats.restarts++;
+        phase = Phase::Start;
+        return false;
+    }
+    closeStreams();
+    string indexName = tree.getFilename();
+    string dataName = data.getFilename();
+    bool hashed = data.hasHashIndex();
+    tree.closeBinary();
+    data.setHashIndex(false);
+    data.close();
+
+    error_code ec;
+    filesystem::rename(dataTmp, dataName, ec);
+    bool ok = !ec;
+    if (ok) {
+        filesystem::rename(indexTmp, indexName, ec);
+        ok = !ec;
+    }
+    bool reopened = tree.openBinary(indexName) && data.open(dataName) && (!hashed || data.setHashIndex(true));
+    phase = Phase::Start;
+    return ok && reopened;
+}
+
+bool Compactor::run(size_t budget) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        while (!done()) {
+            if (!step(budget)) return false;
+        }
+        if (finish()) return true;
+    }
+    return false;
+}
@@ -0,0 +1,144 @@
+/**
+* @file Compactor.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef COMPACTOR_H
+#define COMPACTOR_H
+
+#include "MWayTree.h"
+#include "DataFile.h"
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Unidades de trabalho (nós ou registros) por passo padrão da compactação.
+ */
+const std::size_t COMPACT_STEP_DEFAULT = 1024;
+
+/**
+ * @brief Ordem física dos nós no índice compactado.
+ * @details BreadthFirst grava nível a nível (raiz na posição 1); VanEmdeBoas grava recursivamente a metade
+ *          superior da árvore seguida de cada subárvore inferior, de modo que um caminho raiz-folha
+ *          toque poucos blocos contíguos.
+ */
+enum class CompactLayout { BreadthFirst, VanEmdeBoas };
+
+/**
+ * @brief Resultado da compactação (valores antes/depois e reinícios por alteração concorrente).
+ */
+struct CompactStats {
+    int nodesBefore = 0;
+    int nodesAfter = 0;
+    int recordsBefore = 0;
+    int recordsAfter = 0;
+    long long indexBytesBefore = 0;
+    long long indexBytesAfter = 0;
+    long long dataBytesBefore = 0;
+    long long dataBytesAfter = 0;
+    int steps = 0;
+    int restarts = 0;
+};
+
+/**
+ * @brief Compactação incremental de mvias.bin e data.bin.
+ * @details Reescreve o índice sem nós livres (ordem BFS ou van Emde Boas, ponteiros de filhos remapeados)
+ *          e o arquivo de dados apenas com registros ativos, em ordem de chave (recs do índice remapeados).
+ *          O trabalho é feito em passos (step) sobre arquivos temporários, sem tocar nos originais: entre
+ *          passos a árvore e o arquivo de dados continuam utilizáveis. Se algum deles for modificado no
+ *          meio do processo, a compactação recomeça. finish() troca os arquivos por rename (data.bin
+ *          primeiro, depois mvias.bin) e reabre ambos; o índice hash do data.bin, se existir, é reconstruído.
+ */
+class Compactor {
+public:
+    /**
+     * @brief Prepara a compactação da árvore e do arquivo de dados abertos.
+     * @param tree Índice aberto.
+     * @param data Arquivo de dados aberto (o referenciado pelos recs do índice).
+     * @param layout Ordem física dos nós no novo índice.
+     */
+    Compactor(MWayTree<>& tree, DataFile& data, CompactLayout layout = CompactLayout::BreadthFirst);
+
+    /**
+     * @brief Destrutor: remove temporários de uma compactação não concluída.
+     */
+    ~Compactor();
+
+    Compactor(const Compactor&) = delete;
+    Compactor& operator=(const Compactor&) = delete;
+
+    /**
+     * @brief Executa até 'budget' unidades de trabalho (nós lidos/gravados ou registros copiados).
+     * @param budget Unidades por passo.
+     * @return false em falha de I/O ou índice inconsistente.
+     */
+    bool step(std::size_t budget = COMPACT_STEP_DEFAULT);
+
+    /**
+     * @brief true quando os arquivos compactados estão prontos para a troca.
+     */
+    bool done() const { return phase == Phase::Ready; }
+
+    /**
+     * @brief Troca os arquivos e reabre índice e dados.
+     * @return false se ainda não concluído, se houve modificação desde o último passo (a compactação
+     *         recomeça) ou em falha de I/O.
+     */
+    bool finish();
+
+    /**
+     * @brief Executa todos os passos e a troca de uma só vez.
+     * @param budget Unidades por passo.
+     * @return true em caso de sucesso.
+     */
+    bool run(std::size_t budget = COMPACT_STEP_DEFAULT);
+
+    const CompactStats& getStats() const { return stats; }
+
+private:
+    enum class Phase { Start, Scan, CollectData, CopyData, WriteIndex, Ready };
+
+    MWayTree<>& tree;
+    DataFile& data;
+    CompactLayout layout;
+    Phase phase = Phase::Start;
+    CompactStats stats;
+    long long treeGeneration = 0;
+    long long dataGeneration = 0;
+    std::string indexTmp;
+    std::string dataTmp;
+    std::ifstream indexIn;
+    std::ifstream dataIn;
+    std::ofstream indexOut;
+    std::ofstream dataOut;
+    std::vector<char> nodeBuf;
+
+    std::vector<int> bfs;           // posições antigas em ordem BFS
+    std::vector<int> firstChild;    // índice BFS do primeiro filho de bfs[i]
+    std::vector<int> childCount;
+    std::vector<int> order;         // order[p-1] = índice BFS do nó gravado na nova posição p
+    std::vector<int> newPos;        // posição antiga -> nova posição
+    std::vector<std::pair<int,int>> entries;  // (chave, registro antigo) dos ativos, ordenados por chave
+    std::size_t cursor = 0;
+    int recordsRead = 0;
+
+    bool begin();
+    bool scanStep(std::size_t budget);
+    bool collectStep(std::size_t budget);
+    bool copyStep(std::size_t budget);
+    bool writeStep(std::size_t budget);
+    bool readOldNode(int position, Node& node);
+    void buildOrder();
+    void vebOrder(int idx, int height);
+    int newRecordOf(int key) const;
+    void closeStreams();
+};
+
+#endif
@@ -0,0 +1,698 @@
+/**
+* @file ConcurrentTree.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "ConcurrentTree.h"
+#include "NodeSearch.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+NodeTable::~NodeTable() {
+    for (auto& b : blocks) delete[] b.load();
+}
+
+VersionedNode& NodeTable::of(int position) {
+    const int b = position / BLOCK;
+    VersionedNode* block = blocks[b].load(memory_order_acquire);
+    if (!block) {
+        VersionedNode* fresh = new VersionedNode[BLOCK];
+        if (blocks[b].compare_exchange_strong(block, fresh, memory_order_acq_rel)) block = fresh;
+        else delete[] fresh;
+    }
+    return block[position % BLOCK];
+}
+
+ConcurrentTree::ConcurrentTree(MWayTree<>& tree_)
+    : tree(tree_), m(tree_.m), minK(tree_.minKeys()), fmt(tree_.fmt), root(tree_.root),
+      nodeCount(tree_.nodeCount), freeHead(tree_.freeHead), freeCount(tree_.freeCount) {
+    if (!tree.io->isOpen() || tree.walMode != WalMode::Off) return;
+    tree.sync();
+    fd = ::open(tree.filename.c_str(), O_RDWR);
+    root = tree.root;
+    nodeCount = tree.nodeCount;
+    freeHead = tree.freeHead;
+    freeCount = tree.freeCount;
+}
+
+ConcurrentTree::~ConcurrentTree() {
+    if (fd < 0) return;
+    storeHeader();
+    ::close(fd);
+    tree.root = root;
+    tree.nodeCount = nodeCount;
+    tree.freeHead = freeHead;
+    tree.freeCount = freeCount;
+    tree.headerDirty = false;
+    tree.generation++;
+    tree.cache.clear();
+    tree.pinRoot();
+}
+
+/**
+ * @brief Espera a versão ficar par (nó livre) e a devolve; cede a CPU após algumas voltas.
+ */
+uint64_t ConcurrentTree::awaitUnlocked(const atomic<uint64_t>& version) {
+    int spins = 0;
+    uint64_t v = version.load(memory_order_acquire);
+    while (v & 1) {
+        if (++spins > 64) this_thread::yield();
+        v = version.load(memory_order_acquire);
+    }
+    return v;
+}
+
+bool ConcurrentTree::validate(const atomic<uint64_t>& version, uint64_t seen) {
+    atomic_thread_fence(memory_order_acquire);
+    return version.load(memory_order_relaxed) == seen;
+}
+
+void ConcurrentTree::lockExclusive(atomic<uint64_t>& version) {
+    while (true) {
+        uint64_t v = awaitUnlocked(version);
+        if (version.compare_exchange_weak(v, v + 1, memory_order_acquire)) break;
+    }
+    atomic_thread_fence(memory_order_release);
+}
+
+bool ConcurrentTree::tryUpgrade(atomic<uint64_t>& version, uint64_t seen) {
+    if (!version.compare_exchange_strong(seen, seen + 1, memory_order_acquire)) return false;
+    atomic_thread_fence(memory_order_release);
+    return true;
+}
+
+void ConcurrentTree::unlockExclusive(atomic<uint64_t>& version) {
+    version.fetch_add(1, memory_order_release);
+}
+
+/**
+ * @brief Cópia do nó palavra a palavra; só é confiável se a versão for validada em seguida.
+ */
+void ConcurrentTree::snapshot(const VersionedNode& entry, Node& out) {
+    Node& src = const_cast<Node&>(entry.node);
+    int n = atomic_ref<int>(src.n).load(memory_order_relaxed);
+    out.n = n;
+    n = min(max(n, 0), MAX_M - 1);
+    for (int i = 0; i < n; ++i) {
+        out.keys[i] = atomic_ref<int>(src.keys[i]).load(memory_order_relaxed);
+        out.recs[i] = atomic_ref<int>(src.recs[i]).load(memory_order_relaxed);
+    }
+    for (int i = 0; i <= n; ++i) out.children[i] = atomic_ref<int>(src.children[i]).load(memory_order_relaxed);
+}
+
+/**
+ * @brief Entrada da posição, carregada do disco (pread) no primeiro acesso.
+ */
+VersionedNode& ConcurrentTree::entry(int position) {
+    VersionedNode& e = table.of(position);
+    if (!e.loaded.load(memory_order_acquire)) {
+        lockExclusive(e.version);
+        if (!e.loaded.load(memory_order_relaxed)) {
+            Node node = readDisk(position);
+            for (int i = 0; i < MAX_M; ++i) {
+                atomic_ref<int>(e.node.keys[i]).store(node.keys[i], memory_order_relaxed);
+                atomic_ref<int>(e.node.recs[i]).store(node.recs[i], memory_order_relaxed);
+            }
+            for (int i = 0; i <= MAX_M; ++i) atomic_ref<int>(e.node.children[i]).store(node.children[i], memory_order_relaxed);
+            atomic_ref<int>(e.node.n).store(node.n, memory_order_relaxed);
+            e.loaded.store(true, memory_order_release);
+        }
+        unlockExclusive(e.version);
+    }
+    return e;
+}
+
+void ConcurrentTree::lockNode(int position) {
+    lockExclusive(entry(position).version);
+}
+
+void ConcurrentTree::unlockNode(int position) {
+    unlockExclusive(table.of(position).version);
+}
+
+Node ConcurrentTree::readDisk(int position) {
+    thread_local vector<char> buf;
+    buf.resize(fmt.stride);
+    Node node{};
+    if (::pread(fd, buf.data(), fmt.stride, fmt.offsetOf(position)) == fmt.stride) fmt.decode(buf.data(), node);
+    reads.fetch_add(1, memory_order_relaxed);
+    return node;
+}
+
+/**
+ * @brief Nó da tabela; chamado por quem detém o lock da posição (ou para nós livres, sob allocLatch).
+ */
+Node ConcurrentTree::load(int position) {
+    Node node{};
+    snapshot(entry(position), node);
+    return node;
+}
+
+/**
+ * @brief Atualiza a tabela e grava o nó (pwrite); o chamador detém o lock da posição.
+ */
+void ConcurrentTree::store(const Node& node, int position) {
+    VersionedNode& e = table.of(position);
+    for (int i = 0; i < MAX_M; ++i) {
+        atomic_ref<int>(e.node.keys[i]).store(node.keys[i], memory_order_relaxed);
+        atomic_ref<int>(e.node.recs[i]).store(node.recs[i], memory_order_relaxed);
+    }
+    for (int i = 0; i <= MAX_M; ++i) atomic_ref<int>(e.node.children[i]).store(node.children[i], memory_order_relaxed);
+    atomic_ref<int>(e.node.n).store(node.n, memory_order_relaxed);
+    e.loaded.store(true, memory_order_release);
+
+    thread_local vector<char> buf;
+    buf.resize(fmt.stride);
+    fmt.encode(node, buf.data());
+    ::pwrite(fd, buf.data(), fmt.stride, fmt.offsetOf(position));
+    writes.fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * @brief Posição para um nó novo (topo da lista de livres ou fim do arquivo), já gravado.
+ * @details Grava sem travar a posição: quem a liberou já mudou a versão (leitores que a tinham como filho
+ *          falham na validação) e pode ainda estar com o lock dela, esperando um irmão que o chamador trava.
+ *          O nó só fica alcançável quando o pai (travado pelo chamador) passa a apontá-lo.
+ */
+int ConcurrentTree::allocate(const Node& node) {
+    int position;
+    {
+        lock_guard<mutex> g(allocLatch);
+        if (freeHead != 0) {
+            position = freeHead;
+            freeHead = load(position).children[0];
+            freeCount--;
+        } else {
+            position = ++nodeCount;
+        }
+    }
+    store(node, position);
+    return position;
+}
+
+/**
+ * @brief Devolve à lista de livres o nó da posição, travado pelo chamador.
+ */
+void ConcurrentTree::release(int position) {
+    lock_guard<mutex> g(allocLatch);
+    Node f{};
+    f.n = FREE_NODE;
+    f.children[0] = freeHead;
+    store(f, position);
+    freeHead = position;
+    freeCount++;
+}
+
+void ConcurrentTree::storeHeader() {
+    lock_guard<mutex> g(allocLatch);
+    char hdr[HEADER_BYTES];
+    fmt.encodeHeader(root, hdr, freeHead, freeCount);
+    ::pwrite(fd, hdr, HEADER_BYTES, 0);
+}
+
+ConcurrentStats ConcurrentTree::getStats() const {
+    ConcurrentStats st;
+    st.reads = reads.load();
+    st.writes = writes.load();
+    st.restarts = restarts.load();
+    st.retries = retries.load();
+    return st;
+}
+
+tuple<int, int, bool> ConcurrentTree::search(int key, int* recPos) {
+    Node node;
+    while (true) {
+        uint64_t rv = awaitUnlocked(rootVersion);
+        int pos = root.load(memory_order_relaxed);
+        if (pos == 0) {
+            if (validate(rootVersion, rv)) return make_tuple(0, 0, false);
+            retries.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+        VersionedNode* e = &entry(pos);
+        uint64_t v = awaitUnlocked(e->version);
+        bool valid = validate(rootVersion, rv);
+        while (valid) {
+            snapshot(*e, node);
+            if (!validate(e->version, v)) break;
+            int i = nodeSlot(node, key);
+            if (i < node.n && node.keys[i] == key) {
+                if (recPos) *recPos = node.recs[i];
+                return make_tuple(pos, i + 1, true);
+            }
+            int child = node.children[i];
+            if (child == 0) return make_tuple(pos, i, false);
+            VersionedNode* c = &entry(child);
+            uint64_t cv = awaitUnlocked(c->version);
+            if (!validate(e->version, v)) break;
+            e = c;
+            v = cv;
+            pos = child;
+        }
+        retries.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+bool ConcurrentTree::insert(int key, int recPos) {
+    Attempt a = insertOptimistic(key, recPos);
+    if (a != Attempt::Retry) return a == Attempt::Done;
+    restarts.fetch_add(1, memory_order_relaxed);
+    return insertPessimistic(key, recPos);
+}
+
+bool ConcurrentTree::remove(int key, int* recPos) {
+    Attempt a = removeOptimistic(key, recPos);
+    if (a != Attempt::Retry) return a == Attempt::Done;
+    restarts.fetch_add(1, memory_order_relaxed);
+    return removePessimistic(key, recPos);
+}
+
+/**
+ * @brief Descida otimista até a folha (validando cada nó antes de seguir para o filho).
+ * @param leaf Saída: cópia validada da folha, ou do nó interno onde a chave foi encontrada.
+ * @param pos Saída: posição desse nó.
+ * @param version Saída: versão validada.
+ * @param atRoot Saída: true se o nó era a raiz.
+ * @return false se a árvore estiver vazia.
+ */
+bool ConcurrentTree::descend(int key, Node& leaf, int& pos, uint64_t& version, bool& atRoot) {
+    while (true) {
+        uint64_t rv = awaitUnlocked(rootVersion);
+        pos = root.load(memory_order_relaxed);
+        if (pos == 0) {
+            if (validate(rootVersion, rv)) return false;
+            retries.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+        VersionedNode* e = &entry(pos);
+        version = awaitUnlocked(e->version);
+        atRoot = true;
+        bool valid = validate(rootVersion, rv);
+        while (valid) {
+            snapshot(*e, leaf);
+            if (!validate(e->version, version)) break;
+            int i = nodeSlot(leaf, key);
+            if ((i < leaf.n && leaf.keys[i] == key) || leaf.children[0] == 0) return true;
+            int child = leaf.children[i];
+            VersionedNode* c = &entry(child);
+            uint64_t cv = awaitUnlocked(c->version);
+            if (!validate(e->version, version)) break;
+            e = c;
+            version = cv;
+            pos = child;
+            atRoot = false;
+        }
+        retries.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Descida otimista; na folha, promove a versão lida a lock e insere se não houver divisão.
+ * @details Divisões, fusões e empréstimos travam a folha, então versão inalterada garante que a cópia e a
+ *          faixa de chaves da folha continuam as mesmas.
+ */
+ConcurrentTree::Attempt ConcurrentTree::insertOptimistic(int key, int recPos) {
+    Node node;
+    int pos;
+    uint64_t v;
+    bool atRoot;
+    while (true) {
+        if (!descend(key, node, pos, v, atRoot)) return Attempt::Retry;
+        int i = nodeSlot(node, key);
+        if (i < node.n && node.keys[i] == key) return Attempt::Absent;
+        if (node.n >= m - 1) return Attempt::Retry;
+        if (!tryUpgrade(table.of(pos).version, v)) {
+            retries.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+        for (int j = node.n; j > i; --j) {
+            node.keys[j] = node.keys[j - 1];
+            node.recs[j] = node.recs[j - 1];
+        }
+        node.keys[i] = key;
+        node.recs[i] = recPos;
+        node.n++;
+        node.children[node.n] = 0;
+        store(node, pos);
+        unlockNode(pos);
+        return Attempt::Done;
+    }
+}
+
+/**
+ * @brief Descida otimista; chave em nó interno ou folha no mínimo exigem o caminho pessimista.
+ */
+ConcurrentTree::Attempt ConcurrentTree::removeOptimistic(int key, int* recPos) {
+    Node node;
+    int pos;
+    uint64_t v;
+    bool atRoot;
+    while (true) {
+        if (!descend(key, node, pos, v, atRoot)) return Attempt::Absent;
+        int i = nodeSlot(node, key);
+        bool found = i < node.n && node.keys[i] == key;
+        if (node.children[0] != 0) return Attempt::Retry;
+        if (!found) return Attempt::Absent;
+        if (node.n <= (atRoot ? 1 : minK)) return Attempt::Retry;
+        if (!tryUpgrade(table.of(pos).version, v)) {
+            retries.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+        if (recPos) *recPos = node.recs[i];
+        for (int j = i; j < node.n - 1; ++j) {
+            node.keys[j] = node.keys[j + 1];
+            node.recs[j] = node.recs[j + 1];
+        }
+        node.n--;
+        store(node, pos);
+        unlockNode(pos);
+        return Attempt::Done;
+    }
+}
+
+void ConcurrentTree::releaseFrames(vector<Frame>& path, size_t upTo, bool& rootHeld) {
+    for (size_t k = 0; k < upTo && k < path.size(); ++k) {
+        if (path[k].held) {
+            unlockNode(path[k].pos);
+            path[k].held = false;
+        }
+    }
+    if (rootHeld) {
+        unlockExclusive(rootVersion);
+        rootHeld = false;
+    }
+}
+
+/**
+ * @brief Locks exclusivos desde a raiz; cada nó com espaço (n < m-1) libera os ancestrais. Divisões sobem
+ *        apenas por nós ainda travados.
+ */
+bool ConcurrentTree::insertPessimistic(int key, int recPos) {
+    lockExclusive(rootVersion);
+    bool rootHeld = true;
+    if (root == 0) {
+        Node r{};
+        r.n = 1;
+        r.keys[0] = key;
+        r.recs[0] = recPos;
+        root = allocate(r);
+        storeHeader();
+        unlockExclusive(rootVersion);
+        return true;
+    }
+
+    vector<Frame> path;
+    int pos = root;
+    lockNode(pos);
+    path.push_back({pos, load(pos), true});
+    int i;
+    while (true) {
+        Frame& f = path.back();
+        if (f.node.n < m - 1) releaseFrames(path, path.size() - 1, rootHeld);
+        i = nodeSlot(f.node, key);
+        if (i < f.node.n && f.node.keys[i] == key) {
+            releaseFrames(path, path.size(), rootHeld);
+            return false;
+        }
+        if (f.node.children[i] == 0) break;
+        int child = f.node.children[i];
+        lockNode(child);
+        path.push_back({child, load(child), true});
+    }
+
+    size_t level = path.size() - 1;
+    Node node = path[level].node;
+    for (int j = node.n; j > i; --j) {
+        node.keys[j] = node.keys[j - 1];
+        node.recs[j] = node.recs[j - 1];
+    }
+    node.keys[i] = key;
+    node.recs[i] = recPos;
+    node.n++;
+    node.children[node.n] = 0;
+
+    while (true) {
+        Frame& f = path[level];
+        f.node = node;
+        if (node.n < m) {
+            store(node, f.pos);
+            break;
+        }
+        int mid = m / 2;
+        Node left = node;
+        Node right{};
+        int rightCount = node.n - mid - 1;
+        left.n = mid;
+        for (int k = 0; k < rightCount; ++k) {
+            right.keys[k] = node.keys[mid + 1 + k];
+            right.recs[k] = node.recs[mid + 1 + k];
+        }
+        for (int k = 0; k <= rightCount; ++k) right.children[k] = node.children[mid + 1 + k];
+        right.n = rightCount;
+        int upKey = node.keys[mid];
+        int upRec = node.recs[mid];
+        store(left, f.pos);
+        int rightPos = allocate(right);
+
+        if (level == 0) {
+            Node newRoot{};
+            newRoot.n = 1;
+            newRoot.keys[0] = upKey;
+            newRoot.recs[0] = upRec;
+            newRoot.children[0] = f.pos;
+            newRoot.children[1] = rightPos;
+            root = allocate(newRoot);
+            storeHeader();
+            break;
+        }
+
+        Node& parent = path[level - 1].node;
+        int pi = 0;
+        while (pi <= parent.n && parent.children[pi] != f.pos) pi++;
+        for (int j = parent.n; j > pi; --j) {
+            parent.keys[j] = parent.keys[j - 1];
+            parent.recs[j] = parent.recs[j - 1];
+        }
+        for (int j = parent.n + 1; j > pi + 1; --j) parent.children[j] = parent.children[j - 1];
+        parent.keys[pi] = upKey;
+        parent.recs[pi] = upRec;
+        parent.children[pi + 1] = rightPos;
+        parent.n++;
+        node = parent;
+        level--;
+    }
+    releaseFrames(path, path.size(), rootHeld);
+    return true;
+}
+
+/**
+ * @brief Corrige o underflow do filho childIndex do pai travado (empréstimo de irmão ou fusão), como
+ *        MWayTree::fixUnderflow, travando os irmãos em modo exclusivo.
+ */
+void ConcurrentTree::fixChild(Frame& parentFrame, int childIndex, Node& child, int childPos) {
+    Node& parent = parentFrame.node;
+    int leftPos = childIndex > 0 ? parent.children[childIndex - 1] : 0;
+    int rightPos = childIndex < parent.n ? parent.children[childIndex + 1] : 0;
+    Node left{};
+    Node right{};
+
+    if (leftPos) {
+        lockNode(leftPos);
+        left = load(leftPos);
+        if (left.n > minK) {
+            int li = childIndex - 1;
+            for (int j = child.n; j > 0; --j) {
+                child.keys[j] = child.keys[j - 1];
+                child.recs[j] = child.recs[j - 1];
+                child.children[j + 1] = child.children[j];
+            }
+            child.children[1] = child.children[0];
+            child.keys[0] = parent.keys[li];
+            child.recs[0] = parent.recs[li];
+            child.children[0] = left.children[left.n];
+            child.n++;
+            parent.keys[li] = left.keys[left.n - 1];
+            parent.recs[li] = left.recs[left.n - 1];
+            left.n--;
+            store(left, leftPos);
+            store(child, childPos);
+            store(parent, parentFrame.pos);
+            unlockNode(leftPos);
+            return;
+        }
+    }
+    if (rightPos) {
+        lockNode(rightPos);
+        right = load(rightPos);
+        if (right.n > minK) {
+            child.keys[child.n] = parent.keys[childIndex];
+            child.recs[child.n] = parent.recs[childIndex];
+            child.children[child.n + 1] = right.children[0];
+            child.n++;
+            parent.keys[childIndex] = right.keys[0];
+            parent.recs[childIndex] = right.recs[0];
+            for (int j = 0; j < right.n - 1; ++j) {
+                right.keys[j] = right.keys[j + 1];
+                right.recs[j] = right.recs[j + 1];
+                right.children[j] = right.children[j + 1];
+            }
+            right.children[right.n - 1] = right.children[right.n];
+            right.n--;
+            store(right, rightPos);
+            store(child, childPos);
+            store(parent, parentFrame.pos);
+            unlockNode(rightPos);
+            if (leftPos) unlockNode(leftPos);
+            return;
+        }
+    }
+
+    if (leftPos) {
+        int li = childIndex - 1;
+        left.keys[left.n] = parent.keys[li];
+        left.recs[left.n] = parent.recs[li];
+        left.children[left.n + 1] = child.children[0];
+        for (int j = 0; j < child.n; ++j) {
+            left.keys[left.n + 1 + j] = child.keys[j];
+            left.recs[left.n + 1 + j] = child.recs[j];
+            left.children[left.n + 2 + j] = child.children[j + 1];
+        }
+        left.n += 1 + child.n;
+        for (int j = li; j < parent.n - 1; ++j) {
+            parent.keys[j] = parent.keys[j + 1];
+            parent.recs[j] = parent.recs[j + 1];
+            parent.children[j + 1] = parent.children[j + 2];
+        }
+        parent.n--;
+        store(left, leftPos);
+        store(parent, parentFrame.pos);
+        release(childPos);
+    } else {
+        child.keys[child.n] = parent.keys[childIndex];
+        child.recs[child.n] = parent.recs[childIndex];
+        child.children[child.n + 1] = right.children[0];
+        for (int j = 0; j < right.n; ++j) {
+            child.keys[child.n + 1 + j] = right.keys[j];
+            child.recs[child.n + 1 + j] = right.recs[j];
+            child.children[child.n + 2 + j] = right.children[j + 1];
+        }
+        child.n += 1 + right.n;
+        for (int j = childIndex; j < parent.n - 1; ++j) {
+            parent.keys[j] = parent.keys[j + 1];
+            parent.recs[j] = parent.recs[j + 1];
+            parent.children[j + 1] = parent.children[j + 2];
+        }
+        parent.n--;
+        store(child, childPos);
+        store(parent, parentFrame.pos);
+        release(rightPos);
+    }
+    if (rightPos) unlockNode(rightPos);
+    if (leftPos) unlockNode(leftPos);
+}
+
+/**
+ * @brief Locks exclusivos desde a raiz; um nó acima do mínimo libera os ancestrais, exceto o nó interno
+ *        que contém a chave (recebe o antecessor, lido na folha mais à direita da subárvore esquerda).
+ */
+bool ConcurrentTree::removePessimistic(int key, int* recPos) {
+    lockExclusive(rootVersion);
+    bool rootHeld = true;
+    if (root == 0) {
+        unlockExclusive(rootVersion);
+        return false;
+    }
+    vector<Frame> path;
+    int pos = root;
+    lockNode(pos);
+    path.push_back({pos, load(pos), true});
+    int target = -1;
+    int targetSlot = 0;
+    int leafSlot = 0;
+    while (true) {
+        size_t idx = path.size() - 1;
+        Frame& f = path[idx];
+        bool safe = f.node.n > (idx == 0 ? 1 : minK);
+        if (safe) {
+            for (size_t k = 0; k < idx; ++k) {
+                if (static_cast<int>(k) != target && path[k].held) {
+                    unlockNode(path[k].pos);
+                    path[k].held = false;
+                }
+            }
+            if (rootHeld) {
+                unlockExclusive(rootVersion);
+                rootHeld = false;
+            }
+        }
+        int child;
+        if (target < 0) {
+            int i = nodeSlot(f.node, key);
+            bool found = i < f.node.n && f.node.keys[i] == key;
+            if (f.node.children[0] == 0) {
+                if (!found) {
+                    releaseFrames(path, path.size(), rootHeld);
+                    return false;
+                }
+                leafSlot = i;
+                break;
+            }
+            if (found) {
+                target = static_cast<int>(idx);
+                targetSlot = i;
+            }
+            child = f.node.children[i];
+        } else {
+            if (f.node.children[0] == 0) {
+                leafSlot = f.node.n - 1;
+                break;
+            }
+            child = f.node.children[f.node.n];
+        }
+        lockNode(child);
+        path.push_back({child, load(child), true});
+    }
+
+    Frame& leaf = path.back();
+    if (target >= 0) {
+        Frame& t = path[target];
+        if (recPos) *recPos = t.node.recs[targetSlot];
+        t.node.keys[targetSlot] = leaf.node.keys[leafSlot];
+        t.node.recs[targetSlot] = leaf.node.recs[leafSlot];
+        store(t.node, t.pos);
+    } else if (recPos) {
+        *recPos = leaf.node.recs[leafSlot];
+    }
+    for (int j = leafSlot; j < leaf.node.n - 1; ++j) {
+        leaf.node.keys[j] = leaf.node.keys[j + 1];
+        leaf.node.recs[j] = leaf.node.recs[j + 1];
+    }
+    leaf.node.n--;
+    store(leaf.node, leaf.pos);
+
+    for (size_t k = path.size() - 1; k > 0; --k) {
+        Frame& f = path[k];
+        if (f.node.n >= minK) break;
+        Frame& p = path[k - 1];
+        int ci = 0;
+        while (ci <= p.node.n && p.node.children[ci] != f.pos) ci++;
+        fixChild(p, ci, f.node, f.pos);
+    }
+
+    if (rootHeld && path[0].node.n == 0) {
+        int oldRoot = root;
+        root = path[0].node.children[0];
+        release(oldRoot);
+        storeHeader();
+    }
+    releaseFrames(path, path.size(), rootHeld);
+    return true;
+}
@@ -0,0 +1,185 @@
+/**
+* @file ConcurrentTree.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef CONCURRENTTREE_H
+#define CONCURRENTTREE_H
+
+#include "MWayTree.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/**
+ * @brief Nó em memória com carimbo de versão (lock otimista).
+ * @details version par = livre, ímpar = travado por um escritor; travar e destravar incrementam a versão,
+ *          de modo que qualquer escrita no nó muda o valor visto pelos leitores. Os campos de node são lidos
+ *          e gravados palavra a palavra com atomic_ref (relaxed), como num seqlock.
+ */
+struct VersionedNode {
+    std::atomic<std::uint64_t> version{0};
+    std::atomic<bool> loaded{false};
+    Node node;
+};
+
+/**
+ * @brief Tabela de nós versionados por posição, alocada sob demanda em blocos.
+ * @details Os blocos são publicados com CAS e só liberados com a tabela: um leitor com uma posição obsoleta
+ *          (nó liberado ou reutilizado) lê memória válida e descobre a mudança pela versão.
+ */
+class NodeTable {
+public:
+    NodeTable() = default;
+    ~NodeTable();
+
+    NodeTable(const NodeTable&) = delete;
+    NodeTable& operator=(const NodeTable&) = delete;
+
+    /**
+     * @brief Entrada da posição (>= 1).
+     */
+    VersionedNode& of(int position);
+
+private:
+    static constexpr int BLOCK = 1024;
+    static constexpr int MAX_BLOCKS = 1 << 16;
+    std::array<std::atomic<VersionedNode*>, MAX_BLOCKS> blocks{};
+};
+
+/**
+ * @brief Contadores agregados das operações concorrentes.
+ */
+struct ConcurrentStats {
+    long long reads = 0;     // pread de nós (primeira carga na tabela)
+    long long writes = 0;    // pwrite de nós
+    long long restarts = 0;  // escritas otimistas refeitas pelo caminho pessimista
+    long long retries = 0;   // descidas otimistas reiniciadas por versão alterada
+};
+
+/**
+ * @brief Buscas, inserções e remoções concorrentes sobre um MWayTree aberto (acoplamento otimista).
+ * @details Enquanto existir, é o único acesso à árvore: o MWayTree não deve ser usado diretamente. Os nós são
+ *          carregados uma vez (pread) numa tabela em memória com versão por nó e gravados com pwrite em
+ *          descritor próprio a cada alteração, sem o backend de I/O nem o cache de nós da árvore.
+ *
+ *          - Busca: não trava nada. Lê a versão do nó (esperando se estiver travado), copia o nó e valida a
+ *            versão; só então segue para o filho, revalidando o pai depois de ler a versão do filho. Versão
+ *            alterada reinicia a descida a partir da raiz.
+ *          - Escrita otimista: mesma descida; na folha, promove a versão lida a lock exclusivo (CAS) e aplica
+ *            a alteração se a folha for segura (não divide nem entra em underflow).
+ *          - Escrita pessimista: locks exclusivos desde a raiz, soltando os ancestrais a cada nó seguro;
+ *            divisões, fusões e a troca pelo antecessor ocorrem apenas em nós ainda travados, e cada nó
+ *            alterado só é destravado (versão incrementada) ao fim da operação. Irmãos usados na
+ *            redistribuição/fusão são travados com o pai já travado.
+ *
+ *          O ponteiro da raiz tem versão própria; alocação e lista de livres são protegidas por um mutex. O
+ *          header é regravado quando a raiz muda e ao destruir o objeto, que também devolve o estado ao
+ *          MWayTree. Requer o WAL desligado: as escritas vão direto ao índice, como no WriteThrough.
+ */
+class ConcurrentTree {
+public:
+    /**
+     * @brief Assume o acesso à árvore (após tree.sync()).
+     * @param tree Índice aberto, com WAL desligado.
+     */
+    explicit ConcurrentTree(MWayTree<>& tree);
+
+    /**
+     * @brief Grava o header e devolve raiz, nós e lista de livres ao MWayTree (cache esvaziado).
+     */
+    ~ConcurrentTree();
+
+    ConcurrentTree(const ConcurrentTree&) = delete;
+    ConcurrentTree& operator=(const ConcurrentTree&) = delete;
+
+    /**
+     * @brief true se a árvore foi assumida (aberta e sem WAL).
+     */
+    bool isOpen() const { return fd >= 0; }
+
+    /**
+     * @brief Busca sem locks (mesma semântica de retorno de mSearch). Thread-safe.
+     */
+    std::tuple<int, int, bool> search(int key, int* recPos = nullptr);
+
+    /**
+     * @brief Insere a chave. Thread-safe.
+     * @return false se a chave já existia.
+     */
+    bool insert(int key, int recPos);
+
+    /**
+     * @brief Remove a chave. Thread-safe.
+     * @param recPos (Opcional) saída: registro da chave removida.
+     * @return true se a chave existia.
+     */
+    bool remove(int key, int* recPos = nullptr);
+
+    ConcurrentStats getStats() const;
+
+private:
+    /**
+     * @brief Nó travado no caminho de uma escrita pessimista.
+     */
+    struct Frame {
+        int pos;
+        Node node;
+        bool held;
+    };
+
+    MWayTree<>& tree;
+    int fd = -1;
+    int m;
+    int minK;
+    NodeFormat fmt;
+    NodeTable table;
+
+    std::atomic<std::uint64_t> rootVersion{0};
+    std::atomic<int> root;
+
+    std::mutex allocLatch;
+    int nodeCount;
+    int freeHead;
+    int freeCount;
+
+    std::atomic<long long> reads{0};
+    std::atomic<long long> writes{0};
+    std::atomic<long long> restarts{0};
+    std::atomic<long long> retries{0};
+
+    static std::uint64_t awaitUnlocked(const std::atomic<std::uint64_t>& version);
+    static bool validate(const std::atomic<std::uint64_t>& version, std::uint64_t seen);
+    static void lockExclusive(std::atomic<std::uint64_t>& version);
+    static bool tryUpgrade(std::atomic<std::uint64_t>& version, std::uint64_t seen);
+    static void unlockExclusive(std::atomic<std::uint64_t>& version);
+    static void snapshot(const VersionedNode& entry, Node& out);
+
+    VersionedNode& entry(int position);
+    void lockNode(int position);
+    void unlockNode(int position);
+    Node readDisk(int position);
+    Node load(int position);
+    void store(const Node& node, int position);
+    int allocate(const Node& node);
+    void release(int position);
+    void storeHeader();
+
+    enum class Attempt { Done, Absent, Retry };
+    bool descend(int key, Node& leaf, int& pos, std::uint64_t& version, bool& atRoot);
+    Attempt insertOptimistic(int key, int recPos);
+    Attempt removeOptimistic(int key, int* recPos);
+    bool insertPessimistic(int key, int recPos);
+    bool removePessimistic(int key, int* recPos);
+    void releaseFrames(std::vector<Frame>& path, std::size_t upTo, bool& rootHeld);
+    void fixChild(Frame& parent, int childIndex, Node& child, int childPos);
+};
+
+#endif
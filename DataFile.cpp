@@ -8,13 +8,26 @@
  */
 
 #include "DataFile.h"
+#include "TextChunks.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <iostream>
-#include <sstream>
 #include <cstdio>
-#include <cctype>
+#include <cstring>
+#include <string_view>
 
 using namespace std;
 
+namespace {
+
+/**
+ * @brief Registros lidos por leitura física nas varreduras sequenciais.
+ */
+const long long SCAN_RECORDS = 512;
+
+} // namespace
+
 /**
  * @brief Destrutor: fecha o arquivo se ainda aberto.
  */
@@ -24,145 +37,269 @@ DataFile::~DataFile() {
 
 /**
  * @brief Abre (ou cria) o arquivo binário de dados.
+ * @details Se existir data.bin.hash, reabre o índice hash; se ele estiver sujo ou desatualizado, reconstrói.
  * @param fname Caminho do arquivo.
  * @return true se aberto com sucesso.
  */
 bool DataFile::open(const std::string& fname) {
     filename = fname;
-    file.open(filename, ios::in | ios::out | ios::binary);
-    if (!file.is_open()) {
-        file.clear();
-        file.open(filename, ios::out | ios::binary | ios::trunc);
-        if (!file.is_open()) return false;
-        file.close();
-        file.open(filename, ios::in | ios::out | ios::binary);
-    }
-    return file.is_open();
+    if (!io->open(filename, true)) return false;
+    string hashPath = HashIndex::pathFor(filename);
+    if (ifstream(hashPath).good() && !hash.open(hashPath, recordCount())) rebuildHashIndex();
+    return true;
 }
 
 /**
- * @brief Fecha o arquivo binário se aberto.
+ * @brief Fecha o arquivo binário (e o índice hash, gravando-o limpo) se aberto.
  */
 void DataFile::close() {
-    if (file.is_open()) file.close();
+    if (!io->isOpen()) return;
+    if (hash.isOpen()) hash.close(recordCount());
+    io->close();
+}
+
+bool DataFile::setIoBackend(IoBackend kind) {
+    auto next = makeStorageBackend(kind);
+    if (io->isOpen() && !next->open(filename)) return false;
+    io = std::move(next);
+    return true;
 }
 
 /**
- * @brief Constrói data.bin a partir de um .txt de nós (gera 1 registro por chave).
- * @param textFilename Caminho do .txt (linhas: "n A0 K1 A1 ... Kn An").
- * @param dataFilename Caminho do data.bin de saída (sobrescrito).
- * @return true se criado com sucesso; false ao detectar formato inválido.
+ * @brief Total de registros no arquivo (ativos e removidos).
  */
-bool DataFile::createFromText(const std::string& textFilename, const std::string& dataFilename) {
-    ifstream txt(textFilename);
-    if (!txt.is_open()) return false;
+long long DataFile::recordCount() {
+    return io->size() / static_cast<long long>(sizeof(Record));
+}
 
-    ofstream out(dataFilename, ios::binary | ios::trunc);
-    if (!out.is_open()) {
-        txt.close();
-        return false;
+/**
+ * @brief Varre o data.bin em blocos de SCAN_RECORDS registros (uma leitura física por bloco).
+ * @param visit Recebe (registro, número); false interrompe.
+ * @return false se a leitura falhar.
+ */
+bool DataFile::scanRecords(const function<bool(const Record&, int recNo)>& visit) {
+    vector<Record> block(SCAN_RECORDS);
+    long long total = recordCount();
+    for (long long first = 0; first < total; first += SCAN_RECORDS) {
+        size_t count = static_cast<size_t>(min<long long>(SCAN_RECORDS, total - first));
+        if (!io->read(first * static_cast<long long>(sizeof(Record)), block.data(), count * sizeof(Record))) return false;
+        for (size_t i = 0; i < count; ++i) {
+            if (!visit(block[i], static_cast<int>(first + static_cast<long long>(i)))) return true;
+        }
     }
+    return true;
+}
 
-    string line;
-    int lineNo = 0;
-    while (getline(txt, line)) {
-        ++lineNo;
-        bool onlySpace = true;
-        for (char c : line) { if (!std::isspace(static_cast<unsigned char>(c))) { onlySpace = false; break; } }
-        if (onlySpace) continue;
-        istringstream iss(line);
-        int n, a0;
-        if (!(iss >> n >> a0)) {
-            cerr << "DataFile: erro ao ler n e A0 na linha " << lineNo << endl;
-            txt.close(); out.close();
-            return false;
+bool DataFile::setHashIndex(bool enabled) {
+    if (!io->isOpen()) return false;
+    if (enabled) return hash.isOpen() || rebuildHashIndex();
+    if (hash.isOpen()) hash.close(recordCount());
+    std::remove(HashIndex::pathFor(filename).c_str());
+    return true;
+}
+
+/**
+ * @brief Varre o data.bin coletando os registros ativos e regrava o índice hash em lote.
+ */
+bool DataFile::rebuildHashIndex() {
+    vector<pair<int,int>> active;
+    if (!listActiveEntries(active)) return false;
+    vector<HashEntry> entries;
+    entries.reserve(active.size());
+    for (const auto& [key, recNo] : active) entries.push_back({key, recNo});
+    return hash.build(HashIndex::pathFor(filename), entries, recordCount());
+}
+
+namespace {
+
+/**
+ * @brief Registros produzidos por um bloco de texto e o primeiro erro encontrado nele.
+ */
+struct RecordChunk {
+    vector<Record> records;
+    int lines = 0;
+    int errorLine = 0;          // linha do erro dentro do bloco (1-based); 0 = sem erro
+    const char* error = nullptr;
+};
+
+/**
+ * @brief Interpreta uma linha e acrescenta seus registros; devolve a mensagem de erro ou nullptr.
+ */
+using LineParser = const char* (*)(string_view line, vector<Record>& out);
+
+/**
+ * @brief Linha "n A0 K1 A1 ... Kn An": um registro de funcionario por chave.
+ */
+const char* parseNodeLine(string_view line, vector<Record>& out) {
+    int n = 0, a0 = 0;
+    if (!extractValue(line, n) || !extractValue(line, a0)) {
+        return "DataFile: erro ao ler n e A0";
+    }
+    for (int i = 0; i < n; ++i) {
+        int k = 0, ai = 0;
+        if (!extractValue(line, k) || !extractValue(line, ai)) {
+            return "DataFile: par Ki/Ai faltando";
         }
-        for (int i = 0; i < n; ++i) {
-            int k, ai;
-            if (!(iss >> k >> ai)) {
-                cerr << "DataFile: par Ki/Ai faltando na linha " << lineNo << endl;
-                txt.close(); out.close();
+        out.push_back(DataFile::nodeKeyRecord(k));
+    }
+    return nullptr;
+}
+
+string_view trimmed(string_view s) {
+    while (!s.empty() && isBlank(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isBlank(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+/**
+ * @brief Linha "id;Nome;Depto" (id como em stoi: espaços iniciais e sufixo não numérico são aceitos).
+ */
+const char* parseEmployeeLine(string_view line, vector<Record>& out) {
+    size_t p1 = line.find(';');
+    size_t p2 = (p1 == string_view::npos) ? string_view::npos : line.find(';', p1 + 1);
+    if (p1 == string_view::npos || p2 == string_view::npos) return "employees.txt: formato invalido";
+
+    string_view idText = line.substr(0, p1);
+    while (!idText.empty() && isBlank(idText.front())) idText.remove_prefix(1);
+    if (idText.size() > 1 && idText[0] == '+' && idText[1] != '-') idText.remove_prefix(1);
+    int id = 0;
+    if (from_chars(idText.data(), idText.data() + idText.size(), id).ec != errc()) return "employees.txt: id invalido";
+
+    string_view nome = trimmed(line.substr(p1 + 1, p2 - (p1 + 1)));
+    string_view depto = trimmed(line.substr(p2 + 1));
+    Record r{};
+    r.key = id;
+    r.active = 1;
+    std::snprintf(r.payload, sizeof(r.payload), "Funcionario %d | %.*s | %.*s", id, static_cast<int>(nome.size()),
+                  nome.data(), static_cast<int>(depto.size()), depto.data());
+    out.push_back(r);
+    return nullptr;
+}
+
+/**
+ * @brief Converte um arquivo texto em registros: blocos interpretados em paralelo e gravados em ordem.
+ * @details O primeiro erro (em ordem de arquivo) é reportado com o número global da linha e interrompe a
+ *          conversão; os blocos anteriores a ele já estão gravados, como na leitura linha a linha.
+ */
+bool convertText(const string& textFilename, ofstream& out, LineParser parseLine, const DataFile::RecordSink& sink) {
+    TextChunks text;
+    if (!text.open(textFilename)) return false;
+    vector<string_view> chunks;
+    vector<RecordChunk> parsed(static_cast<size_t>(text.threads()));
+    long long lineBase = 0;
+    long long recNo = 0;
+    while (size_t count = text.nextRound(chunks)) {
+        TextChunks::parallelFor(count, [&](size_t c) {
+            RecordChunk& rc = parsed[c];
+            rc.records.clear();
+            rc.lines = 0;
+            rc.errorLine = 0;
+            string_view rest = chunks[c], line;
+            while (nextLine(rest, line)) {
+                ++rc.lines;
+                if (blankLine(line)) continue;
+                if ((rc.error = parseLine(line, rc.records)) != nullptr) {
+                    rc.errorLine = rc.lines;
+                    return;
+                }
+            }
+        });
+        for (size_t c = 0; c < count; ++c) {
+            const RecordChunk& rc = parsed[c];
+            out.write(reinterpret_cast<const char*>(rc.records.data()),
+                      static_cast<streamsize>(rc.records.size() * sizeof(Record)));
+            if (sink && !sink(rc.records.data(), rc.records.size(), recNo)) return false;
+            recNo += static_cast<long long>(rc.records.size());
+            if (rc.errorLine) {
+                cerr << rc.error << " na linha " << lineBase + rc.errorLine << endl;
                 return false;
             }
-            Record r{};
-            r.key = k;
-            r.active = 1;
-            char dept = "ABCDE"[k % 5];
-            std::snprintf(r.payload, sizeof(r.payload), "Funcionario %d | depto=%c", k, dept);
-            out.write(reinterpret_cast<const char*>(&r), sizeof(Record));
+            lineBase += rc.lines;
         }
+        if (!out) return false;
     }
+    return true;
+}
+
+} // namespace
 
-    txt.close();
+Record DataFile::nodeKeyRecord(int key) {
+    Record r{};
+    r.key = key;
+    r.active = 1;
+    char dept = "ABCDE"[((key % 5) + 5) % 5];
+    std::snprintf(r.payload, sizeof(r.payload), "Funcionario %d | depto=%c", key, dept);
+    return r;
+}
+
+/**
+ * @brief Constrói data.bin a partir de um .txt de nós (gera 1 registro por chave).
+ * @details Arquivo mapeado e interpretado em blocos paralelos (TextChunks); memória limitada a uma rodada.
+ * @param textFilename Caminho do .txt (linhas: "n A0 K1 A1 ... Kn An").
+ * @param dataFilename Caminho do data.bin de saída (sobrescrito).
+ * @return true se criado com sucesso; false ao detectar formato inválido.
+ */
+bool DataFile::createFromText(const std::string& textFilename, const std::string& dataFilename) {
+    if (!ifstream(textFilename).is_open()) return false;
+    ofstream out(dataFilename, ios::binary | ios::trunc);
+    if (!out.is_open()) return false;
+    std::remove(HashIndex::pathFor(dataFilename).c_str());
+    bool ok = convertText(textFilename, out, parseNodeLine, {});
     out.close();
-    return true;
+    return ok && !out.fail();
 }
 
 /**
  * @brief Constrói data.bin a partir de employees.txt no formato "id;Nome;Depto".
+ * @details Arquivo mapeado e interpretado em blocos paralelos (TextChunks); memória limitada a uma rodada.
  * @param employeesTxt Caminho do arquivo texto de entrada.
  * @param dataFilename Caminho do data.bin de saída (sobrescrito).
+ * @param sink (Opcional) recebe cada bloco de registros logo após gravá-lo.
  * @return true se criado; false se houver linhas inválidas ou falha de I/O.
  */
-bool DataFile::createFromEmployees(const std::string& employeesTxt, const std::string& dataFilename) {
-    ifstream in(employeesTxt);
-    if (!in.is_open()) return false;
+bool DataFile::createFromEmployees(const std::string& employeesTxt, const std::string& dataFilename, const RecordSink& sink) {
+    if (!ifstream(employeesTxt).is_open()) return false;
+    ofstream out(dataFilename, ios::binary | ios::trunc);
+    if (!out.is_open()) return false;
+    std::remove(HashIndex::pathFor(dataFilename).c_str());
+    bool ok = convertText(employeesTxt, out, parseEmployeeLine, sink);
+    out.close();
+    return ok && !out.fail();
+}
 
+/**
+ * @brief Constrói data.bin a partir de linhas "id;Nome;Depto" lidas de um stream (arquivo ou stdin).
+ * @param in Stream de entrada.
+ * @param dataFilename Caminho do data.bin de saída (sobrescrito).
+ * @param sink (Opcional) recebe cada registro logo após gravá-lo.
+ * @return true se criado; false se houver linhas inválidas ou falha de I/O.
+ */
+bool DataFile::createFromEmployees(std::istream& in, const std::string& dataFilename, const RecordSink& sink) {
     ofstream out(dataFilename, ios::binary | ios::trunc);
-    if (!out.is_open()) {
-        in.close();
-        return false;
-    }
+    if (!out.is_open()) return false;
+    std::remove(HashIndex::pathFor(dataFilename).c_str());
 
     string line;
+    vector<Record> records;
     int lineNo = 0;
+    long long recNo = 0;
     while (getline(in, line)) {
         ++lineNo;
-        bool onlySpace = true;
-        for (char c : line) { if (!std::isspace(static_cast<unsigned char>(c))) { onlySpace = false; break; } }
-        if (onlySpace) continue;
-
-        int id = 0;
-        string nome, depto;
-
-        size_t p1 = line.find(';');
-        size_t p2 = (p1 == string::npos) ? string::npos : line.find(';', p1 + 1);
-        if (p1 == string::npos || p2 == string::npos) {
-            cerr << "employees.txt: formato invalido na linha " << lineNo << endl;
-            in.close(); out.close();
+        if (blankLine(line)) continue;
+        if (const char* error = parseEmployeeLine(line, records)) {
+            cerr << error << " na linha " << lineNo << endl;
+            out.close();
             return false;
         }
-        try {
-            id = stoi(line.substr(0, p1));
-        } catch (...) {
-            cerr << "employees.txt: id invalido na linha " << lineNo << endl;
-            in.close(); out.close();
+        out.write(reinterpret_cast<const char*>(records.data()), sizeof(Record));
+        if (sink && !sink(records.data(), 1, recNo)) {
+            out.close();
             return false;
         }
-        nome = line.substr(p1 + 1, p2 - (p1 + 1));
-        depto = line.substr(p2 + 1);
-
-        auto trim = [](string& s){
-            size_t a = s.find_first_not_of(" \t\r\n");
-            size_t b = s.find_last_not_of(" \t\r\n");
-            if (a == string::npos) { s.clear(); return; }
-            s = s.substr(a, b - a + 1);
-        };
-        trim(nome); trim(depto);
-
-        Record r{};
-        r.key = id;
-        r.active = 1;
-        string payload = "Funcionario " + to_string(id) + " | " + nome + " | " + depto;
-        if (payload.size() >= sizeof(r.payload)) {
-            payload.resize(sizeof(r.payload) - 1);
-        }
-        std::snprintf(r.payload, sizeof(r.payload), "%s", payload.c_str());
-
-        out.write(reinterpret_cast<const char*>(&r), sizeof(Record));
+        recNo++;
+        records.clear();
     }
 
-    in.close();
     out.close();
     return true;
 }
@@ -174,19 +311,118 @@ bool DataFile::createFromEmployees(const std::string& employeesTxt, const std::s
  * @return true se encontrado (O(n)); counters são atualizados.
  */
 bool DataFile::find(int key, Record& out) {
-    if (!file.is_open()) return false;
+    int recNo = 0;
+    return find(key, out, recNo);
+}
+
+/**
+ * @brief Busca por chave devolvendo também o número do registro.
+ * @details Com índice hash: uma leitura de bucket e uma leitura posicionada do registro. Sem índice, ou se o
+ *          registro apontado não conferir, cai na busca sequencial.
+ * @param key Chave a procurar.
+ * @param out Registro de saída, se encontrado.
+ * @param outRecNo Número do registro, se encontrado.
+ * @return true se encontrado; counters são atualizados.
+ */
+bool DataFile::find(int key, Record& out, int& outRecNo) {
+    if (!io->isOpen()) return false;
+    auto start = chrono::steady_clock::now();
     resetCounters();
-    file.clear();
-    file.seekg(0, ios::beg);
-    Record r{};
-    while (file.read(reinterpret_cast<char*>(&r), sizeof(Record))) {
+    bool found = findRecord(key, out, outRecNo);
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    findMetrics.record(getDataCounters(), static_cast<uint64_t>(ns));
+    return found;
+}
+
+/**
+ * @brief Corpo de find (sem reset de contadores nem métricas): índice hash e, na falta, busca sequencial.
+ */
+bool DataFile::findRecord(int key, Record& out, int& outRecNo) {
+    if (hash.isOpen()) {
+        int recNo = 0;
+        if (!hash.find(key, recNo)) return false;
+        Record r{};
+        if (io->read(static_cast<long long>(recNo) * static_cast<long long>(sizeof(Record)), &r, sizeof(Record))) {
+            reads++;
+            if (r.key == key && r.active == 1) {
+                out = r;
+                outRecNo = recNo;
+                return true;
+            }
+        }
+    }
+    return scanFind(key, out, outRecNo);
+}
+
+/**
+ * @brief Busca sequencial (O(n)) pelo primeiro registro ativo com a chave.
+ */
+bool DataFile::scanFind(int key, Record& out, int& outRecNo) {
+    bool found = false;
+    scanRecords([&](const Record& r, int recNo) {
         reads++;
-        if (r.key == key && r.active == 1) {
-            out = r;
-            return true;
+        if (r.key != key || r.active != 1) return true;
+        out = r;
+        outRecNo = recNo;
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+/**
+ * @brief Leitura posicionada: seek direto para recNo*sizeof(Record).
+ * @param recNo Número do registro.
+ * @param out Registro lido.
+ * @return true se existe e está ativo; counters são atualizados.
+ */
+bool DataFile::readAt(int recNo, Record& out) {
+    if (!io->isOpen() || recNo < 0) return false;
+    resetCounters();
+    Record r{};
+    if (!io->read(static_cast<long long>(recNo) * static_cast<long long>(sizeof(Record)), &r, sizeof(Record))) {
+        return false;
+    }
+    reads++;
+    if (r.active != 1) return false;
+    out = r;
+    return true;
+}
+
+/**
+ * @brief Leituras posicionadas submetidas em grupos de até IO_QUEUE_DEPTH; cada conclusão preenche o seu
+ *        registro (com io_uring, em qualquer ordem).
+ */
+size_t DataFile::readMany(span<const int> recNos, vector<Record>& out, vector<char>& ok) {
+    out.assign(recNos.size(), Record{});
+    ok.assign(recNos.size(), 0);
+    resetCounters();
+    if (!io->isOpen()) return 0;
+    long long total = recordCount();
+    vector<IoCompletion> done;
+    size_t next = 0;
+    size_t active = 0;
+    while (next < recNos.size() || io->inFlight() > 0) {
+        for (; next < recNos.size(); ++next) {
+            int recNo = recNos[next];
+            if (recNo < 0 || recNo >= total) continue;
+            IoRequest req{static_cast<long long>(recNo) * static_cast<long long>(sizeof(Record)), &out[next],
+                          static_cast<uint32_t>(sizeof(Record)), next};
+            if (!io->queueRead(req)) break;
+        }
+        if (io->inFlight() == 0) break;
+        done.clear();
+        io->wait(done, 1);
+        for (const IoCompletion& c : done) {
+            if (c.result != static_cast<long long>(sizeof(Record))) continue;
+            reads++;
+            if (out[c.tag].active == 1) {
+                ok[c.tag] = 1;
+                active++;
+            }
         }
     }
-    return false;
+    return active;
 }
 
 /**
@@ -195,16 +431,28 @@ bool DataFile::find(int key, Record& out) {
  * @return true se escrita OK; counters são atualizados.
  */
 bool DataFile::insert(const Record& rec) {
-    if (!file.is_open()) return false;
+    int recNo = 0;
+    return insert(rec, recNo);
+}
+
+/**
+ * @brief Insere ao final e devolve o número do registro (posição / sizeof(Record)).
+ * @param rec Registro de entrada; active será definido como 1.
+ * @param outRecNo Número do registro gravado.
+ * @return true se escrita OK; counters são atualizados.
+ */
+bool DataFile::insert(const Record& rec, int& outRecNo) {
+    if (!io->isOpen()) return false;
     resetCounters();
     Record w = rec;
     w.active = 1;
-    file.clear();
-    file.seekp(0, ios::end);
-    file.write(reinterpret_cast<const char*>(&w), sizeof(Record));
-    file.flush();
+    outRecNo = static_cast<int>(recordCount());
+    bool ok = io->write(static_cast<long long>(outRecNo) * static_cast<long long>(sizeof(Record)), &w, sizeof(Record));
     writes++;
-    return file.good();
+    generation++;
+    if (!ok) return false;
+    if (hash.isOpen()) hash.insert(w.key, outRecNo);
+    return true;
 }
 
 /**
@@ -215,6 +463,19 @@ bool DataFile::insert(const Record& rec) {
  * @return true se escrita OK; contadores de I/O atualizados via insert().
  */
 bool DataFile::insertEmployee(int key, const std::string& nome, const std::string& depto) {
+    int recNo = 0;
+    return insertEmployee(key, nome, depto, recNo);
+}
+
+/**
+ * @brief Insere funcionario devolvendo o número do registro gravado.
+ * @param key Chave do funcionario.
+ * @param nome Nome do funcionario.
+ * @param depto Departamento do funcionario.
+ * @param outRecNo Número do registro gravado.
+ * @return true se escrita OK.
+ */
+bool DataFile::insertEmployee(int key, const std::string& nome, const std::string& depto, int& outRecNo) {
     Record r{};
     r.key = key;
     r.active = 1;
@@ -223,50 +484,78 @@ bool DataFile::insertEmployee(int key, const std::string& nome, const std::strin
         payload.resize(sizeof(r.payload) - 1);
     }
     std::snprintf(r.payload, sizeof(r.payload), "%s", payload.c_str());
-    return insert(r);
+    return insert(r, outRecNo);
 }
 
 /**
  * @brief Marca como removido (active=0) o primeiro registro ativo com a chave.
+ * @details Com índice hash, localiza o registro por find() e remove por posição.
  * @param key Chave a remover.
  * @return true se encontrou e marcou; counters são atualizados.
  */
 bool DataFile::remove(int key) {
-    if (!file.is_open()) return false;
+    if (!io->isOpen()) return false;
+    if (hash.isOpen()) {
+        Record r{};
+        int recNo = 0;
+        return find(key, r, recNo) && markRemoved(recNo, key);
+    }
     resetCounters();
-    file.clear();
-    file.seekg(0, ios::beg);
-    Record r{};
-    std::streampos pos{};
-    while (true) {
-        pos = file.tellg();
-        if (!file.read(reinterpret_cast<char*>(&r), sizeof(Record))) break;
+    bool removed = false;
+    scanRecords([&](const Record& r, int recNo) {
         reads++;
-        if (r.key == key && r.active == 1) {
-            r.active = 0;
-            file.clear();
-            file.seekp(pos, ios::beg);
-            file.write(reinterpret_cast<const char*>(&r), sizeof(Record));
-            file.flush();
-            writes++;
-            return true;
-        }
-    }
-    return false;
+        if (r.key != key || r.active != 1) return true;
+        Record w = r;
+        w.active = 0;
+        removed = io->write(static_cast<long long>(recNo) * static_cast<long long>(sizeof(Record)), &w, sizeof(Record));
+        writes++;
+        generation++;
+        return false;
+    });
+    return removed;
+}
+
+/**
+ * @brief Remoção lógica posicionada a partir do ponteiro do índice.
+ * @param recNo Número do registro.
+ * @param key Chave esperada no registro.
+ * @return true se marcou; counters são atualizados.
+ */
+bool DataFile::removeAt(int recNo, int key) {
+    if (!io->isOpen() || recNo < 0) return false;
+    resetCounters();
+    return markRemoved(recNo, key);
+}
+
+/**
+ * @brief Lê o registro recNo e, se ativo com a chave, grava active=0 e retira a entrada do índice hash.
+ * @return true se marcou; soma aos contadores sem zerá-los.
+ */
+bool DataFile::markRemoved(int recNo, int key) {
+    long long pos = static_cast<long long>(recNo) * static_cast<long long>(sizeof(Record));
+    Record r{};
+    if (!io->read(pos, &r, sizeof(Record))) return false;
+    reads++;
+    if (r.key != key || r.active != 1) return false;
+    r.active = 0;
+    bool ok = io->write(pos, &r, sizeof(Record));
+    writes++;
+    generation++;
+    if (!ok) return false;
+    if (hash.isOpen()) hash.erase(key, recNo);
+    return true;
 }
 
 /**
  * @brief Imprime todos os registros (ativos e removidos) para depuração.
  */
 void DataFile::printAll() {
-    if (!file.is_open()) return;
-    file.clear();
-    file.seekg(0, ios::beg);
-    Record r{};
+    if (!io->isOpen()) return;
     cout << "------------------- data.bin -------------------" << endl;
-    while (file.read(reinterpret_cast<char*>(&r), sizeof(Record))) {
+    scanRecords([](const Record& r, int) {
         cout << "key=" << r.key << " | active=" << r.active << " | payload=\"" << r.payload << "\"" << endl;
-    }
+        return true;
+    });
     cout << "------------------------------------------------" << endl;
 }
 
@@ -276,23 +565,69 @@ void DataFile::printAll() {
  * @return true se leitura executada; counters não são alterados.
  */
 bool DataFile::listActiveKeys(std::vector<int>& outKeys) {
-    if (!file.is_open()) return false;
-    file.clear();
-    file.seekg(0, ios::beg);
-    Record r{};
+    if (!io->isOpen()) return false;
     outKeys.clear();
-    while (file.read(reinterpret_cast<char*>(&r), sizeof(Record))) {
+    scanRecords([&](const Record& r, int) {
         if (r.active == 1) outKeys.push_back(r.key);
-    }
+        return true;
+    });
+    return true;
+}
+
+/**
+ * @brief Lê todos os registros ativos devolvendo (chave, número do registro).
+ * @param outEntries Vetor de saída.
+ * @return true se leitura executada; counters não são alterados.
+ */
+bool DataFile::listActiveEntries(std::vector<std::pair<int,int>>& outEntries) {
+    if (!io->isOpen()) return false;
+    outEntries.clear();
+    scanRecords([&](const Record& r, int recNo) {
+        if (r.active == 1) outEntries.emplace_back(r.key, recNo);
+        return true;
+    });
+    return true;
+}
+
+/**
+ * @brief Lê todos os funcionarios ativos devolvendo (nome, número do registro).
+ * @param outNames Vetor de saída.
+ * @return true se leitura executada; counters não são alterados.
+ */
+bool DataFile::listActiveNames(std::vector<std::pair<std::string,int>>& outNames) {
+    if (!io->isOpen()) return false;
+    outNames.clear();
+    scanRecords([&](const Record& r, int recNo) {
+        if (r.active != 1) return true;
+        string nome = employeeName(r);
+        if (!nome.empty()) outNames.emplace_back(std::move(nome), recNo);
+        return true;
+    });
     return true;
 }
 
+/**
+ * @brief Nome do funcionario: campo do meio de "Funcionario id | Nome | Depto".
+ * @details Payload truncado antes do segundo separador não tem nome confiável e devolve vazio.
+ */
+std::string DataFile::employeeName(const Record& r) {
+    string_view payload(r.payload, strnlen(r.payload, sizeof(r.payload)));
+    const string_view sep = " | ";
+    size_t first = payload.find(sep);
+    if (first == string_view::npos) return "";
+    size_t start = first + sep.size();
+    size_t second = payload.find(sep, start);
+    if (second == string_view::npos || second == start) return "";
+    return string(payload.substr(start, second - start));
+}
+
 /**
  * @brief Zera contadores de I/O da última operação.
  */
 void DataFile::resetCounters() {
     reads = 0;
     writes = 0;
+    hash.resetCounters();
 }
 
 /**
@@ -302,3 +637,19 @@ void DataFile::resetCounters() {
 pair<long long,long long> DataFile::getCounters() const {
     return {reads, writes};
 }
+
+pair<long long,long long> DataFile::getHashCounters() const {
+    return hash.getCounters();
+}
+
+DataCounters DataFile::getDataCounters() const {
+    auto [hashReads, hashWrites] = hash.getCounters();
+    DataCounters c;
+    c.reads = reads;
+    c.writes = writes;
+    c.hashReads = hashReads;
+    c.hashWrites = hashWrites;
+    c.bytesRead = reads * static_cast<long long>(sizeof(Record)) + hashReads * HASH_PAGE_BYTES;
+    c.bytesWritten = writes * static_cast<long long>(sizeof(Record)) + hashWrites * HASH_PAGE_BYTES;
+    return c;
+}
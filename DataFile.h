@@ -10,7 +10,14 @@
 #ifndef DATAFILE_H
 #define DATAFILE_H
 
+#include "HashIndex.h"
+#include "Metrics.h"
+#include "StorageBackend.h"
+#include <cstddef>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,19 +32,73 @@ struct Record {
     char payload[64];
 };
 
+/**
+ * @brief Contadores de uma operação no arquivo de dados: registros lidos/gravados, bytes correspondentes
+ *        (registros e páginas do índice hash) e páginas do índice hash lidas/gravadas.
+ */
+struct DataCounters {
+    long long reads = 0;
+    long long writes = 0;
+    long long bytesRead = 0;
+    long long bytesWritten = 0;
+    long long hashReads = 0;
+    long long hashWrites = 0;
+
+    DataCounters& operator+=(const DataCounters& o) {
+        reads += o.reads;
+        writes += o.writes;
+        bytesRead += o.bytesRead;
+        bytesWritten += o.bytesWritten;
+        hashReads += o.hashReads;
+        hashWrites += o.hashWrites;
+        return *this;
+    }
+
+    /**
+     * @brief Chama f(nome, valor) para cada contador (exportação).
+     */
+    template <class F>
+    void forEach(F&& f) const {
+        f("reads", reads);
+        f("writes", writes);
+        f("bytes_read", bytesRead);
+        f("bytes_written", bytesWritten);
+        f("hash_reads", hashReads);
+        f("hash_writes", hashWrites);
+    }
+};
+
 /**
  * @brief Acesso ao arquivo principal binário (dados).
  * @details Oferece abrir/fechar, criação a partir de .txt/CSV simples, busca sequencial,
  *          inserção ao final, remoção lógica e listagem de chaves ativas. Expõe contadores de I/O.
+ *          Opcionalmente mantém um índice hash em disco (data.bin.hash) atualizado em insert/remove, que
+ *          torna find/remove O(1) leituras esperadas; ele é reaberto automaticamente por open() e
+ *          reconstruído a partir do data.bin quando estiver sujo ou desatualizado.
  */
 class DataFile {
 private:
-    std::fstream file;
+    std::unique_ptr<StorageBackend> io = makeStorageBackend(IoBackend::Pread);
     std::string filename;
     long long reads = 0;
     long long writes = 0;
+    long long generation = 0;
+    HashIndex hash;
+    OperationMetrics<DataCounters> findMetrics;
+
+    long long recordCount();
+    bool findRecord(int key, Record& out, int& outRecNo);
+    bool scanFind(int key, Record& out, int& outRecNo);
+    bool markRemoved(int recNo, int key);
+    bool scanRecords(const std::function<bool(const Record&, int recNo)>& visit);
 
 public:
+    /**
+     * @brief Destino dos registros gravados por createFromEmployees: (registros, quantidade, número do primeiro),
+     *        em ordem de arquivo. false interrompe a criação.
+     */
+    using RecordSink = std::function<bool(const Record* records, std::size_t count, long long firstRecNo)>;
+
     DataFile() = default;
     /**
      * @brief Destrutor: garante fechamento do arquivo, se aberto.
@@ -56,6 +117,18 @@ public:
      */
     void close();
 
+    /**
+     * @brief Seleciona o backend de I/O (pread ou io_uring); com o arquivo aberto, reabre-o no novo backend.
+     * @param kind Backend desejado (Uring cai para Pread se indisponível, ver getIoBackend()).
+     * @return false se o arquivo não puder ser reaberto.
+     */
+    bool setIoBackend(IoBackend kind);
+
+    /**
+     * @brief Backend de I/O efetivo.
+     */
+    IoBackend getIoBackend() const { return io->kind(); }
+
     /**
      * @brief Gera o arquivo de dados a partir de um .txt de nós (1 registro por chave).
      * @param textFilename Caminho do .txt (mesmo layout do índice).
@@ -68,18 +141,60 @@ public:
      * @brief Gera o data.bin a partir de employees.txt no formato "id;Nome;Depto".
      * @param employeesTxt Caminho do arquivo texto de entrada.
      * @param dataFilename Caminho do data.bin de saída.
+     * @param sink (Opcional) recebe os registros gravados, na mesma leitura (ex.: alimentar a carga do índice).
      * @return true em caso de sucesso.
      */
-    static bool createFromEmployees(const std::string& employeesTxt, const std::string& dataFilename);
+    static bool createFromEmployees(const std::string& employeesTxt, const std::string& dataFilename,
+                                    const RecordSink& sink = {});
 
     /**
-     * @brief Busca sequencial pelo primeiro registro ativo com a chave.
+     * @brief Gera o data.bin a partir de linhas "id;Nome;Depto" lidas de um stream (ex.: stdin).
+     * @param in Stream de entrada.
+     * @param dataFilename Caminho do data.bin de saída.
+     * @param sink (Opcional) recebe os registros gravados, na mesma leitura.
+     * @return true em caso de sucesso.
+     */
+    static bool createFromEmployees(std::istream& in, const std::string& dataFilename, const RecordSink& sink = {});
+
+    /**
+     * @brief Registro gerado para uma chave de um .txt de nós ("Funcionario K | depto=X").
+     */
+    static Record nodeKeyRecord(int key);
+
+    /**
+     * @brief Busca pelo primeiro registro ativo com a chave.
      * @param key Chave a procurar.
      * @param out Saída: registro encontrado (se true).
-     * @return true se encontrado (O(n)).
+     * @return true se encontrado (O(1) leituras esperadas com índice hash; senão O(n)).
      */
     bool find(int key, Record& out);
 
+    /**
+     * @brief Busca que também devolve o número do registro encontrado.
+     * @param key Chave a procurar.
+     * @param out Saída: registro encontrado (se true).
+     * @param outRecNo Saída: número do registro (0..N-1).
+     * @return true se encontrado (O(1) leituras esperadas com índice hash; senão O(n)).
+     */
+    bool find(int key, Record& out, int& outRecNo);
+
+    /**
+     * @brief Leitura posicionada de um registro (1 leitura), usada com os ponteiros do índice.
+     * @param recNo Número do registro (0..N-1).
+     * @param out Saída: registro lido.
+     * @return true se o registro existe e está ativo.
+     */
+    bool readAt(int recNo, Record& out);
+
+    /**
+     * @brief Leitura posicionada de vários registros, com as leituras em voo juntas no backend de I/O.
+     * @param recNos Números dos registros (qualquer ordem).
+     * @param out Saída: registro lido de cada posição (mesma ordem de recNos).
+     * @param ok Saída: ok[i] != 0 se recNos[i] existe e está ativo.
+     * @return Quantidade de registros ativos lidos; counters somam uma leitura por registro lido.
+     */
+    std::size_t readMany(std::span<const int> recNos, std::vector<Record>& out, std::vector<char>& ok);
+
     /**
      * @brief Insere um registro ativo no final do arquivo.
      * @param rec Registro de entrada (active é forçado para 1).
@@ -87,6 +202,14 @@ public:
      */
     bool insert(const Record& rec);
 
+    /**
+     * @brief Insere um registro ativo no final do arquivo e devolve seu número.
+     * @param rec Registro de entrada (active é forçado para 1).
+     * @param outRecNo Saída: número do registro gravado.
+     * @return true se a escrita foi bem-sucedida.
+     */
+    bool insert(const Record& rec, int& outRecNo);
+
     /**
      * @brief Insere funcionario com nome/depto (monta payload).
      * @param key Chave do funcionario.
@@ -96,6 +219,16 @@ public:
      */
     bool insertEmployee(int key, const std::string& nome, const std::string& depto);
 
+    /**
+     * @brief Insere funcionario e devolve o número do registro gravado.
+     * @param key Chave do funcionario.
+     * @param nome Nome do funcionario.
+     * @param depto Depto do funcionario.
+     * @param outRecNo Saída: número do registro gravado.
+     * @return true se a escrita foi bem-sucedida.
+     */
+    bool insertEmployee(int key, const std::string& nome, const std::string& depto, int& outRecNo);
+
     /**
      * @brief Remove logicamente (active=0) o primeiro registro ativo com a chave.
      * @param key Chave a remover.
@@ -103,6 +236,14 @@ public:
      */
     bool remove(int key);
 
+    /**
+     * @brief Remove logicamente o registro indicado pelo ponteiro do índice (1 leitura + 1 escrita).
+     * @param recNo Número do registro.
+     * @param key Chave esperada (confere com o registro lido).
+     * @return true se o registro estava ativo com a chave e foi marcado como removido.
+     */
+    bool removeAt(int recNo, int key);
+
     /**
      * @brief Imprime todos os registros (ativos/removidos) em stdout para inspeção.
      */
@@ -116,7 +257,59 @@ public:
     bool listActiveKeys(std::vector<int>& outKeys);
 
     /**
-     * @brief Zera contadores de I/O (reads/writes) da última operação.
+     * @brief Coleta pares (chave, número do registro) de todos os registros ativos.
+     * @param outEntries Vetor de saída.
+     * @return true se leitura executada.
+     */
+    bool listActiveEntries(std::vector<std::pair<int,int>>& outEntries);
+
+    /**
+     * @brief Coleta pares (nome, número do registro) dos funcionarios ativos (payload "Funcionario id | Nome | Depto").
+     * @param outNames Vetor de saída; registros sem campo de nome (ex.: gerados a partir de .txt) são ignorados.
+     * @return true se leitura executada.
+     */
+    bool listActiveNames(std::vector<std::pair<std::string,int>>& outNames);
+
+    /**
+     * @brief Extrai o nome do payload de um funcionario (campo entre o primeiro e o segundo " | ").
+     * @param r Registro lido.
+     * @return Nome, ou vazio se o payload não tiver os três campos.
+     */
+    static std::string employeeName(const Record& r);
+
+    /**
+     * @brief Liga (reconstruindo se preciso) ou desliga (removendo o arquivo) o índice hash.
+     * @param enabled true para manter data.bin.hash.
+     * @return true em caso de sucesso.
+     */
+    bool setHashIndex(bool enabled);
+
+    bool hasHashIndex() const { return hash.isOpen(); }
+
+    /**
+     * @brief Reconstrói o índice hash a partir dos registros ativos do data.bin.
+     * @return true em caso de sucesso.
+     */
+    bool rebuildHashIndex();
+
+    /**
+     * @brief Leituras/escritas de páginas do índice hash desde o último reset (junto de getCounters()).
+     * @return Par (reads, writes).
+     */
+    std::pair<long long,long long> getHashCounters() const;
+
+    /**
+     * @brief Caminho do arquivo aberto.
+     */
+    const std::string& getFilename() const { return filename; }
+
+    /**
+     * @brief Contador de modificações (inserções e remoções); usado para detectar alterações concorrentes.
+     */
+    long long getGeneration() const { return generation; }
+
+    /**
+     * @brief Zera contadores de I/O (reads/writes) da última operação, inclusive os do índice hash.
      */
     void resetCounters();
 
@@ -125,6 +318,21 @@ public:
      * @return Par (reads, writes).
      */
     std::pair<long long,long long> getCounters() const;
+
+    /**
+     * @brief Contadores da última operação, incluindo bytes e páginas do índice hash.
+     */
+    DataCounters getDataCounters() const;
+
+    /**
+     * @brief Métricas acumuladas de find: contadores totais, da última busca e histograma de latência.
+     */
+    const OperationMetrics<DataCounters>& getFindMetrics() const { return findMetrics; }
+
+    /**
+     * @brief Zera as métricas acumuladas de find.
+     */
+    void resetMetrics() { findMetrics.reset(); }
 };
 
 #endif
@@ -0,0 +1,16 @@
+/**
+* @file ExternalSort.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "ExternalSort.tpp"
+
+using namespace std;
+
+template class ExternalSorter<std::int32_t>;
+template class ExternalSorter<std::int64_t>;
+template class ExternalSorter<Key16>;
@@ -0,0 +1,113 @@
+/**
+* @file ExternalSort.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef EXTERNALSORT_H
+#define EXTERNALSORT_H
+
+#include "KeyTypes.h"
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Ordenação externa de pares (chave, registro) com orçamento de memória.
+ * @details Acumula pares em memória; ao exceder o orçamento, ordena o bloco e o grava como run
+ *          temporário. finish() fecha a fase de entrada; rewind()/next() percorrem a sequência ordenada
+ *          (merge k-vias dos runs, ou o próprio buffer se nada foi despejado), sem chaves repetidas.
+ *          A sequência pode ser percorrida mais de uma vez (rewind reabre os runs). Key deve ser copiável
+ *          byte a byte (os runs gravam os pares em binário); Compare define a ordem.
+ */
+template <class Key, class Compare = std::less<Key>>
+class ExternalSorter {
+public:
+    /**
+     * @brief Constrói o ordenador.
+     * @param memoryBudgetBytes Memória máxima para o buffer de entrada.
+     * @param tempPrefix Prefixo dos arquivos de run (ex.: "mvias.bin.run").
+     */
+    ExternalSorter(std::size_t memoryBudgetBytes, std::string tempPrefix);
+
+    /**
+     * @brief Destrutor: remove os runs temporários.
+     */
+    ~ExternalSorter();
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    /**
+     * @brief Adiciona um par; pode despejar um run em disco.
+     * @return false em falha de I/O.
+     */
+    bool add(const Key& key, int rec);
+
+    /**
+     * @brief Encerra a entrada (ordena o buffer ou despeja o último run).
+     * @return false em falha de I/O.
+     */
+    bool finish();
+
+    /**
+     * @brief Posiciona a leitura no início da sequência ordenada.
+     * @return false em falha ao reabrir runs.
+     */
+    bool rewind();
+
+    /**
+     * @brief Próximo par em ordem crescente de chave (repetidas são descartadas; vale o menor rec).
+     * @return false ao fim da sequência.
+     */
+    bool next(Key& key, int& rec);
+
+    /**
+     * @brief Quantidade de runs gravados em disco (0 = ordenação inteiramente em memória).
+     */
+    std::size_t runCount() const { return runFiles.size(); }
+
+    /**
+     * @brief Bytes gravados nos runs temporários.
+     */
+    long long spilledBytes() const { return runBytes; }
+
+private:
+    using Entry = std::pair<Key, int>;
+
+    struct RunReader {
+        std::ifstream in;
+        std::vector<Entry> buf;
+        std::size_t pos = 0;
+        bool refill();
+    };
+
+    std::size_t maxBuffered;
+    std::string prefix;
+    std::vector<Entry> buffer;
+    std::vector<std::string> runFiles;
+    std::vector<std::unique_ptr<RunReader>> readers;
+    std::vector<std::pair<Entry, std::size_t>> heap;
+    std::size_t memPos = 0;
+    long long runBytes = 0;
+    bool hasLast = false;
+    Key lastKey{};
+
+    bool spill();
+    bool nextRaw(Entry& e);
+};
+
+// Instanciações em ExternalSort.cpp: chaves int32, int64 e Key16 com std::less;
+// para outra chave ou outro comparador, inclua ExternalSort.tpp.
+extern template class ExternalSorter<std::int32_t>;
+extern template class ExternalSorter<std::int64_t>;
+extern template class ExternalSorter<Key16>;
+
+#endif
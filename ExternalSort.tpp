@@ -0,0 +1,159 @@
+/**
+* @file ExternalSort.tpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef EXTERNALSORT_TPP
+#define EXTERNALSORT_TPP
+
+#include "ExternalSort.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+namespace mways_detail {
+
+const size_t RUN_READ_BATCH = 4096;
+
+/**
+ * @brief Ordem dos pares: chave pelo comparador e, em empate, menor registro primeiro.
+ */
+template <class Key, class Compare>
+struct EntryLess {
+    bool operator()(const pair<Key,int>& a, const pair<Key,int>& b) const {
+        Compare comp;
+        if (comp(a.first, b.first)) return true;
+        if (comp(b.first, a.first)) return false;
+        return a.second < b.second;
+    }
+};
+
+/**
+ * @brief Comparador de min-heap para o merge (menor par no topo).
+ */
+template <class Key, class Compare>
+struct HeapGreater {
+    bool operator()(const pair<pair<Key,int>, size_t>& a, const pair<pair<Key,int>, size_t>& b) const {
+        return EntryLess<Key, Compare>{}(b.first, a.first);
+    }
+};
+
+} // namespace mways_detail
+
+template <class Key, class Compare>
+ExternalSorter<Key, Compare>::ExternalSorter(size_t memoryBudgetBytes, string tempPrefix)
+    : maxBuffered(max<size_t>(memoryBudgetBytes / sizeof(Entry), 1)), prefix(std::move(tempPrefix)) {
+}
+
+template <class Key, class Compare>
+ExternalSorter<Key, Compare>::~ExternalSorter() {
+    readers.clear();
+    for (const auto& f : runFiles) std::remove(f.c_str());
+}
+
+template <class Key, class Compare>
+bool ExternalSorter<Key, Compare>::add(const Key& key, int rec) {
+    buffer.emplace_back(key, rec);
+    if (buffer.size() >= maxBuffered) return spill();
+    return true;
+}
+
+/**
+ * @brief Ordena o buffer e grava como um novo run (pares binários crescentes).
+ * @return false em falha de escrita.
+ */
+template <class Key, class Compare>
+bool ExternalSorter<Key, Compare>::spill() {
+    sort(buffer.begin(), buffer.end(), mways_detail::EntryLess<Key, Compare>{});
+    string name = prefix + to_string(runFiles.size());
+    ofstream out(name, ios::binary | ios::trunc);
+    if (!out.is_open()) return false;
+    runFiles.push_back(name);
+    out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<streamsize>(buffer.size() * sizeof(Entry)));
+    out.close();
+    runBytes += static_cast<long long>(buffer.size() * sizeof(Entry));
+    buffer.clear();
+    return static_cast<bool>(out);
+}
+
+template <class Key, class Compare>
+bool ExternalSorter<Key, Compare>::finish() {
+    if (runFiles.empty()) {
+        sort(buffer.begin(), buffer.end(), mways_detail::EntryLess<Key, Compare>{});
+        return true;
+    }
+    if (!buffer.empty() && !spill()) return false;
+    buffer.shrink_to_fit();
+    return true;
+}
+
+template <class Key, class Compare>
+bool ExternalSorter<Key, Compare>::RunReader::refill() {
+    buf.resize(mways_detail::RUN_READ_BATCH);
+    in.read(reinterpret_cast<char*>(buf.data()), static_cast<streamsize>(mways_detail::RUN_READ_BATCH * sizeof(Entry)));
+    buf.resize(static_cast<size_t>(in.gcount()) / sizeof(Entry));
+    pos = 0;
+    return !buf.empty();
+}
+
+/**
+ * @brief Reinicia a leitura: em memória volta ao início do buffer; em disco reabre os runs e monta o heap.
+ * @return false se algum run não puder ser reaberto.
+ */
+template <class Key, class Compare>
+bool ExternalSorter<Key, Compare>::rewind() {
+    memPos = 0;
+    hasLast = false;
+    readers.clear();
+    heap.clear();
+    for (size_t i = 0; i < runFiles.size(); ++i) {
+        auto r = make_unique<RunReader>();
+        r->in.open(runFiles[i], ios::binary);
+        if (!r->in.is_open()) return false;
+        if (r->refill()) heap.push_back({r->buf[0], i});
+        readers.push_back(std::move(r));
+    }
+    make_heap(heap.begin(), heap.end(), mways_detail::HeapGreater<Key, Compare>{});
+    return true;
+}
+
+template <class Key, class Compare>
+bool ExternalSorter<Key, Compare>::nextRaw(Entry& e) {
+    if (runFiles.empty()) {
+        if (memPos >= buffer.size()) return false;
+        e = buffer[memPos++];
+        return true;
+    }
+    if (heap.empty()) return false;
+    pop_heap(heap.begin(), heap.end(), mways_detail::HeapGreater<Key, Compare>{});
+    auto [top, idx] = heap.back();
+    heap.pop_back();
+    e = top;
+    RunReader& r = *readers[idx];
+    if (++r.pos < r.buf.size() || r.refill()) {
+        heap.push_back({r.buf[r.pos], idx});
+        push_heap(heap.begin(), heap.end(), mways_detail::HeapGreater<Key, Compare>{});
+    }
+    return true;
+}
+
+template <class Key, class Compare>
+bool ExternalSorter<Key, Compare>::next(Key& key, int& rec) {
+    Entry e;
+    while (nextRaw(e)) {
+        if (hasLast && !Compare{}(lastKey, e.first)) continue;
+        hasLast = true;
+        lastKey = e.first;
+        key = e.first;
+        rec = e.second;
+        return true;
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,273 @@
+/**
+* @file HashIndex.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "HashIndex.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+const uint32_t HASH_MAGIC = 0x5848574D; // "MWHX"
+const int HASH_VERSION = 1;
+
+/**
+ * @brief Header do índice (início da página 0).
+ */
+struct HashHeader {
+    uint32_t magic;
+    int32_t version;
+    int32_t globalDepth;
+    int32_t pages;
+    int64_t entries;
+    int64_t dataRecords;
+    int32_t clean;
+    int32_t reserved;
+};
+
+off_t pageOffset(int page) {
+    return static_cast<off_t>(page) * HASH_PAGE_BYTES;
+}
+
+}
+
+HashIndex::~HashIndex() {
+    if (fd >= 0) ::close(fd);
+}
+
+/**
+ * @brief Finalizador do MurmurHash3: espalha chaves sequenciais pelos bits baixos usados no diretório.
+ */
+uint32_t HashIndex::hashKey(int key) {
+    uint32_t h = static_cast<uint32_t>(key);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+bool HashIndex::readBucket(int page, Bucket& b) {
+    reads++;
+    return ::pread(fd, &b, sizeof(Bucket), pageOffset(page)) == static_cast<ssize_t>(sizeof(Bucket));
+}
+
+bool HashIndex::writeBucket(int page, const Bucket& b) {
+    writes++;
+    return ::pwrite(fd, &b, sizeof(Bucket), pageOffset(page)) == static_cast<ssize_t>(sizeof(Bucket));
+}
+
+bool HashIndex::writeHeader(bool clean, long long dataRecords) {
+    HashHeader h{HASH_MAGIC, HASH_VERSION, globalDepth, pages, entries, dataRecords, clean ? 1 : 0, 0};
+    return ::pwrite(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h));
+}
+
+/**
+ * @brief Valida header e diretório; em seguida grava o header como sujo (com fdatasync) antes de qualquer
+ *        modificação, para que uma queda deixe o índice marcado para reconstrução.
+ */
+bool HashIndex::open(const std::string& path, long long dataRecords) {
+    if (fd >= 0) ::close(fd);
+    fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) return false;
+    HashHeader h{};
+    bool ok = ::pread(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) &&
+              h.magic == HASH_MAGIC && h.version == HASH_VERSION && h.clean == 1 &&
+              h.dataRecords == dataRecords && h.globalDepth >= 0 && h.globalDepth <= HASH_MAX_DEPTH &&
+              h.pages >= 2;
+    if (ok) {
+        directory.assign(size_t{1} << h.globalDepth, 0);
+        ssize_t bytes = static_cast<ssize_t>(directory.size() * sizeof(int));
+        ok = ::pread(fd, directory.data(), static_cast<size_t>(bytes), pageOffset(h.pages)) == bytes;
+        for (size_t i = 0; ok && i < directory.size(); ++i) ok = directory[i] >= 1 && directory[i] < h.pages;
+    }
+    if (ok) {
+        globalDepth = h.globalDepth;
+        pages = h.pages;
+        entries = h.entries;
+        ok = writeHeader(false, dataRecords) && ::fdatasync(fd) == 0;
+    }
+    if (!ok) {
+        ::close(fd);
+        fd = -1;
+        directory.clear();
+    }
+    return ok;
+}
+
+/**
+ * @brief Carga em lote: escolhe a profundidade para ~70% de ocupação, distribui as entradas pelos bits
+ *        baixos do hash e grava os buckets em sequência (overflow contíguo no caso raro de bucket cheio).
+ */
+bool HashIndex::build(const std::string& path, const std::vector<HashEntry>& input, long long dataRecords) {
+    if (fd >= 0) ::close(fd);
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    int depth = 0;
+    const size_t perBucket = BUCKET_SLOTS * 7 / 10;
+    while (depth < HASH_MAX_DEPTH && (perBucket << depth) < input.size()) depth++;
+    const uint32_t mask = (1u << depth) - 1;
+    vector<vector<HashEntry>> groups(size_t{1} << depth);
+    for (const HashEntry& e : input) groups[hashKey(e.key) & mask].push_back(e);
+
+    globalDepth = depth;
+    pages = 1;
+    entries = static_cast<long long>(input.size());
+    directory.assign(groups.size(), 0);
+    vector<Bucket> image;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        directory[g] = pages;
+        const vector<HashEntry>& group = groups[g];
+        size_t at = 0;
+        do {
+            Bucket b{};
+            b.depth = depth;
+            while (at < group.size() && b.count < BUCKET_SLOTS) b.slots[b.count++] = group[at++];
+            pages++;
+            if (at < group.size()) b.overflow = pages;
+            image.push_back(b);
+        } while (at < group.size());
+    }
+    ssize_t bytes = static_cast<ssize_t>(image.size() * sizeof(Bucket));
+    bool ok = ::pwrite(fd, image.data(), static_cast<size_t>(bytes), pageOffset(1)) == bytes &&
+              writeHeader(false, dataRecords);
+    writes += static_cast<long long>(image.size());
+    if (!ok) {
+        ::close(fd);
+        fd = -1;
+        directory.clear();
+    }
+    return ok;
+}
+
+void HashIndex::close(long long dataRecords) {
+    if (fd < 0) return;
+    ssize_t bytes = static_cast<ssize_t>(directory.size() * sizeof(int));
+    if (::pwrite(fd, directory.data(), static_cast<size_t>(bytes), pageOffset(pages)) == bytes &&
+        ::ftruncate(fd, pageOffset(pages) + bytes) == 0) {
+        writeHeader(true, dataRecords);
+    }
+    ::close(fd);
+    fd = -1;
+    directory.clear();
+}
+
+/**
+ * @brief Divide o bucket (profundidade local d) pelo bit d do hash; dobra o diretório se d for a
+ *        profundidade global e redireciona para a nova página as entradas do diretório com o bit d ligado.
+ * @param page Página do bucket.
+ * @param b Conteúdo do bucket; na saída, a metade que permaneceu na página.
+ */
+bool HashIndex::split(int page, Bucket& b) {
+    const int d = b.depth;
+    if (d == globalDepth) {
+        size_t old = directory.size();
+        directory.resize(old * 2);
+        for (size_t i = 0; i < old; ++i) directory[old + i] = directory[i];
+        globalDepth++;
+    }
+    const int np = pages++;
+    Bucket kept{};
+    Bucket moved{};
+    kept.depth = moved.depth = d + 1;
+    for (int i = 0; i < b.count; ++i) {
+        if ((hashKey(b.slots[i].key) >> d) & 1u) moved.slots[moved.count++] = b.slots[i];
+        else kept.slots[kept.count++] = b.slots[i];
+    }
+    if (!writeBucket(page, kept) || !writeBucket(np, moved)) return false;
+    for (size_t i = 0; i < directory.size(); ++i) {
+        if (directory[i] == page && ((i >> d) & 1u)) directory[i] = np;
+    }
+    b = kept;
+    return true;
+}
+
+bool HashIndex::insert(int key, int recNo) {
+    if (fd < 0) return false;
+    const uint32_t h = hashKey(key);
+    while (true) {
+        int slot = static_cast<int>(h & ((1u << globalDepth) - 1));
+        int page = directory[slot];
+        Bucket b{};
+        if (!readBucket(page, b)) return false;
+        if (b.count < BUCKET_SLOTS && b.overflow == 0) {
+            b.slots[b.count++] = {key, recNo};
+            entries++;
+            return writeBucket(page, b);
+        }
+        bool sameHash = true;
+        for (int i = 0; i < b.count && sameHash; ++i) sameHash = hashKey(b.slots[i].key) == h;
+        if (b.overflow == 0 && b.depth < HASH_MAX_DEPTH && !sameHash) {
+            if (!split(page, b)) return false;
+            continue;
+        }
+        int cur = page;
+        while (b.count == BUCKET_SLOTS && b.overflow != 0) {
+            cur = b.overflow;
+            if (!readBucket(cur, b)) return false;
+        }
+        entries++;
+        if (b.count < BUCKET_SLOTS) {
+            b.slots[b.count++] = {key, recNo};
+            return writeBucket(cur, b);
+        }
+        Bucket o{};
+        o.depth = b.depth;
+        o.count = 1;
+        o.slots[0] = {key, recNo};
+        b.overflow = pages++;
+        return writeBucket(b.overflow, o) && writeBucket(cur, b);
+    }
+}
+
+bool HashIndex::erase(int key, int recNo) {
+    if (fd < 0) return false;
+    int page = directory[hashKey(key) & ((1u << globalDepth) - 1)];
+    Bucket b{};
+    while (page != 0 && readBucket(page, b)) {
+        for (int i = 0; i < b.count; ++i) {
+            if (b.slots[i].key == key && b.slots[i].recNo == recNo) {
+                b.slots[i] = b.slots[--b.count];
+                entries--;
+                return writeBucket(page, b);
+            }
+        }
+        page = b.overflow;
+    }
+    return false;
+}
+
+bool HashIndex::find(int key, int& outRecNo) {
+    if (fd < 0) return false;
+    int page = directory[hashKey(key) & ((1u << globalDepth) - 1)];
+    bool found = false;
+    Bucket b{};
+    while (page != 0 && readBucket(page, b)) {
+        for (int i = 0; i < b.count; ++i) {
+            if (b.slots[i].key == key && (!found || b.slots[i].recNo < outRecNo)) {
+                outRecNo = b.slots[i].recNo;
+                found = true;
+            }
+        }
+        page = b.overflow;
+    }
+    return found;
+}
+
+void HashIndex::resetCounters() {
+    reads = 0;
+    writes = 0;
+}
+
+pair<long long,long long> HashIndex::getCounters() const {
+    return {reads, writes};
+}
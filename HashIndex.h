@@ -0,0 +1,140 @@
+/**
+* @file HashIndex.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+const int HASH_PAGE_BYTES = 512;
+const int HASH_MAX_DEPTH = 20;
+
+/**
+ * @brief Entrada do índice hash: chave do registro e seu número em data.bin.
+ */
+struct HashEntry {
+    int key;
+    int recNo;
+};
+
+/**
+ * @brief Índice hash extensível em disco (chave -> número do registro) para o arquivo de dados.
+ * @details Página 0 guarda o header; as demais são buckets de 512 bytes (profundidade local, contagem,
+ *          próxima página de overflow e 62 entradas). O diretório (2^profundidade global ids de página)
+ *          fica em memória: é lido na abertura e gravado após o último bucket no fechamento. Bucket cheio
+ *          é dividido pelo bit seguinte do hash, dobrando o diretório quando necessário; se todas as
+ *          entradas tiverem o mesmo hash (chaves repetidas) ou o bucket já tiver overflow, encadeia uma página
+ *          de overflow. Remoções não fundem buckets. Uma busca lê uma página (mais o overflow, se houver).
+ *
+ *          O header marca o índice como "sujo" enquanto aberto; um índice que não foi fechado (queda) ou
+ *          cujo total de registros não confere com o data.bin é recusado por open() e deve ser reconstruído.
+ */
+class HashIndex {
+public:
+    HashIndex() = default;
+
+    /**
+     * @brief Destrutor: fecha o descritor (sem gravar o diretório; o índice fica marcado como sujo).
+     */
+    ~HashIndex();
+
+    HashIndex(const HashIndex&) = delete;
+    HashIndex& operator=(const HashIndex&) = delete;
+
+    /**
+     * @brief Caminho do índice associado a um arquivo de dados.
+     */
+    static std::string pathFor(const std::string& dataFilename) { return dataFilename + ".hash"; }
+
+    /**
+     * @brief Abre um índice existente e o marca como sujo.
+     * @param path Caminho do índice.
+     * @param dataRecords Total de registros do data.bin (ativos ou não).
+     * @return false se ausente, inválido, sujo ou desatualizado em relação a dataRecords.
+     */
+    bool open(const std::string& path, long long dataRecords);
+
+    /**
+     * @brief Reconstrói o índice a partir das entradas ativas (sobrescreve o arquivo) e o deixa aberto.
+     * @param path Caminho do índice.
+     * @param entries Pares (chave, número do registro).
+     * @param dataRecords Total de registros do data.bin.
+     * @return true em caso de sucesso.
+     */
+    bool build(const std::string& path, const std::vector<HashEntry>& entries, long long dataRecords);
+
+    /**
+     * @brief Grava diretório e header (limpo) e fecha.
+     * @param dataRecords Total de registros do data.bin no fechamento.
+     */
+    void close(long long dataRecords);
+
+    bool isOpen() const { return fd >= 0; }
+
+    /**
+     * @brief Acrescenta a entrada (chave, registro).
+     * @return false em falha de I/O.
+     */
+    bool insert(int key, int recNo);
+
+    /**
+     * @brief Remove a entrada (chave, registro).
+     * @return true se a entrada existia.
+     */
+    bool erase(int key, int recNo);
+
+    /**
+     * @brief Menor número de registro indexado com a chave (o primeiro ativo, como na busca sequencial).
+     * @param key Chave procurada.
+     * @param outRecNo Saída: número do registro.
+     * @return true se a chave está no índice.
+     */
+    bool find(int key, int& outRecNo);
+
+    long long size() const { return entries; }
+    int getGlobalDepth() const { return globalDepth; }
+    int getPages() const { return pages; }
+
+    void resetCounters();
+
+    /**
+     * @brief Leituras e escritas de páginas desde o último reset.
+     * @return Par (reads, writes).
+     */
+    std::pair<long long,long long> getCounters() const;
+
+private:
+    struct Bucket {
+        int depth;
+        int count;
+        int overflow;
+        int reserved;
+        HashEntry slots[(HASH_PAGE_BYTES - 16) / static_cast<int>(sizeof(HashEntry))];
+    };
+    static const int BUCKET_SLOTS = (HASH_PAGE_BYTES - 16) / static_cast<int>(sizeof(HashEntry));
+
+    int fd = -1;
+    int globalDepth = 0;
+    int pages = 1;
+    long long entries = 0;
+    std::vector<int> directory;
+    long long reads = 0;
+    long long writes = 0;
+
+    static std::uint32_t hashKey(int key);
+    bool readBucket(int page, Bucket& b);
+    bool writeBucket(int page, const Bucket& b);
+    bool writeHeader(bool clean, long long dataRecords);
+    bool split(int page, Bucket& b);
+};
+
+#endif
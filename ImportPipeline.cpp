@@ -0,0 +1,123 @@
+/**
+* @file ImportPipeline.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "ImportPipeline.h"
+#include "DataFile.h"
+#include "ExternalSort.h"
+#include "MWayTree.h"
+#include "TextChunks.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const size_t RECORDS_PER_TASK = 8192;
+
+long long sizeOf(const string& path) {
+    error_code ec;
+    auto bytes = filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<long long>(bytes);
+}
+
+/**
+ * @brief Carga em lote do índice a partir dos pares (chave, registro) já coletados no ordenador.
+ */
+bool buildIndex(ExternalSorter<int>& sorter, const string& indexFilename, int order, int pageSize, ImportStats& stats) {
+    if (!sorter.finish() || !MWayTree<>::createEmpty(indexFilename, order, pageSize)) return false;
+    MWayTree<> tree(order);
+    if (!tree.openBinary(indexFilename)) return false;
+    bool ok = tree.bulkLoad(sorter);
+    tree.closeBinary();
+    stats.sortBytes = sorter.spilledBytes();
+    stats.indexBytes = sizeOf(indexFilename);
+    return ok;
+}
+
+/**
+ * @brief Coleta no ordenador cada registro gravado (chave, número do registro).
+ */
+DataFile::RecordSink sortingSink(ExternalSorter<int>& sorter, ImportStats& stats) {
+    return [&sorter, &stats](const Record* records, size_t count, long long firstRecNo) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!sorter.add(records[i].key, static_cast<int>(firstRecNo + static_cast<long long>(i)))) return false;
+        }
+        stats.records += static_cast<long long>(count);
+        return true;
+    };
+}
+
+} // namespace
+
+bool importNodeText(const string& textFilename, const string& indexFilename, const string& dataFilename, int order,
+                    ImportStats& stats, int pageSize) {
+    stats = ImportStats{};
+    const string tmpData = dataFilename + ".tmp";
+    ofstream data(tmpData, ios::binary | ios::trunc);
+    if (!data.is_open()) return false;
+
+    const size_t workers = max(1u, thread::hardware_concurrency());
+    vector<Record> records;
+    auto sink = [&](const int* keys, size_t count) {
+        records.resize(count);
+        size_t tasks = min(workers, (count + RECORDS_PER_TASK - 1) / RECORDS_PER_TASK);
+        TextChunks::parallelFor(tasks, [&](size_t t) {
+            for (size_t i = t * count / tasks, end = (t + 1) * count / tasks; i < end; ++i) {
+                records[i] = DataFile::nodeKeyRecord(keys[i]);
+            }
+        });
+        data.write(reinterpret_cast<const char*>(records.data()), static_cast<streamsize>(count * sizeof(Record)));
+        stats.records += static_cast<long long>(count);
+        return static_cast<bool>(data);
+    };
+    bool ok = MWayTree<>::createFromText(textFilename, indexFilename, order, pageSize, sink);
+    data.close();
+    if (!ok || data.fail()) {
+        std::remove(tmpData.c_str());
+        return false;
+    }
+    std::remove(HashIndex::pathFor(dataFilename).c_str());
+    if (std::rename(tmpData.c_str(), dataFilename.c_str()) != 0) return false;
+
+    stats.inputPasses = 1;
+    stats.inputBytes = sizeOf(textFilename);
+    stats.dataBytes = stats.records * static_cast<long long>(sizeof(Record));
+    stats.indexBytes = sizeOf(indexFilename);
+    return true;
+}
+
+bool importEmployees(const string& employeesTxt, const string& indexFilename, const string& dataFilename, int order,
+                     ImportStats& stats, int pageSize) {
+    stats = ImportStats{};
+    ExternalSorter<int> sorter(BULK_MEMORY_DEFAULT, indexFilename + ".run");
+    if (!DataFile::createFromEmployees(employeesTxt, dataFilename, sortingSink(sorter, stats))) return false;
+    stats.inputPasses = 1;
+    stats.inputBytes = sizeOf(employeesTxt);
+    stats.dataBytes = stats.records * static_cast<long long>(sizeof(Record));
+    return buildIndex(sorter, indexFilename, order, pageSize, stats);
+}
+
+bool importEmployees(istream& in, const string& indexFilename, const string& dataFilename, int order,
+                     ImportStats& stats, int pageSize) {
+    stats = ImportStats{};
+    ExternalSorter<int> sorter(BULK_MEMORY_DEFAULT, indexFilename + ".run");
+    auto start = in.tellg();
+    if (!DataFile::createFromEmployees(in, dataFilename, sortingSink(sorter, stats))) return false;
+    stats.inputPasses = 1;
+    in.clear();
+    auto end = in.tellg();
+    stats.inputBytes = (start >= 0 && end >= start) ? static_cast<long long>(end - start) : -1;
+    stats.dataBytes = stats.records * static_cast<long long>(sizeof(Record));
+    return buildIndex(sorter, indexFilename, order, pageSize, stats);
+}
@@ -0,0 +1,67 @@
+/**
+* @file ImportPipeline.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef IMPORTPIPELINE_H
+#define IMPORTPIPELINE_H
+
+#include <istream>
+#include <string>
+
+/**
+ * @brief Resumo de uma importação: leituras da entrada e bytes gravados por destino.
+ */
+struct ImportStats {
+    int inputPasses = 0;      // leituras completas da entrada
+    long long inputBytes = 0; // -1 se desconhecido (stream sem posição, ex.: pipe)
+    long long records = 0;    // registros gravados em data.bin
+    long long dataBytes = 0;
+    long long indexBytes = 0;
+    long long sortBytes = 0;  // runs temporários da ordenação externa (0 se coube na memória)
+
+    long long bytesWritten() const { return dataBytes + indexBytes + sortBytes; }
+};
+
+/**
+ * @brief Cria índice e data.bin a partir de um .txt de nós com uma única leitura da entrada.
+ * @details MWayTree::createFromText entrega as chaves de cada bloco, em ordem, e os registros correspondentes
+ *          são gravados na mesma passada (a i-ésima chave aponta para o registro i). data.bin só é substituído
+ *          se o índice passar nas validações.
+ * @param textFilename Caminho do .txt de nós.
+ * @param indexFilename Caminho do índice de saída.
+ * @param dataFilename Caminho do data.bin de saída.
+ * @param order Ordem m desejada.
+ * @param stats Saída: resumo da importação.
+ * @param pageSize Tamanho de página (0 = registros compactos).
+ * @return true em caso de sucesso.
+ */
+bool importNodeText(const std::string& textFilename, const std::string& indexFilename, const std::string& dataFilename,
+                    int order, ImportStats& stats, int pageSize = 0);
+
+/**
+ * @brief Cria data.bin e o índice a partir de employees.txt ("id;Nome;Depto") com uma única leitura da entrada.
+ * @details Cada registro gravado em data.bin entra, com o seu número, no ExternalSorter à medida que é lido;
+ *          a sequência ordenada vai direto para a carga em lote bottom-up do índice (sem reler data.bin).
+ * @param employeesTxt Caminho do arquivo de funcionários.
+ * @param indexFilename Caminho do índice de saída.
+ * @param dataFilename Caminho do data.bin de saída.
+ * @param order Ordem m desejada.
+ * @param stats Saída: resumo da importação.
+ * @param pageSize Tamanho de página (0 = registros compactos).
+ * @return true em caso de sucesso.
+ */
+bool importEmployees(const std::string& employeesTxt, const std::string& indexFilename, const std::string& dataFilename,
+                     int order, ImportStats& stats, int pageSize = 0);
+
+/**
+ * @brief Como importEmployees, lendo as linhas de um stream (ex.: stdin).
+ */
+bool importEmployees(std::istream& in, const std::string& indexFilename, const std::string& dataFilename, int order,
+                     ImportStats& stats, int pageSize = 0);
+
+#endif
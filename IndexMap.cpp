@@ -0,0 +1,86 @@
+/**
+* @file IndexMap.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "IndexMap.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+IndexMap::~IndexMap() {
+    close();
+}
+
+bool IndexMap::open(const std::string& filename, int maxOrder_) {
+    close();
+    path = filename;
+    maxOrder = maxOrder_;
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    if (!mapCurrent()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void IndexMap::close() {
+    if (base) munmap(base, length);
+    base = nullptr;
+    length = 0;
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+/**
+ * @brief Mapeia o arquivo com o tamanho atual, valida o header e reaplica o madvise corrente.
+ * @return false se o arquivo for menor que o header, o mmap falhar ou o header for inválido.
+ */
+bool IndexMap::mapCurrent() {
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < HEADER_BYTES) return false;
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return false;
+    base = static_cast<char*>(p);
+    length = static_cast<size_t>(st.st_size);
+    if (!NodeFormat::decodeHeader(base, fmt, hdr, maxOrder)) {
+        munmap(base, length);
+        base = nullptr;
+        length = 0;
+        return false;
+    }
+    advise(pattern);
+    return true;
+}
+
+bool IndexMap::refresh() {
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0) return false;
+    if (base && static_cast<size_t>(st.st_size) == length) return true;
+    if (base) munmap(base, length);
+    base = nullptr;
+    length = 0;
+    return mapCurrent();
+}
+
+/**
+ * @brief Random desliga a leitura antecipada (buscas tocam poucos nós espalhados); Sequential a amplia;
+ *        WillNeed pede ao kernel que carregue o arquivo inteiro (percursos completos em BFS).
+ */
+void IndexMap::advise(Access access) {
+    pattern = access;
+    if (!base) return;
+    int advice = MADV_RANDOM;
+    if (access == Access::Sequential) advice = MADV_SEQUENTIAL;
+    else if (access == Access::WillNeed) advice = MADV_WILLNEED;
+    madvise(base, length, advice);
+}
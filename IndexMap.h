@@ -0,0 +1,159 @@
+/**
+* @file IndexMap.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef INDEXMAP_H
+#define INDEXMAP_H
+
+#include "Node.h"
+#include "NodeFormat.h"
+#include "NodeSearch.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief Visão somente-leitura de um nó diretamente no mapeamento (sem cópia).
+ * @details Os ponteiros apontam para o registro do nó no arquivo mapeado (layout de NodeFormat): keys[0..n-1],
+ *          recs[0..n-1] (nullptr em arquivos da versão 2) e children[0..n]. Válida até o próximo
+ *          remapeamento ou close() do IndexMap. Key deve ser o tipo de chave gravado no header.
+ */
+template <class Key>
+struct BasicNodeView {
+    int n = 0;
+    const Key* keys = nullptr;
+    const int* recs = nullptr;
+    const int* children = nullptr;
+    bool padded = false; // true se os kernels SIMD podem ler keys até o múltiplo de 8 seguinte a n
+};
+
+/**
+ * @brief Visão de nó com chaves int (índice original).
+ */
+using NodeView = BasicNodeView<int>;
+
+/**
+ * @brief Mapeamento (mmap) somente-leitura do índice.
+ * @details Mapeia o arquivo inteiro com MAP_SHARED, de modo que escritas feitas pela árvore (pwrite) ficam
+ *          visíveis sem recarga; quando o arquivo cresce (writeNode anexando nós), view() de uma posição
+ *          além do mapeado remapeia. advise() ajusta o madvise conforme o padrão de acesso: aleatório para
+ *          buscas, sequencial para exportação, WillNeed para percursos do arquivo inteiro.
+ */
+class IndexMap {
+public:
+    enum class Access { Random, Sequential, WillNeed };
+
+    IndexMap() = default;
+
+    /**
+     * @brief Destrutor: desfaz o mapeamento.
+     */
+    ~IndexMap();
+
+    IndexMap(const IndexMap&) = delete;
+    IndexMap& operator=(const IndexMap&) = delete;
+
+    /**
+     * @brief Mapeia o índice e interpreta o header.
+     * @param filename Caminho do .bin.
+     * @param maxOrder Maior ordem aceita no header (MaxM da árvore que usa o mapeamento).
+     * @return true se o arquivo foi mapeado e o header é válido.
+     */
+    bool open(const std::string& filename, int maxOrder = MAX_M);
+
+    /**
+     * @brief Desfaz o mapeamento e fecha o descritor.
+     */
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+
+    /**
+     * @brief Remapeia se o tamanho do arquivo mudou (crescimento por writeNode).
+     * @return false se o arquivo não puder ser remapeado.
+     */
+    bool refresh();
+
+    /**
+     * @brief Aplica o padrão de acesso ao mapeamento (madvise) e o mantém nos remapeamentos.
+     */
+    void advise(Access access);
+
+    const NodeFormat& format() const { return fmt; }
+    const FileHeader& header() const { return hdr; }
+
+    /**
+     * @brief Tamanho do arquivo mapeado em bytes.
+     */
+    std::size_t size() const { return length; }
+
+    /**
+     * @brief Quantidade de nós no mapeamento atual.
+     */
+    int positions() const { return fmt.positionsIn(static_cast<long long>(length)); }
+
+    /**
+     * @brief Visão do nó na posição lógica (remapeia se a posição estiver além do mapeado).
+     * @param position Posição lógica (>=1).
+     * @param out Saída: visão do nó.
+     * @return false se a posição não existir no arquivo.
+     */
+    template <class Key>
+    bool view(int position, BasicNodeView<Key>& out) {
+        if (!base || position < 1) return false;
+        if (position > positions() && (!refresh() || position > positions())) return false;
+        const char* p = base + fmt.offsetOf(position);
+        out.n = *reinterpret_cast<const int*>(p);
+        out.keys = reinterpret_cast<const Key*>(p + fmt.keyOffset);
+        out.recs = (fmt.version >= 3) ? reinterpret_cast<const int*>(p + fmt.recOffset) : nullptr;
+        out.children = reinterpret_cast<const int*>(p + fmt.childOffset);
+        out.padded = reinterpret_cast<const char*>(out.keys + ((out.n + 7) & ~7)) <= base + length;
+        return true;
+    }
+
+    /**
+     * @brief Início do nó no mapeamento atual, sem remapear (nullptr se a posição estiver além do mapeado).
+     * @details Usado só para antecipar as linhas do nó (nodeBytes() bytes) antes de view().
+     */
+    const char* address(int position) const {
+        if (!base || position < 1 || position > positions()) return nullptr;
+        return base + fmt.offsetOf(position);
+    }
+
+    /**
+     * @brief Bytes úteis de um nó (n, keys, recs e children), sem o restante da página no formato paginado.
+     */
+    std::size_t nodeBytes() const { return static_cast<std::size_t>(fmt.childOffset) + static_cast<std::size_t>(fmt.m) * sizeof(int); }
+
+    /**
+     * @brief Slot da chave na visão (kernel ativo se houver folga para leitura SIMD; senão busca binária).
+     */
+    template <class Key, class Compare = std::less<Key>>
+    static int slotOf(const BasicNodeView<Key>& node, const Key& key, Compare comp = {}) {
+        if constexpr (std::is_same_v<Key, int> && std::is_same_v<Compare, std::less<int>>) {
+            return node.padded ? activeSlotSearch(node.keys, node.n, key) : slotSearchBranchless(node.keys, node.n, key);
+        } else {
+            return keySlot(node.keys, node.n, key, comp);
+        }
+    }
+
+private:
+    std::string path;
+    int fd = -1;
+    char* base = nullptr;
+    std::size_t length = 0;
+    NodeFormat fmt;
+    FileHeader hdr{};
+    int maxOrder = MAX_M;
+    Access pattern = Access::Random;
+
+    bool mapCurrent();
+};
+
+#endif
@@ -0,0 +1,159 @@
+/**
+* @file InterleavedLookup.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef INTERLEAVEDLOOKUP_H
+#define INTERLEAVEDLOOKUP_H
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Buscas simultâneas por thread em MWayTree::mSearchInterleaved (padrão).
+ */
+const int INTERLEAVE_WIDTH = 16;
+
+/**
+ * @brief Antecipa para o cache do processador as linhas de [p, p + bytes) (sem efeito fora de GCC/Clang).
+ */
+inline void prefetchBytes(const void* p, std::size_t bytes) {
+#if defined(__GNUC__)
+    const char* c = static_cast<const char*>(p);
+    for (std::size_t off = 0; off < bytes; off += 64) __builtin_prefetch(c + off);
+#else
+    (void)p;
+    (void)bytes;
+#endif
+}
+
+/**
+ * @brief Corrotina de uma busca intercalada: começa suspensa e fica suspensa ao terminar, até o escalonador
+ *        destruí-la (release() entrega o handle a ele).
+ */
+class LookupTask {
+public:
+    struct promise_type {
+        LookupTask get_return_object() { return LookupTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    LookupTask(LookupTask&& o) noexcept : handle(std::exchange(o.handle, {})) {}
+    LookupTask(const LookupTask&) = delete;
+    LookupTask& operator=(const LookupTask&) = delete;
+    LookupTask& operator=(LookupTask&&) = delete;
+
+    ~LookupTask() {
+        if (handle) handle.destroy();
+    }
+
+    /**
+     * @brief Transfere o handle ao chamador (que passa a destruí-lo quando done()).
+     */
+    std::coroutine_handle<> release() { return std::exchange(handle, {}); }
+
+private:
+    explicit LookupTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * @brief Escalonador das buscas intercaladas de uma thread: fila de corrotinas prontas (round-robin) e
+ *        corrotinas suspensas à espera da leitura de um nó.
+ * @details yield() devolve a corrotina ao fim da fila (usado depois de um prefetch de um nó já em memória,
+ *          para que as demais buscas rodem enquanto a linha de cache chega); read() a estaciona até que
+ *          deliver() entregue o nó lido (ou nullptr se a leitura falhou).
+ * @tparam NodeT Tipo do nó entregue às corrotinas.
+ */
+template <class NodeT>
+class LookupScheduler {
+public:
+    struct Yield {
+        LookupScheduler& s;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { s.runnable.push_back(h); }
+        void await_resume() const noexcept {}
+    };
+
+    struct Read {
+        LookupScheduler& s;
+        int position;
+        NodeT* dest;
+        bool* ok;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { s.waiting.push_back({position, h, dest, ok}); }
+        void await_resume() const noexcept {}
+    };
+
+    Yield yield() { return Yield{*this}; }
+
+    /**
+     * @brief Suspende até a leitura do nó em position (já submetida) ser entregue em *dest; *ok indica sucesso.
+     */
+    Read read(int position, NodeT* dest, bool* ok) { return Read{*this, position, dest, ok}; }
+
+    void ready(std::coroutine_handle<> h) { runnable.push_back(h); }
+
+    bool hasRunnable() const { return !runnable.empty(); }
+    bool hasWaiting() const { return !waiting.empty(); }
+
+    std::coroutine_handle<> next() {
+        std::coroutine_handle<> h = runnable.front();
+        runnable.pop_front();
+        return h;
+    }
+
+    /**
+     * @brief Entrega o nó lido a todas as corrotinas que esperam por position e as torna prontas.
+     */
+    void deliver(int position, const NodeT* node) {
+        for (std::size_t i = 0; i < waiting.size();) {
+            Waiter& w = waiting[i];
+            if (w.position != position) {
+                ++i;
+                continue;
+            }
+            if (node) *w.dest = *node;
+            *w.ok = node != nullptr;
+            runnable.push_back(w.handle);
+            w = waiting.back();
+            waiting.pop_back();
+        }
+    }
+
+    /**
+     * @brief Acorda todas as corrotinas em espera como se a leitura tivesse falhado (*ok = false).
+     */
+    void failWaiting() {
+        for (const Waiter& w : waiting) {
+            *w.ok = false;
+            runnable.push_back(w.handle);
+        }
+        waiting.clear();
+    }
+
+private:
+    struct Waiter {
+        int position;
+        std::coroutine_handle<> handle;
+        NodeT* dest;
+        bool* ok;
+    };
+
+    std::deque<std::coroutine_handle<>> runnable;
+    std::vector<Waiter> waiting;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/**
+* @file KeyTypes.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef KEYTYPES_H
+#define KEYTYPES_H
+
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Tipo de chave gravado no header do índice.
+ * @details KEY_INT32 vale 0 para que índices anteriores (campo reservado zerado) continuem válidos.
+ */
+enum KeyType { KEY_INT32 = 0, KEY_INT64 = 1, KEY_FIXED_STRING = 2 };
+
+/**
+ * @brief Layout de uma chave no registro de nó: tipo, largura em bytes e alinhamento exigido.
+ */
+struct KeyLayout {
+    int type = KEY_INT32;
+    int bytes = 4;
+    int align = 4;
+};
+
+/**
+ * @brief Chave de texto de largura fixa (N bytes, completada com zeros).
+ * @details Ordenada byte a byte (memcmp, sem sinal), de modo que um prefixo vem antes das extensões
+ *          ("abc" < "abcd"). Textos maiores que N são truncados.
+ */
+template <int N>
+struct FixedString {
+    static_assert(N > 0, "FixedString precisa de ao menos 1 byte");
+
+    char bytes[N]{};
+
+    FixedString() = default;
+
+    FixedString(std::string_view s) {
+        std::memcpy(bytes, s.data(), s.size() < N ? s.size() : N);
+    }
+
+    /**
+     * @brief Texto sem os zeros finais.
+     */
+    std::string_view view() const {
+        std::size_t len = 0;
+        while (len < N && bytes[len] != '\0') len++;
+        return std::string_view(bytes, len);
+    }
+
+    friend bool operator==(const FixedString& a, const FixedString& b) {
+        return std::memcmp(a.bytes, b.bytes, N) == 0;
+    }
+
+    friend std::strong_ordering operator<=>(const FixedString& a, const FixedString& b) {
+        int c = std::memcmp(a.bytes, b.bytes, N);
+        return c < 0 ? std::strong_ordering::less : (c > 0 ? std::strong_ordering::greater : std::strong_ordering::equal);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const FixedString& s) {
+        return os << s.view();
+    }
+
+    friend std::istream& operator>>(std::istream& is, FixedString& s) {
+        std::string token;
+        if (is >> token) s = FixedString(token);
+        return is;
+    }
+};
+
+/**
+ * @brief Descrição em disco de cada tipo de chave aceito pelo índice (especializada por tipo).
+ */
+template <class Key>
+struct KeyTraits;
+
+template <>
+struct KeyTraits<std::int32_t> {
+    static constexpr KeyLayout layout{KEY_INT32, 4, 4};
+};
+
+template <>
+struct KeyTraits<std::int64_t> {
+    static constexpr KeyLayout layout{KEY_INT64, 8, 8};
+};
+
+template <int N>
+struct KeyTraits<FixedString<N>> {
+    static constexpr KeyLayout layout{KEY_FIXED_STRING, N, 1};
+};
+
+/**
+ * @brief Chave de texto usada na instanciação explícita do índice (16 bytes).
+ */
+using Key16 = FixedString<16>;
+
+#endif
@@ -10,44 +10,300 @@
 #ifndef MWAYTREE_H
 #define MWAYTREE_H
 
+#include <chrono>
+#include <cstddef>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <span>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <stack>
+#include "KeyTypes.h"
+#include "Node.h"
+#include "NodeCache.h"
+#include "NodeFormat.h"
+#include "IndexMap.h"
+#include "InterleavedLookup.h"
+#include "Metrics.h"
+#include "StorageBackend.h"
+#include "WriteAheadLog.h"
+#include <vector>
 
 using namespace std;
 
-const int MAX_M = 32;
+/**
+ * @brief Orçamento padrão de memória da ordenação na carga em lote (bytes).
+ */
+const std::size_t BULK_MEMORY_DEFAULT = std::size_t(64) << 20;
+
+/**
+ * @brief Política de escrita dos nós do índice.
+ * @details WriteThrough grava e faz flush a cada writeNode (mais durável); WriteBack acumula nós sujos
+ *          no cache e os grava apenas em despejos e em sync()/commit().
+ */
+enum class WriteMode { WriteThrough, WriteBack };
+
+/**
+ * @brief Uso do log de redo (WAL) do índice.
+ * @details Off: sem log (comportamento de WriteMode). FsyncPerOp: cada inserção/remoção é uma transação
+ *          atômica e durável ao retornar (um fdatasync por operação). GroupCommit: transações atômicas,
+ *          tornadas duráveis em grupo por commit() ou a cada setBatchSize(n) operações (um fdatasync por
+ *          grupo). Com WAL ativo, as páginas só vão ao índice depois de registradas no log (despejo do
+ *          cache ou checkpoint em sync()), independentemente de WriteMode.
+ */
+enum class WalMode { Off, FsyncPerOp, GroupCommit };
+
+/**
+ * @brief Tamanho do log a partir do qual uma operação dispara checkpoint (sync).
+ */
+const long long WAL_CHECKPOINT_BYTES = 64LL << 20;
+
+/**
+ * @brief Irmãos antecipados por rangeScan quando o backend de I/O sobrepõe leituras (io_uring).
+ */
+const int SCAN_PREFETCH_SIBLINGS = 4;
 
 /**
- * @brief Nó da árvore M-vias persistido no arquivo.
- * @details n = número de chaves válidas; keys[0..n-1] estritamente crescentes;
- *          children[0..n] são posições lógicas dos filhos (0 = inexistente).
- *          Posição 0 do arquivo é reservada ao header da árvore.
+ * @brief Contadores de I/O do índice desde o último reset.
+ * @details reads/writes são acessos físicos ao arquivo; cacheHits/cacheMisses contam as
+ *          consultas ao cache de nós (cada falta gera uma leitura física); mappedReads conta os nós
+ *          visitados direto no mapeamento (buscas com setMappedReads). bytesRead/bytesWritten são os bytes
+ *          físicos movidos; levels conta os níveis descidos; splits, merges, borrows e rootChanges contam as
+ *          mudanças estruturais (divisões, fusões, redistribuições entre irmãos e troca da raiz).
  */
-struct Node {
-    int n;
-    int keys[MAX_M];
-    int children[MAX_M+1];
+struct IndexCounters {
+    long long reads = 0;
+    long long writes = 0;
+    long long cacheHits = 0;
+    long long cacheMisses = 0;
+    long long mappedReads = 0;
+    long long bytesRead = 0;
+    long long bytesWritten = 0;
+    long long levels = 0;
+    long long splits = 0;
+    long long merges = 0;
+    long long borrows = 0;
+    long long rootChanges = 0;
+
+    IndexCounters& operator+=(const IndexCounters& o) {
+        reads += o.reads;
+        writes += o.writes;
+        cacheHits += o.cacheHits;
+        cacheMisses += o.cacheMisses;
+        mappedReads += o.mappedReads;
+        bytesRead += o.bytesRead;
+        bytesWritten += o.bytesWritten;
+        levels += o.levels;
+        splits += o.splits;
+        merges += o.merges;
+        borrows += o.borrows;
+        rootChanges += o.rootChanges;
+        return *this;
+    }
+
     /**
-     * @brief Constrói nó vazio (n=0) com arrays zerados.
+     * @brief Chama f(nome, valor) para cada contador (exportação).
      */
-    Node();
+    template <class F>
+    void forEach(F&& f) const {
+        f("reads", reads);
+        f("writes", writes);
+        f("cache_hits", cacheHits);
+        f("cache_misses", cacheMisses);
+        f("mapped_reads", mappedReads);
+        f("bytes_read", bytesRead);
+        f("bytes_written", bytesWritten);
+        f("levels", levels);
+        f("splits", splits);
+        f("merges", merges);
+        f("borrows", borrows);
+        f("root_changes", rootChanges);
+    }
 };
 
+/**
+ * @brief Fotografia das métricas por tipo de operação (busca, inserção, remoção) desde o último reset.
+ */
+struct TreeMetrics {
+    OperationMetrics<IndexCounters> search;
+    OperationMetrics<IndexCounters> insert;
+    OperationMetrics<IndexCounters> remove;
+};
+
+/**
+ * @brief Estatísticas de ocupação do índice.
+ */
+struct FreeSpaceStats {
+    int totalNodes = 0;     // posições alocadas no arquivo (inclui livres)
+    int freeNodes = 0;      // posições na lista de livres
+    long long fileBytes = 0;
+    long long freeBytes = 0;
+};
+
+template <class Key, class Compare, int MaxM>
+class TreeCursor;
+
+template <class Key, class Compare>
+class ExternalSorter;
+
 /**
  * @brief Árvore M-vias persistente com busca, inserção e remoção no arquivo binário.
- * @details Header no nó lógico 0 (n=-1, keys[0]=m, children[0]=root). Nós válidos começam na posição 1.
+ * @details Header versionado no início do arquivo (FileHeader: m, root, página, tipo da chave); nós válidos
+ *          começam na posição lógica 1 e cada registro é dimensionado pela ordem m e pela largura da chave
+ *          (ver NodeFormat). Key é o tipo da chave (int32_t, int64_t ou FixedString, ver KeyTraits), Compare a
+ *          ordem estrita entre chaves e MaxM a maior ordem aceita (capacidade do nó em memória; MAX_M é só o
+ *          padrão, ordens maiores pedem um MaxM maior). MWayTree.cpp instancia int32_t (o índice original,
+ *          mesmo formato de arquivo), int64_t e Key16 com std::less e MaxM = MAX_M; outras combinações de
+ *          Key/Compare/MaxM incluem MWayTree.tpp (definições da árvore, do cursor, do cache e do ordenador).
+ *          Um arquivo só abre com a instanciação do seu tipo de chave e de ordem m <= MaxM.
  */
+template <class Key = int, class Compare = std::less<Key>, int MaxM = MAX_M>
 class MWayTree {
+    static_assert(MaxM >= 3, "MaxM deve ser >= 3");
+    static_assert(sizeof(Key) == KeyTraits<Key>::layout.bytes, "largura da chave difere de KeyTraits");
+
+public:
+    /**
+     * @brief Nó desta instanciação (chaves Key, capacidade MaxM).
+     */
+    using Node = BasicNode<Key, MaxM>;
+
+    /**
+     * @brief true se as chaves de um Node em memória podem ser lidas pelos kernels SIMD (capacidade múltipla de 8).
+     */
+    static constexpr bool PADDED_NODE = MaxM % 8 == 0;
+
 private:
-    std::fstream file;
+    std::unique_ptr<StorageBackend> io = makeStorageBackend(IoBackend::Pread);
     std::string filename;
     int root;
     int m;
     long long idxReads = 0;
     long long idxWrites = 0;
+    NodeCache<Node> cache;
+    int pinnedRoot = 0;
+    NodeFormat fmt;
+    std::vector<char> ioBuf;
+    int nodeCount = 0;
+    int freeHead = 0;
+    int freeCount = 0;
+    WriteMode writeMode = WriteMode::WriteThrough;
+    bool headerDirty = false;
+    int batchSize = 0;
+    int opsSinceCommit = 0;
+    long long generation = 0;
+    IndexMap map;
+    bool mappedReads = false;
+    long long idxMapped = 0;
+    WriteAheadLog wal;
+    WalMode walMode = WalMode::Off;
+    std::vector<std::pair<int, Node>> txnPages;
+    bool txnHeader = false;
+    int recoveredTxns = 0;
+    long long idxBytesRead = 0;
+    long long idxBytesWritten = 0;
+    long long idxLevels = 0;
+    long long idxSplits = 0;
+    long long idxMerges = 0;
+    long long idxBorrows = 0;
+    long long idxRootChanges = 0;
+    TreeMetrics metrics;
+
+    /**
+     * @brief Leitura de nó em voo no backend de I/O (entrada livre com pos == 0); o índice no vetor é a tag.
+     */
+    struct NodeRead {
+        int pos = 0;
+        long long generation = 0;
+        std::vector<char> buf;
+    };
+    std::vector<NodeRead> nodeReads;
+    std::size_t readsInFlight = 0;
+    std::vector<IoCompletion> ioDone;
+
+    friend class Compactor;
+    template <class, class, int> friend class TreeCursor;
+    friend class ConcurrentTree;
+
+    /**
+     * @brief Escrita física do nó (sem flush).
+     * @param node Nó a gravar.
+     * @param position Posição lógica (1..N).
+     */
+    void storeNode(const Node& node, int position);
+
+    /**
+     * @brief Escrita física do header (sem flush).
+     */
+    void storeHeader();
+
+    /**
+     * @brief Fecha a operação corrente; em WriteBack executa commit() a cada batchSize operações.
+     *        Com WAL, registra a transação da operação e aplica a política de fdatasync.
+     */
+    void endOperation();
+
+    /**
+     * @brief Anexa ao WAL as páginas (e o header) alterados pela operação e os move para o cache como sujos.
+     */
+    void logOperation();
+
+    /**
+     * @brief fsync do arquivo do índice (descritor próprio, aberto sob demanda).
+     */
+    bool fsyncIndex();
+
+    /**
+     * @brief Caminho do WAL do índice aberto.
+     */
+    std::string walPath() const { return filename + ".wal"; }
+
+    /**
+     * @brief Descida de mSearch lendo os nós pelo mapeamento (IndexMap).
+     */
+    std::tuple<int, int, bool> mSearchMapped(const Key& key, stack<int>* branch, int* recPos);
+
+    /**
+     * @brief Descida de mSearch pelo cache de nós (ou pelo arquivo).
+     */
+    std::tuple<int, int, bool> mSearchCached(const Key& key, stack<int>* branch, int* recPos);
+
+    /**
+     * @brief Corrotina de uma busca de mSearchInterleaved: desce a árvore como mSearch, suspendendo-se em
+     *        cada nível (após antecipar a linha do nó em memória ou enquanto a leitura física está em voo).
+     * @param out Saída: (nodePos, slot, found), com a mesma semântica de mSearch.
+     * @param rec Saída: número do registro (inalterado se ausente).
+     */
+    LookupTask lookupTask(const Key& key, LookupScheduler<Node>& sched, bool mapped, std::tuple<int, int, bool>& out,
+                          int& rec);
+
+    /**
+     * @brief Acrescenta os contadores da operação corrente e a latência desde start às métricas de target.
+     */
+    void recordOperation(OperationMetrics<IndexCounters>& target, std::chrono::steady_clock::time_point start);
+
+    /**
+     * @brief Ordem entre chaves (Compare) e igualdade derivada dela.
+     */
+    static bool keyLess(const Key& a, const Key& b) { return Compare{}(a, b); }
+    static bool keyEqual(const Key& a, const Key& b) { return !Compare{}(a, b) && !Compare{}(b, a); }
+
+    /**
+     * @brief Inserção sem reset de contadores nem controle de lote.
+     * @param key Chave a inserir.
+     * @param recPos Número do registro da chave.
+     */
+    void insertKey(const Key& key, int recPos);
+
+    /**
+     * @brief Remoção sem reset de contadores nem controle de lote.
+     * @param key Chave a remover.
+     * @param recPos (Opcional) saída: ponteiro de registro da chave removida.
+     * @return true se a chave existia.
+     */
+    bool deleteKey(const Key& key, int* recPos);
 
     /**
      * @brief Persiste o nó na posição lógica indicada (>=1).
@@ -63,6 +319,12 @@ private:
      */
     int writeNode(const Node& node);
 
+    /**
+     * @brief Devolve a posição à lista de livres persistente (o nó passa a ter n=FREE_NODE).
+     * @param position Posição lógica liberada.
+     */
+    void freeNode(int position);
+
     /**
      * @brief Carrega o nó na posição lógica indicada.
      * @param position Posição lógica (1..N).
@@ -70,6 +332,59 @@ private:
      */
     Node readNode(int position);
 
+    /**
+     * @brief Nó já em memória: imagem da transação corrente ou entrada do cache (conta acerto/falta).
+     * @return false se for preciso ler o nó do arquivo.
+     */
+    bool readResident(int position, Node& out);
+
+    /**
+     * @brief Leitura física bloqueante do nó, que entra no cache.
+     */
+    Node loadNode(int position);
+
+    /**
+     * @brief Imagem atual do nó (transação corrente, cache ou arquivo) sem alterar o cache nem os contadores.
+     * @details Usada pelas leituras de diagnóstico (displayTree, exportToText, verifyIntegrity), que assim
+     *          enxergam os nós sujos e as operações ainda não levadas ao índice pelo checkpoint do WAL.
+     * @return false se o nó não puder ser lido do arquivo.
+     */
+    bool inspectNode(int position, Node& out) const;
+
+    /**
+     * @brief Enfileira no backend a leitura assíncrona do nó (no-op se ela já estiver em voo).
+     * @return false se a fila estiver cheia.
+     */
+    bool startRead(int position);
+
+    /**
+     * @brief Colhe ao menos minCompletions leituras em voo; cada nó lido entra no cache e é entregue a onNode
+     *        (nullptr se a leitura falhou ou se o nó foi alterado depois de ela ser submetida).
+     */
+    void completeReads(std::size_t minCompletions, const std::function<void(int position, const Node* node)>& onNode);
+
+    /**
+     * @brief Espera pela leitura em voo do nó, se houver.
+     * @return true se out recebeu o nó lido.
+     */
+    bool waitForRead(int position, Node& out);
+
+    /**
+     * @brief Colhe (e descarta) todas as leituras em voo.
+     */
+    void drainReads();
+
+    /**
+     * @brief Antecipa a leitura dos nós: com io_uring, ficam em voo e entram no cache ao serem colhidas
+     *        (readNode espera pela que precisar); com pread, apenas posix_fadvise(WILLNEED).
+     */
+    void prefetchNodes(std::span<const int> positions);
+
+    /**
+     * @brief Mantém o nó raiz fixado no cache (troca o pin quando a raiz muda).
+     */
+    void pinRoot();
+
     /**
      * @brief Atualiza o header com m e root correntes.
      */
@@ -77,7 +392,7 @@ private:
 
     /**
      * @brief Lê e valida o header ao abrir o arquivo.
-     * @return true se válido e compatível com limites [3..MAX_M].
+     * @return true se válido, com m em [3..MaxM] e chave do tipo Key.
      */
     bool loadAndValidateHeader();
 
@@ -102,6 +417,55 @@ private:
      */
     void fixUnderflow(int parentPos, int childIndex);
 
+    /**
+     * @brief Separador promovido ao pai por uma divisão em lote, com o novo nó à sua direita.
+     */
+    struct Promotion {
+        Key key;
+        int rec;
+        int right;
+    };
+
+    /**
+     * @brief Grava o conteúdo (chaves, registros, filhos) na posição pos (0 = nova); se exceder m-1 chaves,
+     *        divide em nós equilibrados e acrescenta em up os separadores promovidos.
+     * @return Posição do primeiro nó gravado.
+     */
+    int storeChunks(int pos, const std::vector<Key>& keys, const std::vector<int>& recs,
+                    const std::vector<int>& kids, std::vector<Promotion>& up);
+
+    /**
+     * @brief Inserção em lote na subárvore de pos: itens ordenados [lo, hi); promoções do nó vão para up.
+     */
+    void insertBatch(int pos, const std::vector<std::pair<Key,int>>& items, std::size_t lo, std::size_t hi,
+                     std::vector<Promotion>& up, std::size_t& inserted);
+
+    /**
+     * @brief Remoção em lote nas folhas da subárvore de node (nó já lido, alterado em memória).
+     * @details Chaves encontradas em nós internos vão para deferred; com leafOnly, uma chave igual à de um nó
+     *          interno desce pela subárvore esquerda (remove a cópia do antecessor na folha). Filhos em underflow
+     *          são rebalanceados uma vez por nó; o chamador grava node se o retorno for true.
+     * @return true se node foi alterado.
+     */
+    bool deleteBatch(Node& node, const std::vector<std::pair<Key,int>>& probes, std::size_t lo, std::size_t hi,
+                     bool leafOnly, std::vector<int>* deferred, std::vector<int>* recPos, std::size_t& removed);
+
+    /**
+     * @brief Filho carregado durante o rebalanceamento em lote (gravado uma vez, se alterado).
+     */
+    struct BatchChild {
+        int pos = 0;
+        Node node;
+        bool loaded = false;
+        bool dirty = false;
+    };
+
+    /**
+     * @brief Corrige, uma vez por nó, os filhos em underflow de node após uma remoção em lote.
+     * @return true se node foi alterado (o chamador o grava).
+     */
+    bool rebalanceChildren(Node& node, std::vector<BatchChild>& kids);
+
     /**
      * @brief Resultado interno da remoção recursiva.
      */
@@ -111,9 +475,10 @@ private:
      * @brief Remove chave recursivamente a partir de nodePos.
      * @param nodePos Posição do nó atual.
      * @param key Chave a remover.
+     * @param recPos (Opcional) saída: ponteiro de registro da chave removida.
      * @return Ok se removido, Underflow se nó ficou abaixo do mínimo, NotFound se chave ausente.
      */
-    DelResult deleteRecursive(int nodePos, int key);
+    DelResult deleteRecursive(int nodePos, const Key& key, int* recPos);
 
 public:
     /**
@@ -122,8 +487,8 @@ public:
     MWayTree();
 
     /**
-     * @brief Constrói árvore com ordem informada (ajustada para [3..MAX_M]).
-     * @param order Ordem desejada.
+     * @brief Constrói árvore com ordem informada (ajustada para [3..MaxM]).
+     * @param order Ordem desejada (ajustada para [3..MaxM]).
      */
     explicit MWayTree(int order);
 
@@ -132,6 +497,9 @@ public:
      */
     ~MWayTree();
 
+    MWayTree(const MWayTree&) = delete;
+    MWayTree& operator=(const MWayTree&) = delete;
+
     /**
      * @brief Abre o arquivo binário do índice e valida o header.
      * @param filename Caminho do .bin.
@@ -140,26 +508,115 @@ public:
     bool openBinary(const std::string& filename);
 
     /**
-     * @brief Fecha o arquivo e grava header atualizado.
+     * @brief Fecha o arquivo e grava header atualizado (e nós sujos pendentes).
      */
     void closeBinary();
 
+    /**
+     * @brief Seleciona a política de escrita; ao trocar de modo, pendências são gravadas antes.
+     * @param mode WriteThrough (padrão) ou WriteBack.
+     */
+    void setWriteMode(WriteMode mode);
+
+    WriteMode getWriteMode() const { return writeMode; }
+
+    /**
+     * @brief Ativa buscas (mSearch) direto no mapeamento do arquivo (mmap), sem cópia para o cache de nós.
+     * @details Em WriteBack, enquanto houver nós sujos no cache, mSearch volta ao caminho do cache.
+     * @param enabled true para ativar.
+     */
+    void setMappedReads(bool enabled);
+
+    bool getMappedReads() const { return mappedReads; }
+
+    /**
+     * @brief Seleciona o backend de I/O dos nós (pread ou io_uring); com o índice aberto, grava as pendências
+     *        e reabre o arquivo no novo backend.
+     * @param kind Backend desejado (Uring cai para Pread se indisponível, ver getIoBackend()).
+     * @return false se o arquivo não puder ser reaberto.
+     */
+    bool setIoBackend(IoBackend kind);
+
+    /**
+     * @brief Backend de I/O efetivo.
+     */
+    IoBackend getIoBackend() const { return io->kind(); }
+
+    /**
+     * @brief Contador de modificações (nós ou header gravados); usado para detectar alterações concorrentes.
+     */
+    long long getGeneration() const { return generation; }
+
+    /**
+     * @brief Caminho do índice aberto.
+     */
+    const std::string& getFilename() const { return filename; }
+
+    /**
+     * @brief Em WriteBack, executa commit() automaticamente a cada 'ops' inserções/remoções (0 = só explícito).
+     * @param ops Tamanho do lote em operações.
+     */
+    void setBatchSize(int ops);
+
+    /**
+     * @brief Grava no arquivo os nós sujos (em ordem de posição) e o header pendente, seguido de flush.
+     * @details Em WriteBack, deve ser chamado antes de leituras do arquivo por fora da árvore (Compactor,
+     *          IndexMap, outro processo). Com WAL é um checkpoint: fdatasync do log,
+     *          páginas no índice, fsync do índice e log esvaziado.
+     */
+    void sync();
+
+    /**
+     * @brief Ponto de commit de um lote de operações: torna duráveis as operações anteriores.
+     * @details Com WAL, apenas o fdatasync do log (commit em grupo); sem WAL, sync().
+     */
+    void commit();
+
+    /**
+     * @brief Ativa/desativa o WAL; ao trocar de modo faz checkpoint e fsync do índice.
+     * @param mode Off, FsyncPerOp ou GroupCommit (lote definido por setBatchSize; 0 = só commit()).
+     * @return false se o arquivo de log não puder ser aberto.
+     */
+    bool setWalMode(WalMode mode);
+
+    WalMode getWalMode() const { return walMode; }
+
+    /**
+     * @brief Transações do WAL reaplicadas na última abertura (recuperação após queda).
+     */
+    int getRecoveredTransactions() const { return recoveredTxns; }
+
+    /**
+     * @brief fdatasyncs feitos no WAL desde a abertura do log.
+     */
+    long long getWalSyncs() const { return wal.getSyncs(); }
+
+    /**
+     * @brief Destino das chaves lidas por createFromText: (chaves, quantidade), em ordem de arquivo; a i-ésima
+     *        chave entregue recebe o registro i. false interrompe a criação.
+     */
+    using KeySink = std::function<bool(const Key* keys, std::size_t count)>;
+
     /**
      * @brief Cria o índice a partir de um .txt (com validações e reachability).
      * @param textFilename Caminho do .txt de nós.
      * @param binFilename Caminho do .bin de saída.
-     * @param order Ordem m desejada (ajustada para [3..MAX_M]).
+     * @param order Ordem m desejada (ajustada para [3..MaxM]).
+     * @param pageSize Tamanho de página (0 = registros compactos; >0 deriva m da página).
+     * @param keySink (Opcional) recebe as chaves em ordem de arquivo, na mesma leitura (ex.: gerar data.bin).
      * @return true em caso de sucesso.
      */
-    static bool createFromText(const std::string& textFilename, const std::string& binFilename, int order);
+    static bool createFromText(const std::string& textFilename, const std::string& binFilename, int order,
+                               int pageSize = 0, const KeySink& keySink = {});
 
     /**
      * @brief Cria um índice vazio (apenas header) com raiz vazia.
      * @param binFilename Caminho do .bin de saída.
-     * @param order Ordem m desejada (ajustada para [3..MAX_M]).
+     * @param order Ordem m desejada (ajustada para [3..MaxM]).
+     * @param pageSize Tamanho de página (0 = registros compactos; >0 deriva m da página).
      * @return true em caso de sucesso.
      */
-    static bool createEmpty(const std::string& binFilename, int order);
+    static bool createEmpty(const std::string& binFilename, int order, int pageSize = 0);
 
     /**
      * @brief Lê o header de um .bin sem mantê-lo aberto.
@@ -178,10 +635,9 @@ public:
     bool exportToText(const std::string& textFilename) const;
 
     /**
-     * @brief Exibe nós alcançáveis a partir da raiz (BFS textual).
-     * @param binFilename Caminho do .bin (leitura independente).
+     * @brief Exibe nós alcançáveis a partir da raiz (BFS textual), inclusive os ainda não gravados no arquivo.
      */
-    void displayTree(const std::string& binFilename) const;
+    void displayTree() const;
 
     /**
      * @brief Cria a raiz em árvore vazia persistindo o nó informado.
@@ -193,23 +649,112 @@ public:
      * @brief Busca mSearch do topo até o alvo.
      * @param key Chave a buscar.
      * @param branch (Opcional) pilha com as posições dos nós visitados.
+     * @param recPos (Opcional) saída: número do registro em data.bin (NO_RECORD se desconhecido).
      * @return (nodePos, slot, found): se found=true, slot é 1-based do vetor keys;
      *         se found=false, slot é o índice do ponteiro de filho a seguir (ou posição de inserção).
      */
-    std::tuple<int, int, bool> mSearch(int key, stack<int>* branch = nullptr);
+    std::tuple<int, int, bool> mSearch(const Key& key, stack<int>* branch = nullptr, int* recPos = nullptr);
+
+    /**
+     * @brief Busca em lote: ordena as chaves e desce a árvore uma única vez, enviando a cada filho o grupo
+     *        de chaves que cai nele; cada nó é lido no máximo uma vez por lote. As leituras dos filhos ficam
+     *        em voo juntas no backend de I/O e cada conclusão continua a descida do seu grupo.
+     * @param keys Chaves a buscar (qualquer ordem; repetições permitidas).
+     * @param recPos (Opcional) saída: número do registro de cada chave (NO_RECORD se ausente/desconhecido).
+     * @return (nodePos, slot, found) de cada chave, na ordem de entrada, com a mesma semântica de mSearch.
+     *         getCounters() passa a conter o I/O agregado do lote.
+     */
+    std::vector<std::tuple<int, int, bool>> mSearchMany(std::span<const Key> keys, std::vector<int>* recPos = nullptr);
+
+    /**
+     * @brief Buscas intercaladas: cada chave é uma corrotina que desce a árvore e se suspende a cada nó;
+     *        width buscas correm juntas, de modo que a espera por um nó (falta de cache do processador ou
+     *        leitura física em voo) de uma é coberta pelo trabalho das outras.
+     * @details Diferente de mSearchMany, não ordena as chaves nem compartilha a descida: cada busca lê seus
+     *          nós como mSearch. As leituras físicas ficam em voo no backend de I/O (até IO_QUEUE_DEPTH).
+     * @param keys Chaves a buscar (qualquer ordem).
+     * @param recPos (Opcional) saída: número do registro de cada chave (NO_RECORD se ausente/desconhecido).
+     * @param width Buscas simultâneas (1 equivale a um laço de mSearch).
+     * @return (nodePos, slot, found) de cada chave, na ordem de entrada, com a mesma semântica de mSearch.
+     *         getCounters() passa a conter o I/O agregado das buscas.
+     */
+    std::vector<std::tuple<int, int, bool>> mSearchInterleaved(std::span<const Key> keys,
+                                                               std::vector<int>* recPos = nullptr,
+                                                               int width = INTERLEAVE_WIDTH);
+
+    /**
+     * @brief Visita em ordem crescente as chaves em [lo, hi] (varredura com TreeCursor).
+     * @param lo Limite inferior (inclusivo).
+     * @param hi Limite superior (inclusivo).
+     * @param visit Recebe (chave, registro); retornar false interrompe a varredura.
+     * @return Quantidade de chaves visitadas.
+     */
+    std::size_t rangeScan(const Key& lo, const Key& hi, const std::function<bool(const Key&, int)>& visit);
+
+    /**
+     * @brief Inserção em lote: ordena as entradas e aplica, em uma única leitura-modificação-escrita por
+     *        folha, todas as chaves destinadas a ela; divisões são feitas uma vez por nó afetado.
+     * @param entries Pares (chave, registro); chaves já existentes ou repetidas no lote são ignoradas
+     *        (vale a primeira ocorrência).
+     * @return Quantidade de chaves inseridas. Conta como uma operação (um commit/transação do WAL).
+     */
+    std::size_t insertMany(std::span<const std::pair<Key,int>> entries);
+
+    /**
+     * @brief Remoção em lote: remove de cada folha, de uma vez, as chaves do lote e rebalanceia os filhos de
+     *        cada nó afetado uma única vez (redistribuição ou fusão com o irmão).
+     * @details Chaves que estão em nós internos (fração ~1/m) são sobrescritas pelo antecessor, que é então
+     *          removido das folhas em um segundo passo em lote.
+     * @param keys Chaves a remover.
+     * @param recPos (Opcional) saída: registro de cada chave removida (NO_RECORD se ausente), na ordem de entrada.
+     * @return Quantidade de chaves removidas.
+     */
+    std::size_t deleteMany(std::span<const Key> keys, std::vector<int>* recPos = nullptr);
 
     /**
      * @brief Inserção bottom-up com splits e possível criação de nova raiz.
      * @param key Chave a inserir (duplicatas são ignoradas).
+     * @param recPos Número do registro da chave em data.bin (NO_RECORD se não houver).
+     */
+    void insertB(const Key& key, int recPos = NO_RECORD);
+
+    /**
+     * @brief Carga em lote bottom-up em uma árvore vazia a partir de pares (chave, registro).
+     * @param entries Pares (chave, número do registro) em qualquer ordem; chaves repetidas são ignoradas.
+     * @param fillFactor Fração de m-1 chaves por nó (0..1], respeitando o mínimo de nós não-raiz.
+     * @param memoryBudget Memória máxima da ordenação; acima disso usa merge sort externo.
+     * @return true em caso de sucesso; false se o índice não estiver aberto e vazio.
      */
-    void insertB(int key);
+    bool bulkLoad(const std::vector<std::pair<Key,int>>& entries, double fillFactor = 1.0,
+                  std::size_t memoryBudget = BULK_MEMORY_DEFAULT);
+
+    /**
+     * @brief Carga em lote a partir de uma fonte de pares (chave, registro), sem materializá-los em memória.
+     * @param source Função que preenche (chave, registro) e retorna false ao fim da entrada.
+     * @param fillFactor Fração de m-1 chaves por nó (0..1].
+     * @param memoryBudget Memória máxima da ordenação; acima disso usa merge sort externo.
+     * @return true em caso de sucesso.
+     * @details Ordena a entrada (ExternalSorter), calcula a distribuição de chaves por nível e grava cada
+     *          nó uma única vez, em sequência, à medida que fica completo: O(N/m) escritas de nós.
+     */
+    bool bulkLoad(const std::function<bool(Key&, int&)>& source, double fillFactor = 1.0,
+                  std::size_t memoryBudget = BULK_MEMORY_DEFAULT);
+
+    /**
+     * @brief Carga em lote a partir de pares já ordenados (ExternalSorter em que finish() já foi chamado).
+     * @param sorted Sequência ordenada; percorrida com rewind()/next() (repetidas já descartadas).
+     * @param fillFactor Fração de m-1 chaves por nó (0..1].
+     * @return true em caso de sucesso.
+     */
+    bool bulkLoad(ExternalSorter<Key, Compare>& sorted, double fillFactor = 1.0);
 
     /**
      * @brief Remoção com substituição por antecessor e correção de underflow; contrai a raiz se necessário.
      * @param key Chave a remover.
+     * @param recPos (Opcional) saída: ponteiro de registro da chave removida.
      * @return true se a chave existia e foi removida.
      */
-    bool deleteB(int key);
+    bool deleteB(const Key& key, int* recPos = nullptr);
 
     /**
      * @brief Zera contadores de I/O do índice.
@@ -218,19 +763,57 @@ public:
 
     /**
      * @brief Retorna contadores de I/O do índice.
-     * @return Par (leituras, escritas).
+     * @return Leituras/escritas físicas e acertos/faltas do cache de nós.
+     */
+    IndexCounters getCounters() const;
+
+    /**
+     * @brief Métricas acumuladas de mSearch, insertB e deleteB: contadores totais, da última operação e
+     *        histograma de latência de cada tipo.
+     * @details Operações em lote (insertMany, deleteMany, mSearchMany, mSearchInterleaved) e
+     *          bulkLoad não entram nas métricas; seus contadores seguem disponíveis em getCounters().
      */
-    std::pair<long long,long long> getCounters() const;
+    const TreeMetrics& getMetrics() const { return metrics; }
+
+    /**
+     * @brief Zera as métricas acumuladas.
+     */
+    void resetMetrics() { metrics = TreeMetrics{}; }
+
+    /**
+     * @brief Estatísticas de espaço: nós alocados, nós livres e bytes correspondentes.
+     */
+    FreeSpaceStats getFreeSpaceStats() const;
+
+    /**
+     * @brief Define a capacidade do cache de nós em número de nós (0 desativa).
+     * @param nodes Capacidade em nós.
+     */
+    void setCacheCapacity(std::size_t nodes);
+
+    /**
+     * @brief Define a capacidade do cache de nós a partir de um orçamento em bytes.
+     * @param bytes Orçamento de memória do cache.
+     */
+    void setCacheCapacityBytes(std::size_t bytes);
 
     /**
      * @brief Verifica a integridade estrutural da árvore alcançável a partir da raiz.
      * @param verbose Se true, imprime mensagens de diagnóstico.
      * @return true se todos os invariantes forem satisfeitos.
-     * @details Checa: header válido; alcance de todos os nós usados; chaves estritamente crescentes;
+     * @details Percorre o estado atual da árvore (nós sujos e transações do WAL ainda sem checkpoint incluídos).
+     *          Checa: header válido; alcance de todos os nós usados (ou presença na lista de livres);
+     *          chaves estritamente crescentes;
      *          faixas de valores por subárvore; filhos em intervalo válido; mínimo de chaves em nós não-raiz;
      *          consistência da raiz (vazia aponta 0, não-vazia aponta [1..N]).
      */
     bool verifyIntegrity(bool verbose = false) const;
 };
 
+// Instanciações em MWayTree.cpp: chaves int32, int64 e Key16 com std::less e MaxM = MAX_M;
+// para outro comparador ou outro MaxM, inclua MWayTree.tpp.
+extern template class MWayTree<std::int32_t>;
+extern template class MWayTree<std::int64_t>;
+extern template class MWayTree<Key16>;
+
 #endif
@@ -0,0 +1,2297 @@
+/**
+* @file MWayTree.tpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef MWAYTREE_TPP
+#define MWAYTREE_TPP
+
+#include "MWayTree.h"
+#include "ExternalSort.tpp"
+#include "NodeCache.tpp"
+#include "TreeCursor.tpp"
+#include "NodeSearch.h"
+#include "TextChunks.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stack>
+#include <queue>
+#include <unordered_set>
+#include <vector>
+#include <cctype>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+template <class Key, class Compare, int MaxM>
+MWayTree<Key, Compare, MaxM>::MWayTree() : filename(), root(0), m(3), cache(), fmt(NodeFormat::compact(3, FORMAT_VERSION, KeyTraits<Key>::layout)) {
+    cache.setWriteBack([this](int position, const Node& node) {
+        wal.sync(); // regra do WAL: o log cobre a página antes de ela ir ao índice
+        storeNode(node, position);
+    });
+}
+
+template <class Key, class Compare, int MaxM>
+MWayTree<Key, Compare, MaxM>::MWayTree(int order) : filename(), root(0), cache() {
+    if (order < 3) m = 3;
+    else if (order > MaxM) m = MaxM;
+    else m = order;
+    fmt = NodeFormat::compact(m, FORMAT_VERSION, KeyTraits<Key>::layout);
+    cache.setWriteBack([this](int position, const Node& node) {
+        wal.sync(); // regra do WAL: o log cobre a página antes de ela ir ao índice
+        storeNode(node, position);
+    });
+}
+
+template <class Key, class Compare, int MaxM>
+MWayTree<Key, Compare, MaxM>::~MWayTree() {
+    closeBinary();
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::resetCounters() {
+    idxReads = 0;
+    idxWrites = 0;
+    idxMapped = 0;
+    idxBytesRead = 0;
+    idxBytesWritten = 0;
+    idxLevels = 0;
+    idxSplits = 0;
+    idxMerges = 0;
+    idxBorrows = 0;
+    idxRootChanges = 0;
+    cache.resetCounters();
+}
+
+template <class Key, class Compare, int MaxM>
+IndexCounters MWayTree<Key, Compare, MaxM>::getCounters() const {
+    IndexCounters c;
+    c.reads = idxReads;
+    c.writes = idxWrites;
+    c.cacheHits = cache.getHits();
+    c.cacheMisses = cache.getMisses();
+    c.mappedReads = idxMapped;
+    c.bytesRead = idxBytesRead;
+    c.bytesWritten = idxBytesWritten;
+    c.levels = idxLevels;
+    c.splits = idxSplits;
+    c.merges = idxMerges;
+    c.borrows = idxBorrows;
+    c.rootChanges = idxRootChanges;
+    return c;
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::recordOperation(OperationMetrics<IndexCounters>& target,
+                                                   chrono::steady_clock::time_point start) {
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    target.record(getCounters(), static_cast<uint64_t>(ns));
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::setMappedReads(bool enabled) {
+    mappedReads = enabled;
+    if (!enabled) map.close();
+    else if (io->isOpen() && !map.isOpen() && map.open(filename, MaxM)) map.advise(IndexMap::Access::Random);
+}
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::setIoBackend(IoBackend kind) {
+    auto next = makeStorageBackend(kind);
+    if (io->isOpen()) {
+        drainReads();
+        sync();
+        if (!next->open(filename)) return false;
+    }
+    io = std::move(next);
+    return true;
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::setCacheCapacity(std::size_t nodes) {
+    cache.setCapacity(nodes);
+    pinnedRoot = 0;
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::setCacheCapacityBytes(std::size_t bytes) {
+    setCacheCapacity(NodeCache<Node>::nodesForBytes(bytes));
+}
+
+/**
+ * @brief Fixa a raiz atual no cache; a raiz anterior volta a ser despejável.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::pinRoot() {
+    if (pinnedRoot == root) return;
+    if (pinnedRoot != 0) cache.unpin(pinnedRoot);
+    pinnedRoot = cache.pin(root) ? root : 0;
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::setWriteMode(WriteMode mode) {
+    if (mode == writeMode) return;
+    sync();
+    writeMode = mode;
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::setBatchSize(int ops) {
+    batchSize = (ops < 0) ? 0 : ops;
+}
+
+/**
+ * @brief Grava no arquivo (sem flush) todos os nós sujos do cache e o header pendente.
+ * @details Com WAL: registra pendências fora de operação (header do closeBinary), fdatasync do log antes
+ *          das páginas, fsync do índice depois, e só então esvazia o log.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::sync() {
+    if (!io->isOpen()) return;
+    if (walMode != WalMode::Off) {
+        logOperation();
+        wal.sync();
+    }
+    cache.flushDirty();
+    if (headerDirty) {
+        storeHeader();
+        headerDirty = false;
+    }
+    if (walMode != WalMode::Off && fsyncIndex()) wal.reset();
+}
+
+/**
+ * @brief Fim de lote: torna duráveis as operações anteriores e reinicia a contagem do lote.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::commit() {
+    if (walMode != WalMode::Off) wal.sync();
+    else sync();
+    opsSinceCommit = 0;
+}
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::setWalMode(WalMode mode) {
+    if (mode == walMode) return true;
+    if (io->isOpen()) {
+        sync();
+        if (mode == WalMode::Off) {
+            walMode = mode;
+            wal.close();
+            std::remove(walPath().c_str());
+            return true;
+        }
+        if (!fsyncIndex() || (!wal.isOpen() && !wal.open(walPath()))) return false;
+    }
+    walMode = mode;
+    opsSinceCommit = 0;
+    return true;
+}
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::fsyncIndex() {
+    return io->sync();
+}
+
+/**
+ * @brief Contabiliza uma operação de escrita concluída; em WriteBack, fecha o lote ao atingir batchSize.
+ * @details Com WAL a operação vira uma transação no log; FsyncPerOp a torna durável já, GroupCommit a cada
+ *          batchSize operações. Log acima de WAL_CHECKPOINT_BYTES dispara checkpoint.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::endOperation() {
+    if (walMode != WalMode::Off) {
+        logOperation();
+        if (walMode == WalMode::FsyncPerOp) wal.sync();
+        else if (batchSize > 0 && ++opsSinceCommit >= batchSize) commit();
+        if (wal.size() >= WAL_CHECKPOINT_BYTES) sync();
+        return;
+    }
+    if (writeMode != WriteMode::WriteBack || batchSize == 0) return;
+    if (++opsSinceCommit >= batchSize) commit();
+}
+
+/**
+ * @brief Transação da operação: imagem de cada nó alterado e do header, commit com um único write();
+ *        depois as páginas entram no cache como sujas (o despejo faz fdatasync do log antes de gravá-las).
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::logOperation() {
+    if (txnPages.empty() && !txnHeader) return;
+    for (const auto& [pos, node] : txnPages) {
+        fmt.encode(node, ioBuf.data());
+        wal.logPage(fmt.offsetOf(pos), ioBuf.data(), fmt.stride);
+    }
+    if (txnHeader) {
+        char hdr[HEADER_BYTES];
+        fmt.encodeHeader(root, hdr, freeHead, freeCount);
+        wal.logPage(0, hdr, HEADER_BYTES);
+    }
+    wal.commitTxn();
+    for (const auto& [pos, node] : txnPages) cache.put(pos, node, true);
+    txnPages.clear();
+    txnHeader = false;
+    pinRoot();
+}
+
+/**
+ * @brief Escrita física do nó na sua posição (sem flush); usada pelo write-through e pelo write-back do cache.
+ * @param node Nó a gravar.
+ * @param position Posição lógica (1..N).
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::storeNode(const Node& node, int position) {
+    fmt.encode(node, ioBuf.data());
+    io->write(fmt.offsetOf(position), ioBuf.data(), static_cast<size_t>(fmt.stride));
+    idxWrites++;
+    idxBytesWritten += fmt.stride;
+}
+
+/**
+ * @brief Persiste o nó na posição lógica informada (>=1).
+ * @param node Nó a gravar.
+ * @param position Posição lógica (1..N).
+ * @details WriteThrough grava e faz flush imediatamente; WriteBack apenas marca o nó sujo no cache
+ *          (gravado no despejo ou no próximo sync()/commit()).
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::writeNode(const Node& node, int position) {
+    generation++;
+    if (walMode != WalMode::Off) {
+        for (auto& [pos, staged] : txnPages) {
+            if (pos == position) {
+                staged = node;
+                return;
+            }
+        }
+        txnPages.emplace_back(position, node);
+        return;
+    }
+    if (writeMode == WriteMode::WriteBack) {
+        cache.put(position, node, true);
+    } else {
+        storeNode(node, position);
+        cache.put(position, node, false);
+    }
+    if (position == root) pinRoot();
+}
+
+/**
+ * @brief Persiste o nó em uma nova posição: reutiliza o topo da lista de livres ou anexa ao final.
+ * @param node Nó a gravar.
+ * @return Posição lógica (1..N) atribuída ao nó.
+*/
+template <class Key, class Compare, int MaxM>
+int MWayTree<Key, Compare, MaxM>::writeNode(const Node& node){
+    int position;
+    if (freeHead != 0) {
+        position = freeHead;
+        Node f = readNode(position);
+        freeHead = f.children[0];
+        freeCount--;
+        updateHeader();
+    } else {
+        position = ++nodeCount;
+    }
+    writeNode(node, position);
+    return position;
+}
+
+/**
+ * @brief Empilha a posição na lista de livres: grava o nó marcado (n=FREE_NODE, children[0]=próximo) e o header.
+ * @param position Posição lógica liberada.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::freeNode(int position) {
+    Node f{};
+    f.n = FREE_NODE;
+    f.children[0] = freeHead;
+    writeNode(f, position);
+    freeHead = position;
+    freeCount++;
+    updateHeader();
+}
+
+template <class Key, class Compare, int MaxM>
+FreeSpaceStats MWayTree<Key, Compare, MaxM>::getFreeSpaceStats() const {
+    FreeSpaceStats st;
+    st.totalNodes = nodeCount;
+    st.freeNodes = freeCount;
+    st.fileBytes = fmt.dataStart + static_cast<long long>(nodeCount) * fmt.stride;
+    st.freeBytes = static_cast<long long>(freeCount) * fmt.stride;
+    return st;
+}
+
+/**
+ * @brief Carrega o nó na posição lógica indicada, consultando primeiro o cache de nós.
+ * @param position Posição lógica (1..N).
+ * @return Nó do cache, de uma leitura antecipada em voo ou carregado da mídia.
+ */
+template <class Key, class Compare, int MaxM>
+BasicNode<Key, MaxM> MWayTree<Key, Compare, MaxM>::readNode(int position) {
+    Node node{};
+    if (readResident(position, node)) return node;
+    if (readsInFlight > 0 && waitForRead(position, node)) return node;
+    return loadNode(position);
+}
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::readResident(int position, Node& out) {
+    for (const auto& [pos, staged] : txnPages) {
+        if (pos == position) {
+            out = staged;
+            return true;
+        }
+    }
+    return cache.get(position, out);
+}
+
+template <class Key, class Compare, int MaxM>
+BasicNode<Key, MaxM> MWayTree<Key, Compare, MaxM>::loadNode(int position) {
+    Node node{};
+    io->read(fmt.offsetOf(position), ioBuf.data(), static_cast<size_t>(fmt.stride));
+    fmt.decode(ioBuf.data(), node);
+    idxReads++;
+    idxBytesRead += fmt.stride;
+    cache.put(position, node, false);
+    if (position == root) pinRoot();
+    return node;
+}
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::inspectNode(int position, Node& out) const {
+    for (const auto& [pos, staged] : txnPages) {
+        if (pos == position) {
+            out = staged;
+            return true;
+        }
+    }
+    if (const Node* cached = cache.peek(position)) {
+        out = *cached;
+        return true;
+    }
+    vector<char> buf(static_cast<size_t>(fmt.stride));
+    if (!io->read(fmt.offsetOf(position), buf.data(), buf.size())) return false;
+    out = Node{};
+    fmt.decode(buf.data(), out);
+    return true;
+}
+
+/**
+ * @brief Reserva uma entrada de nodeReads (tag = índice) e enfileira a leitura; a geração registrada
+ *        permite descartar a imagem se o nó for gravado antes da conclusão.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::startRead(int position) {
+    if (nodeReads.size() < IO_QUEUE_DEPTH) nodeReads.resize(IO_QUEUE_DEPTH);
+    NodeRead* slot = nullptr;
+    for (NodeRead& r : nodeReads) {
+        if (r.pos == position) return true;
+        if (r.pos == 0 && !slot) slot = &r;
+    }
+    if (!slot) return false;
+    slot->buf.resize(static_cast<size_t>(fmt.stride));
+    IoRequest req{fmt.offsetOf(position), slot->buf.data(), static_cast<uint32_t>(fmt.stride),
+                  static_cast<uint64_t>(slot - nodeReads.data())};
+    if (!io->queueRead(req)) return false;
+    slot->pos = position;
+    slot->generation = generation;
+    readsInFlight++;
+    return true;
+}
+
+/**
+ * @brief Conclusões na ordem em que o backend as entrega; a leitura física é contada aqui (na operação que
+ *        a colhe). Só imagens ainda atuais entram no cache, sem sobrescrever uma entrada existente.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::completeReads(size_t minCompletions,
+                                                 const function<void(int position, const Node* node)>& onNode) {
+    if (readsInFlight == 0) return;
+    ioDone.clear();
+    io->wait(ioDone, minCompletions);
+    for (const IoCompletion& c : ioDone) {
+        NodeRead& slot = nodeReads[c.tag];
+        int position = slot.pos;
+        slot.pos = 0;
+        readsInFlight--;
+        bool fresh = c.result == fmt.stride && slot.generation == generation;
+        Node node{};
+        if (fresh) {
+            fmt.decode(slot.buf.data(), node);
+            idxReads++;
+            idxBytesRead += fmt.stride;
+            if (!cache.contains(position)) {
+                cache.put(position, node, false);
+                if (position == root) pinRoot();
+            }
+        }
+        if (onNode) onNode(position, fresh ? &node : nullptr);
+    }
+}
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::waitForRead(int position, Node& out) {
+    auto inFlight = [&] {
+        for (const NodeRead& r : nodeReads) if (r.pos == position) return true;
+        return false;
+    };
+    bool got = false;
+    while (!got && inFlight()) {
+        completeReads(1, [&](int pos, const Node* node) {
+            if (pos != position || !node) return;
+            out = *node;
+            got = true;
+        });
+    }
+    return got;
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::drainReads() {
+    while (readsInFlight > 0) completeReads(readsInFlight, nullptr);
+}
+
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::prefetchNodes(span<const int> positions) {
+    if (!io->isOpen()) return;
+    if (!io->overlaps()) {
+        for (int p : positions) io->advise(fmt.offsetOf(p), static_cast<size_t>(fmt.stride));
+        return;
+    }
+    if (cache.capacity() == 0) return;
+    bool queued = false;
+    for (int p : positions) {
+        if (cache.contains(p)) continue;
+        if (!startRead(p)) break;
+        queued = true;
+    }
+    if (queued) io->submit();
+}
+
+/**
+ * @brief Atualiza o header com m e root atuais (em WriteBack, apenas marca o header como pendente).
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::updateHeader() {
+    if (!io->isOpen()) return;
+    generation++;
+    if (walMode != WalMode::Off) {
+        headerDirty = true;
+        txnHeader = true;
+        return;
+    }
+    if (writeMode == WriteMode::WriteBack) {
+        headerDirty = true;
+        return;
+    }
+    storeHeader();
+}
+
+/**
+ * @brief Grava o header no início do arquivo (sem flush).
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::storeHeader() {
+    char hdr[HEADER_BYTES];
+    fmt.encodeHeader(root, hdr, freeHead, freeCount);
+    io->write(0, hdr, HEADER_BYTES);
+}
+
+/**
+ * @brief Lê e valida o header do arquivo aberto; adota o layout (ordem, página) nele descrito.
+ * @return true se header válido (magic/versão corretos, 3<=m<=MaxM, chave do tipo Key).
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::loadAndValidateHeader() {
+    char hdr[HEADER_BYTES];
+    if (!io->isOpen() || !io->read(0, hdr, HEADER_BYTES)) return false;
+    NodeFormat f;
+    FileHeader fh{};
+    if (!NodeFormat::decodeHeader(hdr, f, fh, MaxM)) return false;
+    if (f.keyType != KeyTraits<Key>::layout.type || f.keyBytes != KeyTraits<Key>::layout.bytes) {
+        return false;
+    }
+    fmt = f;
+    ioBuf.assign(static_cast<size_t>(fmt.stride), 0);
+    m = fmt.m;
+    root = fh.root;
+    freeHead = fh.freeHead;
+    freeCount = fh.freeCount;
+    nodeCount = fmt.positionsIn(io->size());
+    headerDirty = false;
+    return true;
+}
+
+/**
+ * @brief Abre o arquivo binário do índice e valida header.
+ * @param filename_ Caminho do arquivo.
+ * @return true se aberto e válido.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::openBinary(const string& filename_) {
+    filename = filename_;
+    cache.clear();
+    pinnedRoot = 0;
+    txnPages.clear();
+    txnHeader = false;
+    recoveredTxns = WriteAheadLog::replay(walPath(), filename);
+    if (recoveredTxns < 0) return false;
+    if (!io->open(filename)) return false;
+    if (!loadAndValidateHeader() || (walMode != WalMode::Off && !wal.open(walPath()))) {
+        io->close();
+        return false;
+    }
+    if (mappedReads && map.open(filename, MaxM)) map.advise(IndexMap::Access::Random);
+    return true;
+}
+
+/**
+ * @brief Fecha o arquivo e persiste o header.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::closeBinary() {
+    if (io->isOpen()) {
+        drainReads();
+        updateHeader();
+        sync();
+        io->close();
+    }
+    if (wal.isOpen()) {
+        wal.close();
+        std::remove(walPath().c_str());
+    }
+    map.close();
+    cache.clear();
+    pinnedRoot = 0;
+}
+
+namespace mways_detail {
+
+/**
+ * @brief Primeiro erro de formato de um bloco do .txt de nós (mensagem montada com a linha global).
+ */
+enum class TextError { None, Header, Order, MissingPair, NotIncreasing, ExtraTokens };
+
+inline void reportTextError(TextError e, int n, long long line, int order) {
+    switch (e) {
+    case TextError::Header:
+        cerr << "Erro ao ler n e A0 na linha " << line << " do arquivo texto." << endl;
+        break;
+    case TextError::Order:
+        cerr << "Valor de n invalido (n=" << n << ") na linha " << line << ". m=" << order << endl;
+        break;
+    case TextError::MissingPair:
+        cerr << "Par Ki/Ai faltando na linha " << line << " (esperado " << n << " pares)." << endl;
+        break;
+    case TextError::NotIncreasing:
+        cerr << "Chaves devem ser estritamente crescentes (linha " << line << ")." << endl;
+        break;
+    case TextError::ExtraTokens:
+        cerr << "Tokens extras apos Kn/An na linha " << line << "." << endl;
+        break;
+    case TextError::None:
+        break;
+    }
+}
+
+/**
+ * @brief Filho não nulo de um nó lido do .txt (slot = índice i de Ai).
+ */
+struct TextEdge {
+    int slot;
+    int child;
+};
+
+/**
+ * @brief Nós de um bloco do .txt, já codificados, com registros numerados a partir de 0 no bloco.
+ */
+template <class Key>
+struct TextNodeChunk {
+    std::vector<char> bytes;
+    std::vector<Key> keys;      // chaves em ordem de registro (apenas com keySink)
+    std::vector<TextEdge> edges;
+    std::vector<int> edgeCount; // filhos não nulos de cada nó do bloco
+    long long keyCount = 0;
+    int lines = 0;
+    int errorLine = 0;
+    int errorN = 0;
+    TextError error = TextError::None;
+};
+
+} // namespace mways_detail
+
+/**
+ * @brief Cria binário a partir de texto com validações (ordem, filhos, alcance).
+ * @details O .txt é mapeado e interpretado em blocos paralelos (TextChunks, from_chars); cada rodada é
+ *          gravada em ordem em binFilename.tmp, renomeado para binFilename apenas se todas as validações
+ *          passarem. Além dos blocos da rodada, só os filhos não nulos de cada nó ficam em memória, para a
+ *          verificação de faixa e a BFS de alcance ao final.
+ * @param textFilename Caminho do .txt de entrada.
+ * @param binFilename Caminho do .bin de saída.
+ * @param order Ordem m desejada (ajustada para [3..MaxM]).
+ * @param pageSize Tamanho de página (0 = registros compactos; >0 deriva m da página).
+ * @param keySink (Opcional) recebe as chaves de cada bloco, em ordem, logo após a gravação dos seus nós.
+ * @return true se criado com sucesso.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::createFromText(const string& textFilename, const string& binFilename, int order, int pageSize,
+                                                  const KeySink& keySink) {
+    using namespace mways_detail;
+    const KeyLayout key = KeyTraits<Key>::layout;
+    int effOrder = (order < 3 ? 3 : (order > MaxM ? MaxM : order));
+    if (pageSize > 0) effOrder = NodeFormat::orderForPage(pageSize, key, MaxM);
+    if (effOrder == 0) return false;
+    NodeFormat f = (pageSize > 0) ? NodeFormat::paged(effOrder, pageSize, FORMAT_VERSION, key)
+                                  : NodeFormat::compact(effOrder, FORMAT_VERSION, key);
+    vector<char> buf(static_cast<size_t>(max<long long>(f.dataStart, f.stride)));
+
+    // Cada linha ("0 0" no mínimo) vira um registro de stride bytes: blocos menores para registros maiores.
+    const size_t chunkBytes = clamp<size_t>(TEXT_CHUNK_BYTES * 64 / static_cast<size_t>(f.stride), size_t(64) << 10,
+                                            TEXT_CHUNK_BYTES);
+    TextChunks text(0, chunkBytes);
+    if (!text.open(textFilename)) return false;
+
+    const string tmpFilename = binFilename + ".tmp";
+    ofstream binFile(tmpFilename, ios::binary | ios::trunc);
+    if (!binFile.is_open()) return false;
+    auto fail = [&]() {
+        binFile.close();
+        std::remove(tmpFilename.c_str());
+        return false;
+    };
+    f.encodeHeader(0, buf.data());
+    binFile.write(buf.data(), f.dataStart);
+
+    vector<TextNodeChunk<Key>> parsed(static_cast<size_t>(text.threads()));
+    vector<string_view> chunks;
+    vector<long long> recBase(parsed.size());
+    vector<TextEdge> edges;
+    vector<long long> firstEdge{0};
+    long long lineBase = 0;
+    long long nextRec = 0;
+    while (size_t count = text.nextRound(chunks)) {
+        TextChunks::parallelFor(count, [&](size_t c) {
+            TextNodeChunk<Key>& tc = parsed[c];
+            tc.bytes.clear();
+            tc.keys.clear();
+            tc.edges.clear();
+            tc.edgeCount.clear();
+            tc.keyCount = 0;
+            tc.lines = 0;
+            tc.error = TextError::None;
+            auto stop = [&](TextError e, int n) {
+                tc.error = e;
+                tc.errorN = n;
+                tc.errorLine = tc.lines;
+            };
+            string_view rest = chunks[c], line;
+            while (nextLine(rest, line)) {
+                ++tc.lines;
+                Node node{};
+                int a0 = 0;
+                if (blankLine(line)) continue;
+                if (!extractValue(line, node.n) || !extractValue(line, a0)) {
+                    return stop(TextError::Header, 0);
+                }
+                if (node.n < 0 || node.n > effOrder - 1) return stop(TextError::Order, node.n);
+                node.children[0] = a0;
+                for (int i = 0; i < node.n; ++i) {
+                    int ai = 0;
+                    if (!extractValue(line, node.keys[i]) || !extractValue(line, ai)) {
+                        return stop(TextError::MissingPair, node.n);
+                    }
+                    if (i > 0 && !keyLess(node.keys[i - 1], node.keys[i])) return stop(TextError::NotIncreasing, 0);
+                    node.recs[i] = static_cast<int>(tc.keyCount++);
+                    node.children[i + 1] = ai;
+                }
+                Key extraProbe{};
+                if (extractValue(line, extraProbe)) return stop(TextError::ExtraTokens, 0);
+                if (keySink) tc.keys.insert(tc.keys.end(), node.keys, node.keys + node.n);
+
+                int edgeCount = 0;
+                for (int i = 0; i <= node.n; ++i) {
+                    if (node.children[i] == 0) continue;
+                    tc.edges.push_back({i, node.children[i]});
+                    edgeCount++;
+                }
+                tc.edgeCount.push_back(edgeCount);
+                size_t at = tc.bytes.size();
+                tc.bytes.resize(at + static_cast<size_t>(f.stride));
+                f.encode(node, tc.bytes.data() + at);
+            }
+        });
+
+        size_t ready = 0;
+        for (; ready < count && parsed[ready].error == TextError::None; ++ready) {
+            recBase[ready] = nextRec;
+            nextRec += parsed[ready].keyCount;
+            lineBase += parsed[ready].lines;
+        }
+        if (ready < count) {
+            const TextNodeChunk<Key>& tc = parsed[ready];
+            reportTextError(tc.error, tc.errorN, lineBase + tc.errorLine, effOrder);
+            return fail();
+        }
+        // Registros numerados em ordem de arquivo: soma a base do bloco ao número local.
+        TextChunks::parallelFor(count, [&](size_t c) {
+            if (recBase[c] == 0) return;
+            for (size_t at = 0; at < parsed[c].bytes.size(); at += static_cast<size_t>(f.stride)) {
+                char* rec = parsed[c].bytes.data() + at;
+                int n = 0;
+                memcpy(&n, rec, 4);
+                for (int i = 0; i < n; ++i) {
+                    int r = 0;
+                    memcpy(&r, rec + f.recOffset + 4 * i, 4);
+                    r += static_cast<int>(recBase[c]);
+                    memcpy(rec + f.recOffset + 4 * i, &r, 4);
+                }
+            }
+        });
+        for (size_t c = 0; c < count; ++c) {
+            const TextNodeChunk<Key>& tc = parsed[c];
+            binFile.write(tc.bytes.data(), static_cast<streamsize>(tc.bytes.size()));
+            if (keySink && !keySink(tc.keys.data(), tc.keys.size())) return fail();
+            edges.insert(edges.end(), tc.edges.begin(), tc.edges.end());
+            for (int e : tc.edgeCount) firstEdge.push_back(firstEdge.back() + e);
+        }
+        if (!binFile) return fail();
+    }
+    text.close();
+
+    const int N = static_cast<int>(firstEdge.size() - 1);
+    if (N == 0) {
+        binFile.close();
+        return !binFile.fail() && std::rename(tmpFilename.c_str(), binFilename.c_str()) == 0;
+    }
+
+    for (int pos = 1; pos <= N; ++pos) {
+        for (long long e = firstEdge[pos - 1]; e < firstEdge[pos]; ++e) {
+            int c = edges[e].child;
+            if (c < 1 || c > N) {
+                cerr << "Filho fora do intervalo (A" << edges[e].slot << "=" << c << ") no no " << pos
+                     << ". Valido: 0 ou [1.." << N << "]." << endl;
+                return fail();
+            }
+        }
+    }
+
+    vector<char> vis(N + 1, 0);
+    queue<int> q;
+    q.push(1); vis[1] = 1;
+    while (!q.empty()) {
+        int pos = q.front(); q.pop();
+        for (long long e = firstEdge[pos - 1]; e < firstEdge[pos]; ++e) {
+            int c = edges[e].child;
+            if (!vis[c]) { vis[c] = 1; q.push(c); }
+        }
+    }
+    for (int pos = 1; pos <= N; ++pos) {
+        if (!vis[pos]) {
+            cerr << "No " << pos << " nao alcancavel a partir da raiz (1). Arquivo inconsistente." << endl;
+            return fail();
+        }
+    }
+
+    f.encodeHeader(1, buf.data());
+    binFile.seekp(0, ios::beg);
+    binFile.write(buf.data(), f.dataStart);
+    binFile.close();
+    if (binFile.fail()) {
+        std::remove(tmpFilename.c_str());
+        return false;
+    }
+    return std::rename(tmpFilename.c_str(), binFilename.c_str()) == 0;
+}
+
+/**
+ * @brief Cria índice vazio com header e root=0.
+ * @param binFilename Caminho do .bin de saída.
+ * @param order Ordem m desejada (ajustada para [3..MaxM]); ignorada se pageSize > 0.
+ * @param pageSize Tamanho de página (0 = registros compactos; >0 deriva m da página).
+ * @return true em caso de sucesso.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::createEmpty(const std::string& binFilename, int order, int pageSize) {
+    const KeyLayout key = KeyTraits<Key>::layout;
+    int ord = (order < 3 ? 3 : (order > MaxM ? MaxM : order));
+    if (pageSize > 0) ord = NodeFormat::orderForPage(pageSize, key, MaxM);
+    if (ord == 0) return false;
+    NodeFormat f = (pageSize > 0) ? NodeFormat::paged(ord, pageSize, FORMAT_VERSION, key)
+                                  : NodeFormat::compact(ord, FORMAT_VERSION, key);
+    ofstream bin(binFilename, ios::binary | ios::trunc);
+    if (!bin.is_open()) return false;
+    vector<char> hdr(static_cast<size_t>(f.dataStart));
+    f.encodeHeader(0, hdr.data());
+    bin.write(hdr.data(), f.dataStart);
+    bin.flush();
+    bin.close();
+    return true;
+}
+
+/**
+ * @brief Lê header sem manter arquivo aberto.
+ * @param binFilename Caminho do .bin.
+ * @param outM Saída: ordem m.
+ * @param outRoot Saída: posição da raiz.
+ * @return true se header válido.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::readHeader(const std::string& binFilename, int& outM, int& outRoot) {
+    IndexMap im;
+    if (!im.open(binFilename, MaxM)) return false;
+    outM = im.format().m;
+    outRoot = im.header().root;
+    return true;
+}
+
+/**
+ * @brief Exporta índice para .txt (exclui o header), incluindo nós ainda não gravados no arquivo.
+ * @param textFilename Caminho do .txt de saída.
+ * @return true em caso de sucesso.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::exportToText(const std::string& textFilename) const {
+    if (!io->isOpen()) return false;
+
+    ofstream txt(textFilename, ios::trunc);
+    if (!txt.is_open()) return false;
+
+    Node node;
+    for (int pos = 1; pos <= nodeCount; ++pos) {
+        if (!inspectNode(pos, node)) return false;
+        if (node.n == FREE_NODE) {
+            txt << "0 0\n"; // nó livre: exportado como vazio, preservando as posições
+            continue;
+        }
+        txt << node.n << " " << node.children[0];
+        for (int i = 0; i < node.n; ++i) {
+            txt << " " << node.keys[i] << " " << node.children[i + 1];
+        }
+        txt << "\n";
+    }
+
+    txt.close();
+    return true;
+}
+
+/**
+ * @brief Exibe nós alcançáveis a partir da raiz (BFS) em formato legível.
+ * @details Lê os nós pela mesma visão das operações (cache e WAL), sem esperar pelo checkpoint.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::displayTree() const {
+    cout << "T = " << root << ", m = " << m << endl;
+    cout << "------------------------------------------------------------------" << endl;
+    cout << "No n,A[0],(K[1],A[1]),...,(K[n],A[n])" << endl;
+    cout << "------------------------------------------------------------------" << endl;
+
+    if (root == 0) {
+        cout << "(arvore vazia)" << endl;
+        cout << "------------------------------------------------------------------" << endl;
+        return;
+    }
+
+    queue<int> q;
+    unordered_set<int> vis;
+    q.push(root);
+    vis.insert(root);
+
+    while (!q.empty()) {
+        int pos = q.front(); q.pop();
+        Node node;
+        if (!inspectNode(pos, node) || node.n < 0 || node.n > m - 1) continue;
+
+        cout << setw(2) << pos << " " << node.n << ", " << setw(2) << node.children[0];
+        for (int i = 0; i < node.n; i++) {
+            cout << ",(" << setw(2) << node.keys[i] << ", " << setw(2) << node.children[i + 1] << ")";
+        }
+        cout << endl;
+
+        for (int i = 0; i <= node.n; ++i) {
+            int c = node.children[i];
+            if (c != 0 && !vis.count(c)) {
+                vis.insert(c);
+                q.push(c);
+            }
+        }
+    }
+
+    cout << "------------------------------------------------------------------" << endl;
+}
+
+/**
+ * @brief Cria a raiz em árvore vazia e persiste no arquivo.
+ * @param node Nó a persistir como raiz.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::createRoot(const Node& node){
+    int pos = writeNode(node);
+    root = pos;
+    idxRootChanges++;
+    pinRoot();
+    updateHeader();
+}
+
+/**
+ * @brief Busca mSearch: desce a árvore comparando chaves até encontrar ou determinar posição.
+ * @param key Chave a buscar.
+ * @param branch (Opcional) pilha com as posições dos nós visitados (topo = último visitado).
+ * @param recPos (Opcional) saída: número do registro em data.bin se encontrada (NO_RECORD se desconhecido).
+ * @return (nodePos, slot, found): se found=true, slot é 1-based do vetor keys;
+ *         se found=false, slot é o índice do ponteiro de filho a seguir (e posição de inserção).
+ */
+template <class Key, class Compare, int MaxM>
+tuple<int, int, bool> MWayTree<Key, Compare, MaxM>::mSearch(const Key& key, stack<int>* branch, int* recPos) {
+    if (!io->isOpen() || root == 0) return make_tuple(0, 0, false);
+
+    auto start = chrono::steady_clock::now();
+    resetCounters();
+    tuple<int, int, bool> result;
+    if (mappedReads && map.isOpen() && cache.dirtyCount() == 0 && !headerDirty) {
+        result = mSearchMapped(key, branch, recPos);
+    } else {
+        result = mSearchCached(key, branch, recPos);
+    }
+    recordOperation(metrics.search, start);
+    return result;
+}
+
+/**
+ * @brief Descida de mSearch por readNode (cache de nós ou leitura física).
+ */
+template <class Key, class Compare, int MaxM>
+tuple<int, int, bool> MWayTree<Key, Compare, MaxM>::mSearchCached(const Key& key, stack<int>* branch, int* recPos) {
+    int current = root;
+    if (branch) branch->push(current);
+
+    while (current != 0) {
+        Node node = readNode(current);
+        idxLevels++;
+
+        int i = nodeSlot(node, key, Compare{});
+
+        if (i < node.n && keyEqual(key, node.keys[i])) {
+            if (recPos) *recPos = node.recs[i];
+            return make_tuple(current, i + 1, true);
+        }
+
+        if (node.children[i] == 0) {
+            return make_tuple(current, i, false);
+        }
+
+        current = node.children[i];
+        if (branch) branch->push(current);
+    }
+
+    return make_tuple(0, 0, false);
+}
+
+/**
+ * @brief mSearch sobre o mapeamento: mesma descida, lendo cada nó por NodeView (sem cópia nem cache).
+ * @details Coerente com as escritas do backend de I/O (MAP_SHARED); chamada apenas sem nós sujos pendentes.
+ */
+template <class Key, class Compare, int MaxM>
+tuple<int, int, bool> MWayTree<Key, Compare, MaxM>::mSearchMapped(const Key& key, stack<int>* branch, int* recPos) {
+    int current = root;
+    if (branch) branch->push(current);
+
+    while (current != 0) {
+        BasicNodeView<Key> node;
+        if (!map.view(current, node)) break;
+        idxMapped++;
+        idxLevels++;
+
+        int i = IndexMap::slotOf(node, key, Compare{});
+
+        if (i < node.n && keyEqual(key, node.keys[i])) {
+            if (recPos) *recPos = node.recs ? node.recs[i] : NO_RECORD;
+            return make_tuple(current, i + 1, true);
+        }
+
+        if (node.children[i] == 0) {
+            return make_tuple(current, i, false);
+        }
+
+        current = node.children[i];
+        if (branch) branch->push(current);
+    }
+
+    return make_tuple(0, 0, false);
+}
+
+/**
+ * @brief Busca em lote com descida compartilhada.
+ * @details Ordena os índices das chaves por chave e percorre a árvore com uma pilha explícita de
+ *          (nó, faixa de chaves ordenadas). Em cada nó, o slot avança monotonicamente junto com as chaves
+ *          (merge: O(n + k) por nó); chaves encontradas ou que param em folha são resolvidas, e cada sequência
+ *          de chaves com o mesmo slot desce como um grupo para o filho correspondente. Os nós vêm do
+ *          mapeamento (nas mesmas condições de mSearch), da memória (transação/cache) ou de leituras
+ *          assíncronas: o grupo espera em 'waiting' enquanto até IO_QUEUE_DEPTH leituras ficam em voo, e cada
+ *          conclusão processa o seu nó e empilha os grupos dos filhos.
+ */
+template <class Key, class Compare, int MaxM>
+vector<tuple<int, int, bool>> MWayTree<Key, Compare, MaxM>::mSearchMany(span<const Key> keys, vector<int>* recPos) {
+    vector<tuple<int, int, bool>> out(keys.size(), make_tuple(0, 0, false));
+    if (recPos) recPos->assign(keys.size(), NO_RECORD);
+    resetCounters();
+    if (!io->isOpen() || root == 0 || keys.empty()) return out;
+
+    bool mapped = mappedReads && map.isOpen() && cache.dirtyCount() == 0 && !headerDirty;
+
+    vector<int> order(keys.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return keyLess(keys[a], keys[b]); });
+
+    struct Group { int pos; size_t lo; size_t hi; };
+    vector<Group> pending{{root, 0, order.size()}};
+    vector<Group> waiting;
+
+    auto visit = [&](const Group& g, const BasicNodeView<Key>& node) {
+        size_t groupsBefore = pending.size();
+        int slot = 0;
+        size_t j = g.lo;
+        while (j < g.hi) {
+            const Key& key = keys[order[j]];
+            while (slot < node.n && keyLess(node.keys[slot], key)) slot++;
+            if (slot < node.n && keyEqual(node.keys[slot], key)) {
+                out[order[j]] = make_tuple(g.pos, slot + 1, true);
+                if (recPos) (*recPos)[order[j]] = node.recs ? node.recs[slot] : NO_RECORD;
+                j++;
+                continue;
+            }
+            size_t end = j + 1;
+            while (end < g.hi && (slot == node.n || keyLess(keys[order[end]], node.keys[slot]))) end++;
+            int child = node.children[slot];
+            if (child == 0) {
+                for (size_t t = j; t < end; ++t) out[order[t]] = make_tuple(g.pos, slot, false);
+            } else {
+                pending.push_back({child, j, end});
+            }
+            j = end;
+        }
+        reverse(pending.begin() + static_cast<ptrdiff_t>(groupsBefore), pending.end());
+    };
+    auto viewOf = [](const Node& n) { return BasicNodeView<Key>{n.n, n.keys, n.recs, n.children, PADDED_NODE}; };
+
+    Node copy;
+    while (!pending.empty() || !waiting.empty()) {
+        while (!pending.empty() && readsInFlight < IO_QUEUE_DEPTH) {
+            Group g = pending.back();
+            pending.pop_back();
+            if (mapped) {
+                BasicNodeView<Key> node;
+                if (!map.view(g.pos, node)) continue;
+                idxMapped++;
+                visit(g, node);
+            } else if (readResident(g.pos, copy)) {
+                visit(g, viewOf(copy));
+            } else if (startRead(g.pos)) {
+                waiting.push_back(g);
+            } else {
+                copy = loadNode(g.pos);
+                visit(g, viewOf(copy));
+            }
+        }
+        completeReads(1, [&](int pos, const Node* node) {
+            auto it = find_if(waiting.begin(), waiting.end(), [pos](const Group& w) { return w.pos == pos; });
+            if (it == waiting.end()) return;
+            Group g = *it;
+            *it = waiting.back();
+            waiting.pop_back();
+            if (node) {
+                visit(g, viewOf(*node));
+            } else {
+                Node fresh = loadNode(pos);
+                visit(g, viewOf(fresh));
+            }
+        });
+    }
+    return out;
+}
+
+/**
+ * @brief Uma busca intercalada. Sobre o mapeamento, antecipa as linhas do nó e cede a vez antes de
+ *        percorrê-lo; pelo cache, faz o mesmo com a entrada do nó (o ponteiro de peek não é usado
+ *        depois da suspensão: readResident copia o nó na volta). Nó fora da memória: com io_uring, a leitura
+ *        é submetida e a corrotina espera a sua conclusão; com pread (que não sobrepõe leituras), com a fila
+ *        cheia ou com a leitura descartada, lê de forma bloqueante.
+ */
+template <class Key, class Compare, int MaxM>
+LookupTask MWayTree<Key, Compare, MaxM>::lookupTask(const Key& key, LookupScheduler<Node>& sched, bool mapped,
+                                                    tuple<int, int, bool>& out, int& rec) {
+    int current = root;
+    Node copy{};
+    bool ok = false;
+
+    while (current != 0) {
+        BasicNodeView<Key> node;
+        if (mapped) {
+            if (const char* p = map.address(current)) {
+                prefetchBytes(p, map.nodeBytes());
+                co_await sched.yield();
+            }
+            if (!map.view(current, node)) co_return;
+            idxMapped++;
+        } else {
+            if (const Node* hot = cache.peek(current)) {
+                prefetchBytes(hot, sizeof(Node));
+                co_await sched.yield();
+            }
+            if (!readResident(current, copy)) {
+                ok = false;
+                if (io->overlaps() && startRead(current)) co_await sched.read(current, &copy, &ok);
+                if (!ok) copy = loadNode(current);
+            }
+            node = BasicNodeView<Key>{copy.n, copy.keys, copy.recs, copy.children, PADDED_NODE};
+        }
+        idxLevels++;
+
+        int i = IndexMap::slotOf(node, key, Compare{});
+
+        if (i < node.n && keyEqual(key, node.keys[i])) {
+            out = make_tuple(current, i + 1, true);
+            rec = node.recs ? node.recs[i] : NO_RECORD;
+            co_return;
+        }
+
+        if (node.children[i] == 0) {
+            out = make_tuple(current, i, false);
+            co_return;
+        }
+
+        current = node.children[i];
+    }
+}
+
+/**
+ * @brief Escalonador das buscas intercaladas: mantém width corrotinas vivas, retoma as prontas em
+ *        round-robin e, quando todas esperam por leituras, colhe ao menos uma conclusão e a entrega.
+ */
+template <class Key, class Compare, int MaxM>
+vector<tuple<int, int, bool>> MWayTree<Key, Compare, MaxM>::mSearchInterleaved(span<const Key> keys,
+                                                                               vector<int>* recPos, int width) {
+    vector<tuple<int, int, bool>> out(keys.size(), make_tuple(0, 0, false));
+    vector<int> scratch;
+    vector<int>& recs = recPos ? *recPos : scratch;
+    recs.assign(keys.size(), NO_RECORD);
+    resetCounters();
+    if (!io->isOpen() || root == 0 || keys.empty()) return out;
+
+    bool mapped = mappedReads && map.isOpen() && cache.dirtyCount() == 0 && !headerDirty;
+    LookupScheduler<Node> sched;
+    size_t next = 0;
+    int active = 0;
+    auto spawn = [&] {
+        sched.ready(lookupTask(keys[next], sched, mapped, out[next], recs[next]).release());
+        next++;
+        active++;
+    };
+    while (active < max(width, 1) && next < keys.size()) spawn();
+
+    while (active > 0) {
+        if (!sched.hasRunnable()) {
+            if (readsInFlight == 0) sched.failWaiting();
+            else completeReads(1, [&](int pos, const Node* node) { sched.deliver(pos, node); });
+            continue;
+        }
+        coroutine_handle<> h = sched.next();
+        h.resume();
+        if (!h.done()) continue;
+        h.destroy();
+        active--;
+        if (next < keys.size()) spawn();
+    }
+    return out;
+}
+
+/**
+ * @brief Varredura de intervalo: seek(lo) e next() até passar de hi; cada nó é lido uma vez. Com io_uring, as
+ *        leituras dos próximos SCAN_PREFETCH_SIBLINGS irmãos ficam em voo enquanto o nó corrente é percorrido.
+ * @param lo Limite inferior (inclusivo).
+ * @param hi Limite superior (inclusivo).
+ * @param visit Callback (chave, registro); false interrompe.
+ * @return Quantidade de chaves visitadas.
+ */
+template <class Key, class Compare, int MaxM>
+size_t MWayTree<Key, Compare, MaxM>::rangeScan(const Key& lo, const Key& hi, const function<bool(const Key&, int)>& visit) {
+    if (!io->isOpen() || root == 0 || keyLess(hi, lo)) return 0;
+    resetCounters();
+    TreeCursor<Key, Compare, MaxM> cur(*this);
+    if (io->overlaps()) {
+        cur.setPrefetch(SCAN_PREFETCH_SIBLINGS);
+        cur.setPrefetchBound(hi);
+    }
+    size_t visited = 0;
+    for (bool ok = cur.seek(lo); ok && !keyLess(hi, cur.key()); ok = cur.next()) {
+        visited++;
+        if (!visit(cur.key(), cur.record())) break;
+    }
+    return visited;
+}
+
+/**
+ * @brief Inserção bottom-up: insere em folha; se nó ficar cheio (n>=m), divide e promove chave central.
+ * @param key Chave a inserir; duplicatas são ignoradas.
+ * @param recPos Número do registro da chave em data.bin (acompanha a chave em splits).
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::insertB(const Key& key, int recPos){
+    if (!io->isOpen()) return;
+
+    auto start = chrono::steady_clock::now();
+    resetCounters();
+    insertKey(key, recPos);
+    endOperation();
+    recordOperation(metrics.insert, start);
+}
+
+/**
+ * @brief Corpo da inserção (sem reset de contadores nem fechamento de lote).
+ * @param key Chave a inserir.
+ * @param recPos Número do registro da chave.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::insertKey(const Key& key, int recPos) {
+    if (root == 0) {
+        Node r{};
+        r.n = 1;
+        r.keys[0] = key;
+        r.recs[0] = recPos;
+        createRoot(r);
+        return;
+    }
+
+    vector<int> path;
+    int cur = root;
+    while (true) {
+        path.push_back(cur);
+        Node node = readNode(cur);
+        idxLevels++;
+
+        int i = nodeSlot(node, key, Compare{});
+
+        if (i < node.n && keyEqual(key, node.keys[i])) return;
+
+        if (node.children[i] == 0) {
+            for (int j = node.n; j > i; --j) {
+                node.keys[j] = node.keys[j - 1];
+                node.recs[j] = node.recs[j - 1];
+            }
+            for (int j = node.n + 1; j > i; --j) node.children[j] = node.children[j - 1];
+            node.keys[i] = key;
+            node.recs[i] = recPos;
+            node.children[i] = 0;
+            node.n++;
+            if (node.n < m) {
+                writeNode(node, cur);
+                return;
+            }
+
+            Key upKey{};
+            int upRec = NO_RECORD;
+            int rightPos = 0;
+            while (node.n >= m) {
+                int mid = m / 2;
+                Node left = node;
+                Node right{};
+                int rightCount = node.n - mid - 1;
+
+                left.n = mid;
+                for (int k = 0; k < rightCount; ++k) {
+                    right.keys[k] = node.keys[mid + 1 + k];
+                    right.recs[k] = node.recs[mid + 1 + k];
+                }
+                for (int k = 0; k <= rightCount; ++k) right.children[k] = node.children[mid + 1 + k];
+                right.n = rightCount;
+                upKey = node.keys[mid];
+                upRec = node.recs[mid];
+
+                writeNode(left, cur);
+                rightPos = writeNode(right);
+                idxSplits++;
+
+                if (cur == root) {
+                    Node newRoot{};
+                    newRoot.n = 1;
+                    newRoot.keys[0] = upKey;
+                    newRoot.recs[0] = upRec;
+                    newRoot.children[0] = cur;
+                    newRoot.children[1] = rightPos;
+                    int newRootPos = writeNode(newRoot);
+                    root = newRootPos;
+                    idxRootChanges++;
+                    pinRoot();
+                    updateHeader();
+                    return;
+                } else {
+                    int parentPos = path[path.size() - 2];
+                    Node parent = readNode(parentPos);
+
+                    int pi = 0;
+                    while (pi <= parent.n && parent.children[pi] != cur) pi++;
+
+                    for (int j2 = parent.n; j2 > pi; --j2) {
+                        parent.keys[j2] = parent.keys[j2 - 1];
+                        parent.recs[j2] = parent.recs[j2 - 1];
+                    }
+                    for (int j2 = parent.n + 1; j2 > pi + 1; --j2) parent.children[j2] = parent.children[j2 - 1];
+
+                    parent.keys[pi] = upKey;
+                    parent.recs[pi] = upRec;
+                    parent.children[pi] = cur;
+                    parent.children[pi + 1] = rightPos;
+                    parent.n++;
+                    if (parent.n < m) writeNode(parent, parentPos);
+
+                    cur = parentPos;
+                    node = parent;
+                    path.pop_back();
+                    continue;
+                }
+            }
+
+            return;
+        } else {
+            cur = node.children[i];
+        }
+    }
+}
+
+/**
+ * @brief Inserção em lote: ordena (estável) e descarta repetições do lote; uma única operação.
+ * @details A raiz recebe as promoções da descida como uma nova raiz (dividida de novo se exceder m-1 chaves).
+ */
+template <class Key, class Compare, int MaxM>
+size_t MWayTree<Key, Compare, MaxM>::insertMany(span<const pair<Key,int>> entries) {
+    if (!io->isOpen()) return 0;
+    resetCounters();
+    vector<pair<Key,int>> items(entries.begin(), entries.end());
+    stable_sort(items.begin(), items.end(), [](const pair<Key,int>& a, const pair<Key,int>& b) {
+        return keyLess(a.first, b.first);
+    });
+    items.erase(unique(items.begin(), items.end(), [](const pair<Key,int>& a, const pair<Key,int>& b) {
+        return keyEqual(a.first, b.first);
+    }), items.end());
+    if (items.empty()) return 0;
+
+    size_t inserted = 0;
+    size_t start = 0;
+    if (root == 0) {
+        insertKey(items[0].first, items[0].second);
+        inserted = start = 1;
+    }
+    vector<Promotion> up;
+    insertBatch(root, items, start, items.size(), up, inserted);
+    while (!up.empty()) {
+        vector<Key> keys;
+        vector<int> recs, kids{root};
+        for (const Promotion& p : up) {
+            keys.push_back(p.key);
+            recs.push_back(p.rec);
+            kids.push_back(p.right);
+        }
+        up.clear();
+        root = storeChunks(0, keys, recs, kids, up);
+        idxRootChanges++;
+        pinRoot();
+        updateHeader();
+    }
+    endOperation();
+    return inserted;
+}
+
+template <class Key, class Compare, int MaxM>
+int MWayTree<Key, Compare, MaxM>::storeChunks(int pos, const vector<Key>& keys, const vector<int>& recs, const vector<int>& kids,
+                          vector<Promotion>& up) {
+    const int total = static_cast<int>(keys.size());
+    const int count = (total + m) / m; // ceil((total+1)/m): nenhum nó passa de m-1 chaves
+    const int perNode = total - (count - 1);
+    idxSplits += count - 1;
+    int at = 0;
+    int first = pos;
+    for (int c = 0; c < count; ++c) {
+        Node node{};
+        node.n = perNode / count + (c < perNode % count ? 1 : 0);
+        for (int k = 0; k < node.n; ++k) {
+            node.keys[k] = keys[at + k];
+            node.recs[k] = recs[at + k];
+        }
+        for (int k = 0; k <= node.n; ++k) node.children[k] = kids[at + k];
+        at += node.n;
+        int written;
+        if (c == 0 && pos != 0) {
+            writeNode(node, pos);
+            written = pos;
+        } else {
+            written = writeNode(node);
+        }
+        if (c == 0) first = written;
+        else up.back().right = written;
+        if (c + 1 < count) {
+            up.push_back({keys[at], recs[at], 0});
+            at++;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief Em folha, intercala as chaves do lote com as do nó; em nó interno, envia cada grupo ao filho e
+ *        insere as promoções recebidas logo após o filho que as gerou. O resultado é gravado uma vez
+ *        (dividido em nós equilibrados se exceder m-1 chaves).
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::insertBatch(int pos, const vector<pair<Key,int>>& items, size_t lo, size_t hi,
+                           vector<Promotion>& up, size_t& inserted) {
+    Node node = readNode(pos);
+    vector<Key> keys;
+    vector<int> recs, kids;
+    keys.reserve(node.n + (hi - lo));
+    recs.reserve(node.n + (hi - lo));
+    kids.reserve(node.n + (hi - lo) + 1);
+    bool changed = false;
+
+    if (isLeaf(node)) {
+        int i = 0;
+        for (size_t j = lo; j < hi; ++j) {
+            while (i < node.n && keyLess(node.keys[i], items[j].first)) {
+                keys.push_back(node.keys[i]);
+                recs.push_back(node.recs[i]);
+                i++;
+            }
+            if (i < node.n && keyEqual(node.keys[i], items[j].first)) continue;
+            keys.push_back(items[j].first);
+            recs.push_back(items[j].second);
+            inserted++;
+            changed = true;
+        }
+        for (; i < node.n; ++i) {
+            keys.push_back(node.keys[i]);
+            recs.push_back(node.recs[i]);
+        }
+        kids.assign(keys.size() + 1, 0);
+    } else {
+        vector<Promotion> childUp;
+        size_t j = lo;
+        for (int slot = 0; slot <= node.n; ++slot) {
+            size_t end = j;
+            while (end < hi && (slot == node.n || keyLess(items[end].first, node.keys[slot]))) end++;
+            kids.push_back(node.children[slot]);
+            if (end > j) {
+                childUp.clear();
+                insertBatch(node.children[slot], items, j, end, childUp, inserted);
+                for (const Promotion& p : childUp) {
+                    keys.push_back(p.key);
+                    recs.push_back(p.rec);
+                    kids.push_back(p.right);
+                    changed = true;
+                }
+            }
+            j = end;
+            if (slot < node.n) {
+                if (j < hi && keyEqual(items[j].first, node.keys[slot])) j++; // já existe
+                keys.push_back(node.keys[slot]);
+                recs.push_back(node.recs[slot]);
+            }
+        }
+    }
+
+    if (changed) storeChunks(pos, keys, recs, kids, up);
+}
+
+namespace mways_detail {
+
+/**
+ * @brief Estado de um nível durante a carga em lote (apenas o nó mais à direita fica em memória).
+ */
+template <class NodeT>
+struct BulkLevel {
+    long long nodes = 0;     // nós neste nível
+    long long base = 0;      // chaves por nó
+    long long extra = 0;     // os primeiros 'extra' nós recebem base+1 chaves
+    long long done = 0;      // nós já gravados
+    NodeT cur{};
+    bool sepPending = false; // a próxima chave que chegar a este nível é separador do nível de cima
+
+    int target() const { return static_cast<int>(base + (done < extra ? 1 : 0)); }
+};
+
+/**
+ * @brief Quantidade de nós para distribuir 'items' chaves de um nível (separadores sobem ao nível de cima).
+ * @details Com g nós, g-1 chaves sobem e items-g+1 ficam no nível. O valor é o mais próximo de
+ *          ceil((items+1)/(alvo+1)) dentro da faixa que mantém todo nó entre lowK e hiK chaves.
+ */
+inline long long bulkNodesForLevel(long long items, int lowK, int hiK, int targetK) {
+    if (items <= hiK) return 1;
+    long long lo = (items + hiK + 1) / (hiK + 1);
+    long long hi = (items + 1) / (lowK + 1);
+    long long g = (items + targetK + 1) / (targetK + 1);
+    return std::clamp(g, lo, hi);
+}
+
+} // namespace mways_detail
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::bulkLoad(const vector<pair<Key,int>>& entries, double fillFactor, std::size_t memoryBudget) {
+    size_t i = 0;
+    return bulkLoad([&](Key& key, int& rec) {
+        if (i >= entries.size()) return false;
+        key = entries[i].first;
+        rec = entries[i].second;
+        i++;
+        return true;
+    }, fillFactor, memoryBudget);
+}
+
+/**
+ * @brief Carga em lote: ordena (externamente se preciso) e delega à carga a partir da sequência ordenada.
+ * @param source Fonte de pares (chave, registro).
+ * @param fillFactor Fração de m-1 chaves por nó.
+ * @param memoryBudget Orçamento de memória da ordenação.
+ * @return true em caso de sucesso.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::bulkLoad(const function<bool(Key&, int&)>& source, double fillFactor, std::size_t memoryBudget) {
+    if (!io->isOpen() || root != 0) return false;
+
+    ExternalSorter<Key, Compare> sorter(memoryBudget, filename + ".run");
+    Key key{};
+    int rec = 0;
+    while (source(key, rec)) {
+        if (!sorter.add(key, rec)) return false;
+    }
+    return sorter.finish() && bulkLoad(sorter, fillFactor);
+}
+
+/**
+ * @brief Carga em lote a partir da sequência ordenada: planeja os níveis e grava nós completos em sequência.
+ * @param sorted Pares ordenados (finish() já chamado).
+ * @param fillFactor Fração de m-1 chaves por nó.
+ * @return true em caso de sucesso.
+ * @details Cada chave ordenada entra no nível mais baixo que não está esperando separador; folhas
+ *          completas sobem como filho do nível 1, e um nó interno fica completo ao receber o último filho.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::bulkLoad(ExternalSorter<Key, Compare>& sorter, double fillFactor) {
+    using namespace mways_detail;
+    if (!io->isOpen() || root != 0) return false;
+    resetCounters();
+
+    if (!sorter.rewind()) return false;
+    Key key{};
+    int rec = 0;
+    long long total = 0;
+    while (sorter.next(key, rec)) total++;
+    if (total == 0) return true;
+
+    int lowK = max(1, minKeys());
+    int hiK = m - 1;
+    double f = (fillFactor > 1.0) ? 1.0 : fillFactor;
+    int targetK = std::clamp(static_cast<int>(f * hiK + 0.5), lowK, hiK);
+
+    vector<BulkLevel<Node>> levels;
+    long long items = total;
+    while (true) {
+        BulkLevel<Node> lv;
+        lv.nodes = bulkNodesForLevel(items, lowK, hiK, targetK);
+        long long keysHere = items - (lv.nodes - 1);
+        lv.base = keysHere / lv.nodes;
+        lv.extra = keysHere % lv.nodes;
+        levels.push_back(lv);
+        if (lv.nodes == 1) break;
+        items = lv.nodes - 1;
+    }
+    const int top = static_cast<int>(levels.size()) - 1;
+
+    auto completeUp = [&](int l) {
+        while (true) {
+            int pos = writeNode(levels[l].cur);
+            levels[l].cur = Node{};
+            levels[l].done++;
+            if (l == top) {
+                root = pos;
+                return;
+            }
+            levels[l].sepPending = true;
+            BulkLevel<Node>& up = levels[l + 1];
+            up.cur.children[up.cur.n] = pos;
+            if (up.cur.n < up.target()) return;
+            l++;
+        }
+    };
+
+    if (!sorter.rewind()) return false;
+    // Carga em lote fora do WAL (árvore vazia): os nós vão direto ao índice; a troca da raiz é registrada
+    // no log e o checkpoint final faz o fsync.
+    WalMode savedWal = walMode;
+    walMode = WalMode::Off;
+    while (sorter.next(key, rec)) {
+        int l = 0;
+        while (levels[l].sepPending) {
+            levels[l].sepPending = false;
+            l++;
+        }
+        Node& cur = levels[l].cur;
+        cur.keys[cur.n] = key;
+        cur.recs[cur.n] = rec;
+        cur.n++;
+        if (l == 0 && cur.n == levels[0].target()) completeUp(0);
+    }
+
+    walMode = savedWal;
+    pinRoot();
+    updateHeader();
+    sync();
+    return true;
+}
+
+template <class Key, class Compare, int MaxM>
+int MWayTree<Key, Compare, MaxM>::minKeys() const {
+    int t = (m + 1) / 2;
+    return t - 1;
+}
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::isLeaf(const Node& node) const {
+    return node.children[0] == 0;
+}
+
+/**
+ * @brief Corrige underflow do filho childIndex de parentPos.
+ * @param parentPos Posição do pai.
+ * @param childIndex Índice do filho [0..n].
+ * @details Estratégia: (1) tentar empréstimo do irmão esquerdo/direito com >minKeys;
+ *          (2) caso contrário, fundir com irmão adjacente e puxar chave do pai; o nó absorvido
+ *          vai para a lista de livres.
+ */
+template <class Key, class Compare, int MaxM>
+void MWayTree<Key, Compare, MaxM>::fixUnderflow(int parentPos, int childIndex) {
+    Node parent = readNode(parentPos);
+    int minK = minKeys();
+
+    int childPos = parent.children[childIndex];
+    Node child = readNode(childPos);
+
+    int leftIdx = childIndex - 1;
+    int rightIdx = childIndex + 1;
+
+    if (leftIdx >= 0) {
+        int leftPos = parent.children[leftIdx];
+        Node left = readNode(leftPos);
+        if (left.n > minK) {
+            for (int j = child.n; j > 0; --j) {
+                child.keys[j] = child.keys[j - 1];
+                child.recs[j] = child.recs[j - 1];
+                child.children[j + 1] = child.children[j];
+            }
+            child.children[1] = child.children[0];
+            child.keys[0] = parent.keys[leftIdx];
+            child.recs[0] = parent.recs[leftIdx];
+            child.children[0] = left.children[left.n];
+            child.n++;
+
+            parent.keys[leftIdx] = left.keys[left.n - 1];
+            parent.recs[leftIdx] = left.recs[left.n - 1];
+            left.n--;
+
+            writeNode(left, leftPos);
+            writeNode(child, childPos);
+            writeNode(parent, parentPos);
+            idxBorrows++;
+            return;
+        }
+    }
+
+    if (rightIdx <= parent.n) {
+        int rightPos = parent.children[rightIdx];
+        Node right = readNode(rightPos);
+        if (right.n > minK) {
+            child.keys[child.n] = parent.keys[childIndex];
+            child.recs[child.n] = parent.recs[childIndex];
+            child.children[child.n + 1] = right.children[0];
+            child.n++;
+
+            parent.keys[childIndex] = right.keys[0];
+            parent.recs[childIndex] = right.recs[0];
+            for (int j = 0; j < right.n - 1; ++j) {
+                right.keys[j] = right.keys[j + 1];
+                right.recs[j] = right.recs[j + 1];
+                right.children[j] = right.children[j + 1];
+            }
+            right.children[right.n - 1] = right.children[right.n];
+            right.n--;
+
+            writeNode(right, rightPos);
+            writeNode(child, childPos);
+            writeNode(parent, parentPos);
+            idxBorrows++;
+            return;
+        }
+    }
+
+    if (leftIdx >= 0) {
+        int leftPos = parent.children[leftIdx];
+        Node left = readNode(leftPos);
+
+        left.keys[left.n] = parent.keys[leftIdx];
+        left.recs[left.n] = parent.recs[leftIdx];
+        left.children[left.n + 1] = child.children[0];
+        for (int j = 0; j < child.n; ++j) {
+            left.keys[left.n + 1 + j] = child.keys[j];
+            left.recs[left.n + 1 + j] = child.recs[j];
+            left.children[left.n + 2 + j] = child.children[j + 1];
+        }
+        left.n += 1 + child.n;
+
+        for (int j = leftIdx; j < parent.n - 1; ++j) {
+            parent.keys[j] = parent.keys[j + 1];
+            parent.recs[j] = parent.recs[j + 1];
+            parent.children[j + 1] = parent.children[j + 2];
+        }
+        parent.n--;
+
+        writeNode(left, leftPos);
+        writeNode(parent, parentPos);
+        freeNode(childPos);
+        idxMerges++;
+    } else {
+        int rightPos = parent.children[rightIdx];
+        Node right = readNode(rightPos);
+
+        child.keys[child.n] = parent.keys[childIndex];
+        child.recs[child.n] = parent.recs[childIndex];
+        child.children[child.n + 1] = right.children[0];
+        for (int j = 0; j < right.n; ++j) {
+            child.keys[child.n + 1 + j] = right.keys[j];
+            child.recs[child.n + 1 + j] = right.recs[j];
+            child.children[child.n + 2 + j] = right.children[j + 1];
+        }
+        child.n += 1 + right.n;
+
+        for (int j = childIndex; j < parent.n - 1; ++j) {
+            parent.keys[j] = parent.keys[j + 1];
+            parent.recs[j] = parent.recs[j + 1];
+            parent.children[j + 1] = parent.children[j + 2];
+        }
+        parent.n--;
+
+        writeNode(child, childPos);
+        writeNode(parent, parentPos);
+        freeNode(rightPos);
+        idxMerges++;
+    }
+}
+
+/**
+ * @brief Remoção recursiva com substituto por antecessor em nós internos.
+ * @param nodePos Posição atual.
+ * @param key Chave a remover.
+ * @param recPos (Opcional) saída: ponteiro de registro da chave removida.
+ * @return Ok/Underflow/NotFound conforme progresso; underflow propagará ajuste ao retorno.
+ */
+template <class Key, class Compare, int MaxM>
+typename MWayTree<Key, Compare, MaxM>::DelResult MWayTree<Key, Compare, MaxM>::deleteRecursive(int nodePos, const Key& key, int* recPos) {
+    Node node = readNode(nodePos);
+    idxLevels++;
+    int minK = minKeys();
+
+    int i = nodeSlot(node, key, Compare{});
+
+    if (i < node.n && keyEqual(node.keys[i], key)) {
+        if (recPos) *recPos = node.recs[i];
+        if (isLeaf(node)) {
+            for (int j = i; j < node.n - 1; ++j) {
+                node.keys[j] = node.keys[j + 1];
+                node.recs[j] = node.recs[j + 1];
+            }
+            node.n--;
+            writeNode(node, nodePos);
+            if (nodePos != root && node.n < minK) return DelResult::Underflow;
+            return DelResult::Ok;
+        } else {
+            int predPos = node.children[i];
+            Node cur = readNode(predPos);
+            idxLevels++;
+            while (!isLeaf(cur)) {
+                predPos = cur.children[cur.n];
+                cur = readNode(predPos);
+                idxLevels++;
+            }
+            Key predKey = cur.keys[cur.n - 1];
+            node.keys[i] = predKey;
+            node.recs[i] = cur.recs[cur.n - 1];
+            writeNode(node, nodePos);
+            auto res = deleteRecursive(node.children[i], predKey, nullptr);
+            if (res == DelResult::Underflow) {
+                fixUnderflow(nodePos, i);
+                Node p = readNode(nodePos);
+                if (nodePos != root && p.n < minK) return DelResult::Underflow;
+            }
+            return DelResult::Ok;
+        }
+    }
+
+    if (isLeaf(node)) {
+        return DelResult::NotFound;
+    } else {
+        int childIndex = i;
+        auto res = deleteRecursive(node.children[childIndex], key, recPos);
+        if (res == DelResult::Underflow) {
+            fixUnderflow(nodePos, childIndex);
+            Node p = readNode(nodePos);
+            if (nodePos != root && p.n < minK) return DelResult::Underflow;
+            return DelResult::Ok;
+        }
+        return res;
+    }
+}
+
+/**
+ * @brief Remoção e contração de raiz: após remover, se root ficar com n=0, adota único filho (ou zera).
+ * @param key Chave a remover.
+ * @param recPos (Opcional) saída: ponteiro de registro da chave removida.
+ * @return true se a chave existia no índice.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::deleteB(const Key& key, int* recPos) {
+    if (!io->isOpen() || root == 0) return false;
+    auto start = chrono::steady_clock::now();
+    resetCounters();
+
+    bool removed = deleteKey(key, recPos);
+    endOperation();
+    recordOperation(metrics.remove, start);
+    return removed;
+}
+
+/**
+ * @brief Corpo da remoção (sem reset de contadores nem fechamento de lote).
+ * @param key Chave a remover.
+ * @param recPos (Opcional) saída: ponteiro de registro da chave removida.
+ * @return true se a chave existia.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::deleteKey(const Key& key, int* recPos) {
+    auto res = deleteRecursive(root, key, recPos);
+    if (res == DelResult::NotFound) return false;
+
+    Node r = readNode(root);
+    if (r.n == 0) {
+        int oldRoot = root;
+        if (r.children[0] != 0) {
+            root = r.children[0];
+        } else {
+            root = 0;
+        }
+        idxRootChanges++;
+        pinRoot();
+        freeNode(oldRoot);
+        updateHeader();
+    }
+    return true;
+}
+
+/**
+ * @brief Remoção em lote em três passos, cada um com no máximo uma escrita por nó afetado:
+ *        (1) remove nas folhas as chaves do lote, rebalanceando os filhos de cada nó uma vez (repetido
+ *        enquanto fusões trouxerem chaves internas do lote para as folhas); (2) em cada chave que restou em nó interno, sobrescreve-a com o antecessor (última chave da folha
+ *        mais à direita da subárvore esquerda); (3) remove em lote esses antecessores das folhas.
+ */
+template <class Key, class Compare, int MaxM>
+size_t MWayTree<Key, Compare, MaxM>::deleteMany(span<const Key> keys, vector<int>* recPos) {
+    if (recPos) recPos->assign(keys.size(), NO_RECORD);
+    if (!io->isOpen() || root == 0) return 0;
+    resetCounters();
+    auto byKey = [](const pair<Key,int>& a, const pair<Key,int>& b) { return keyLess(a.first, b.first); };
+    vector<pair<Key,int>> probes; // (chave, índice na entrada)
+    probes.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) probes.emplace_back(keys[i], static_cast<int>(i));
+    stable_sort(probes.begin(), probes.end(), byKey);
+    probes.erase(unique(probes.begin(), probes.end(), [](const pair<Key,int>& a, const pair<Key,int>& b) {
+        return keyEqual(a.first, b.first);
+    }), probes.end());
+
+    auto leafPass = [&](const vector<pair<Key,int>>& batch, bool leafOnly, vector<int>* deferred, vector<int>* out) {
+        size_t count = 0;
+        Node r = readNode(root);
+        if (deleteBatch(r, batch, 0, batch.size(), leafOnly, deferred, out, count)) writeNode(r, root);
+        while (r.n == 0) {
+            int oldRoot = root;
+            root = r.children[0];
+            idxRootChanges++;
+            pinRoot();
+            freeNode(oldRoot);
+            updateHeader();
+            if (root == 0) break;
+            r = readNode(root);
+        }
+        return count;
+    };
+
+    vector<int> deferred;
+    size_t removed = leafPass(probes, false, &deferred, recPos);
+    vector<pair<Key,int>> pending;
+    for (int idx : deferred) pending.push_back(probes[idx]);
+    // Fusões descem separadores para as folhas: repete o passo (1) até restarem só chaves internas.
+    while (!pending.empty() && root != 0) {
+        deferred.clear();
+        removed += leafPass(pending, false, &deferred, recPos);
+        if (deferred.size() == pending.size()) break;
+        vector<pair<Key,int>> still;
+        for (int idx : deferred) still.push_back(pending[idx]);
+        pending.swap(still);
+    }
+    if (pending.empty() || root == 0) {
+        endOperation();
+        return removed;
+    }
+
+    vector<pair<Key,int>> preds;
+    for (const auto& [key, input] : pending) {
+        int pos = root;
+        Node node = readNode(pos);
+        int i = nodeSlot(node, key, Compare{});
+        while (!(i < node.n && keyEqual(node.keys[i], key)) && node.children[i] != 0) {
+            pos = node.children[i];
+            node = readNode(pos);
+            i = nodeSlot(node, key, Compare{});
+        }
+        if (!(i < node.n && keyEqual(node.keys[i], key)) || isLeaf(node)) continue;
+        Node leaf = readNode(node.children[i]);
+        while (!isLeaf(leaf)) leaf = readNode(leaf.children[leaf.n]);
+        if (recPos) (*recPos)[input] = node.recs[i];
+        node.keys[i] = leaf.keys[leaf.n - 1];
+        node.recs[i] = leaf.recs[leaf.n - 1];
+        writeNode(node, pos);
+        preds.emplace_back(node.keys[i], input);
+        removed++;
+    }
+    sort(preds.begin(), preds.end(), byKey);
+    leafPass(preds, true, nullptr, nullptr);
+    endOperation();
+    return removed;
+}
+
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::deleteBatch(Node& node, const vector<pair<Key,int>>& probes, size_t lo, size_t hi, bool leafOnly,
+                           vector<int>* deferred, vector<int>* recPos, size_t& removed) {
+    if (isLeaf(node)) {
+        int kept = 0;
+        size_t j = lo;
+        for (int i = 0; i < node.n; ++i) {
+            while (j < hi && keyLess(probes[j].first, node.keys[i])) j++;
+            if (j < hi && keyEqual(probes[j].first, node.keys[i])) {
+                if (recPos) (*recPos)[probes[j].second] = node.recs[i];
+                removed++;
+                continue;
+            }
+            node.keys[kept] = node.keys[i];
+            node.recs[kept] = node.recs[i];
+            kept++;
+        }
+        bool changed = kept != node.n;
+        node.n = kept;
+        return changed;
+    }
+
+    vector<BatchChild> kids(node.n + 1);
+    for (int c = 0; c <= node.n; ++c) kids[c].pos = node.children[c];
+
+    size_t j = lo;
+    for (int slot = 0; slot <= node.n; ++slot) {
+        size_t end = j;
+        while (end < hi && (slot == node.n || keyLess(probes[end].first, node.keys[slot]) ||
+                            (leafOnly && keyEqual(probes[end].first, node.keys[slot])))) end++;
+        if (end > j) {
+            BatchChild& c = kids[slot];
+            c.node = readNode(c.pos);
+            c.loaded = true;
+            c.dirty = deleteBatch(c.node, probes, j, end, leafOnly, deferred, recPos, removed);
+        }
+        j = end;
+        if (!leafOnly && slot < node.n && j < hi && keyEqual(probes[j].first, node.keys[slot])) {
+            deferred->push_back(static_cast<int>(j++));
+        }
+    }
+    return rebalanceChildren(node, kids);
+}
+
+/**
+ * @brief Combina cada filho em underflow com um irmão: com chaves suficientes (>= 2*minKeys+1 somando o
+ *        separador), redistribui metade/metade; senão funde os dois (o da direita vai para a lista de livres).
+ * @details Um filho interno que ficou sem chaves (n=0) tem um único filho, que pode estar em underflow; após
+ *          combiná-lo, esse neto é corrigido do mesmo modo dentro do nó que passou a contê-lo. Os filhos
+ *          alterados são gravados uma vez, no fim.
+ * @return true se node foi alterado.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::rebalanceChildren(Node& node, vector<BatchChild>& kids) {
+    auto load = [&](BatchChild& c) {
+        if (!c.loaded) {
+            c.node = readNode(c.pos);
+            c.loaded = true;
+        }
+    };
+    const int minK = minKeys();
+    bool changed = false;
+    int idx = 0;
+    while (idx <= node.n && node.n > 0) {
+        if (!kids[idx].loaded || kids[idx].node.n >= minK) {
+            idx++;
+            continue;
+        }
+        int a = idx > 0 ? idx - 1 : idx;
+        BatchChild& left = kids[a];
+        BatchChild& right = kids[a + 1];
+        load(left);
+        load(right);
+        int lonely = 0;
+        if (left.node.n == 0 && !isLeaf(left.node)) lonely = left.node.children[0];
+        else if (right.node.n == 0 && !isLeaf(right.node)) lonely = right.node.children[0];
+
+        vector<Key> ks;
+        vector<int> rs, cs;
+        for (int k = 0; k < left.node.n; ++k) {
+            ks.push_back(left.node.keys[k]);
+            rs.push_back(left.node.recs[k]);
+        }
+        ks.push_back(node.keys[a]);
+        rs.push_back(node.recs[a]);
+        for (int k = 0; k < right.node.n; ++k) {
+            ks.push_back(right.node.keys[k]);
+            rs.push_back(right.node.recs[k]);
+        }
+        for (int k = 0; k <= left.node.n; ++k) cs.push_back(left.node.children[k]);
+        for (int k = 0; k <= right.node.n; ++k) cs.push_back(right.node.children[k]);
+        const int total = static_cast<int>(ks.size());
+        changed = true;
+
+        int holders = 1;
+        if (total >= 2 * minK + 1) {
+            int ln = (total - 1) / 2;
+            left.node.n = ln;
+            right.node.n = total - 1 - ln;
+            for (int k = 0; k < ln; ++k) {
+                left.node.keys[k] = ks[k];
+                left.node.recs[k] = rs[k];
+            }
+            for (int k = 0; k <= ln; ++k) left.node.children[k] = cs[k];
+            node.keys[a] = ks[ln];
+            node.recs[a] = rs[ln];
+            for (int k = 0; k < right.node.n; ++k) {
+                right.node.keys[k] = ks[ln + 1 + k];
+                right.node.recs[k] = rs[ln + 1 + k];
+            }
+            for (int k = 0; k <= right.node.n; ++k) right.node.children[k] = cs[ln + 1 + k];
+            left.dirty = right.dirty = true;
+            holders = 2;
+            idxBorrows++;
+        } else {
+            left.node.n = total;
+            for (int k = 0; k < total; ++k) {
+                left.node.keys[k] = ks[k];
+                left.node.recs[k] = rs[k];
+            }
+            for (int k = 0; k <= total; ++k) left.node.children[k] = cs[k];
+            left.dirty = true;
+            freeNode(right.pos);
+            for (int k = a; k < node.n - 1; ++k) {
+                node.keys[k] = node.keys[k + 1];
+                node.recs[k] = node.recs[k + 1];
+            }
+            for (int k = a + 1; k < node.n; ++k) node.children[k] = node.children[k + 1];
+            node.n--;
+            kids.erase(kids.begin() + a + 1);
+            idxMerges++;
+        }
+
+        for (int h = a; lonely != 0 && h < a + holders; ++h) {
+            Node& holder = kids[h].node;
+            int g = 0;
+            while (g <= holder.n && holder.children[g] != lonely) g++;
+            if (g > holder.n) continue;
+            vector<BatchChild> grand(holder.n + 1);
+            for (int k = 0; k <= holder.n; ++k) grand[k].pos = holder.children[k];
+            load(grand[g]);
+            if (grand[g].node.n < minK && rebalanceChildren(holder, grand)) kids[h].dirty = true;
+        }
+        idx = a;
+    }
+
+    for (const BatchChild& c : kids) {
+        if (c.dirty) writeNode(c.node, c.pos);
+    }
+    return changed;
+}
+
+/**
+ * @brief Verifica invariantes estruturais em todos os nós alcançáveis a partir da raiz.
+ * @param verbose Se true, imprime diagnósticos detalhados no stdout.
+ * @return true se íntegro.
+ * @details Checa: header (n=-1, m válido); consistência de raiz; alcance via BFS;
+ *          ordenação estrita das chaves; limites de faixa por subárvore; ponteiros de filhos no intervalo [0..N];
+ *          mínimos por nó não-raiz (interno: >=minKeys, folha: >=1); ausência de nós órfãos.
+ */
+template <class Key, class Compare, int MaxM>
+bool MWayTree<Key, Compare, MaxM>::verifyIntegrity(bool verbose) const {
+    if (!io->isOpen()) {
+        if (verbose) cout << "Indice nao esta aberto." << endl;
+        return false;
+    }
+    IndexMap im;
+    if (!im.open(filename, MaxM)) {
+        if (verbose) cout << "Falha ao mapear o indice ou header invalido (magic/versao/layout)." << endl;
+        return false;
+    }
+    const NodeFormat& f = im.format();
+    long long sz = static_cast<long long>(im.size());
+    int rt = root;
+    if (f.m != m) {
+        if (verbose) cout << "Ordem m do header (" << f.m << ") difere da carregada (" << m << ")." << endl;
+        return false;
+    }
+    if (f.keyType != KeyTraits<Key>::layout.type || f.keyBytes != KeyTraits<Key>::layout.bytes) {
+        if (verbose) cout << "Tipo de chave do header (" << f.keyType << ", " << f.keyBytes
+                          << " bytes) difere do indice carregado." << endl;
+        return false;
+    }
+    if ((sz - f.dataStart) % f.stride != 0) {
+        if (verbose) cout << "Tamanho do arquivo nao e multiplo do registro de no (" << f.stride << " bytes)." << endl;
+        return false;
+    }
+    // Raiz, lista de livres e nós vêm do estado em memória (nós sujos e transações ainda sem checkpoint);
+    // o arquivo pode estar atrás dele, nunca à frente.
+    int totalNodes = nodeCount;
+    if (f.positionsIn(sz) > totalNodes) {
+        if (verbose) cout << "Arquivo com " << f.positionsIn(sz) << " nos, mas apenas " << totalNodes << " alocados." << endl;
+        return false;
+    }
+
+    auto readAt = [&](int pos, Node& node)->bool { return inspectNode(pos, node); };
+    auto childInRange = [&](int c)->bool { return c == 0 || (c >= 1 && c <= totalNodes); };
+
+    vector<char> vis(totalNodes + 1, 0);
+    int freeSeen = 0;
+    for (int pos = freeHead; pos != 0; ) {
+        if (pos < 1 || pos > totalNodes || vis[pos]) {
+            if (verbose) cout << "Lista de livres invalida (posicao " << pos << " fora do intervalo ou repetida)." << endl;
+            return false;
+        }
+        Node fn;
+        if (!readAt(pos, fn) || fn.n != FREE_NODE) {
+            if (verbose) cout << "No " << pos << " na lista de livres nao esta marcado como livre." << endl;
+            return false;
+        }
+        vis[pos] = 1;
+        freeSeen++;
+        pos = fn.children[0];
+    }
+    if (freeSeen != freeCount) {
+        if (verbose) cout << "Contagem da lista de livres (" << freeCount << ") difere do encadeamento ("
+                          << freeSeen << ")." << endl;
+        return false;
+    }
+
+    if (rt == 0) {
+        if (totalNodes != freeSeen) {
+            if (verbose) cout << "Raiz vazia, mas existem nos gravados (" << totalNodes - freeSeen << ")." << endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Faixa aberta (low, high) da subárvore; hasLow/hasHigh = false indica faixa sem limite desse lado.
+    struct Item { int pos; Key low; Key high; bool hasLow; bool hasHigh; };
+    queue<Item> q;
+    if (vis[rt]) {
+        if (verbose) cout << "Raiz " << rt << " esta na lista de livres." << endl;
+        return false;
+    }
+    q.push({rt, Key{}, Key{}, false, false});
+    vis[rt] = 1;
+
+    int minK = minKeys();
+    while (!q.empty()) {
+        auto it = q.front(); q.pop();
+        Node node;
+        if (!readAt(it.pos, node)) {
+            if (verbose) cout << "Falha ao ler no " << it.pos << "." << endl;
+            return false;
+        }
+        if (node.n < 0 || node.n > m - 1) {
+            if (verbose) cout << "No " << it.pos << " com n fora de [0," << (m - 1) << "]." << endl;
+            return false;
+        }
+        for (int i = 0; i < node.n; ++i) {
+            if (i > 0 && !keyLess(node.keys[i - 1], node.keys[i])) {
+                if (verbose) cout << "Chaves nao estritamente crescentes no no " << it.pos << "." << endl;
+                return false;
+            }
+            if ((it.hasLow && !keyLess(it.low, node.keys[i])) || (it.hasHigh && !keyLess(node.keys[i], it.high))) {
+                if (verbose) {
+                    cout << "Chave " << node.keys[i] << " do no " << it.pos << " fora da faixa (";
+                    if (it.hasLow) cout << it.low; else cout << "-inf";
+                    cout << ",";
+                    if (it.hasHigh) cout << it.high; else cout << "+inf";
+                    cout << ")." << endl;
+                }
+                return false;
+            }
+        }
+        for (int i = 0; i <= node.n; ++i) {
+            int c = node.children[i];
+            if (!childInRange(c)) {
+                if (verbose) cout << "Filho fora do intervalo (A" << i << "=" << c << ") no no " << it.pos << "." << endl;
+                return false;
+            }
+            if (c != 0) {
+                Item child{c, it.low, it.high, it.hasLow, it.hasHigh};
+                if (i > 0) {
+                    child.low = node.keys[i - 1];
+                    child.hasLow = true;
+                }
+                if (i < node.n) {
+                    child.high = node.keys[i];
+                    child.hasHigh = true;
+                }
+                if (!vis[c]) {
+                    vis[c] = 1;
+                    q.push(child);
+                } else {
+                    if (verbose) cout << "No " << c << " referenciado mais de uma vez ou presente na lista de livres." << endl;
+                    return false;
+                }
+            }
+        }
+        if (it.pos != rt) {
+            bool leaf = (node.children[0] == 0);
+            if (!leaf && node.n < minK) {
+                if (verbose) cout << "No interno " << it.pos << " com n < minKeys (" << minK << ")." << endl;
+                return false;
+            }
+            if (leaf && node.n < 1) {
+                if (verbose) cout << "Folha nao-raiz " << it.pos << " com n=0." << endl;
+                return false;
+            }
+        }
+    }
+    for (int pos = 1; pos <= totalNodes; ++pos) {
+        if (!vis[pos]) {
+            if (verbose) cout << "No " << pos << " nao alcancavel a partir da raiz nem presente na lista de livres." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,71 @@
+/**
+* @file Metrics.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "Metrics.h"
+#include <algorithm>
+#include <bit>
+
+using namespace std;
+
+/**
+ * @brief Faixa do valor: abaixo de 32, o próprio valor; senão (expoente - 4) * 32 + os 5 bits após o mais alto.
+ */
+int LatencyHistogram::bucketOf(uint64_t v) {
+    if (v < static_cast<uint64_t>(SUB_BUCKETS)) return static_cast<int>(v);
+    int exponent = 63 - countl_zero(v);
+    int shift = exponent - SUB_BITS;
+    int sub = static_cast<int>((v >> shift) & (SUB_BUCKETS - 1));
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::highestIn(int bucket) {
+    if (bucket < SUB_BUCKETS) return static_cast<uint64_t>(bucket);
+    int shift = bucket / SUB_BUCKETS - 1;
+    uint64_t sub = static_cast<uint64_t>(bucket % SUB_BUCKETS);
+    uint64_t low = (static_cast<uint64_t>(SUB_BUCKETS) + sub) << shift;
+    return low + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    counts[static_cast<size_t>(bucketOf(ns))]++;
+    total++;
+    sum += ns;
+    minValue = std::min(minValue, ns);
+    maxValue = std::max(maxValue, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    total += other.total;
+    sum += other.sum;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+void LatencyHistogram::reset() {
+    *this = LatencyHistogram{};
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (total == 0) return 0;
+    p = std::clamp(p, 0.0, 1.0);
+    long long rank = std::max(1LL, static_cast<long long>(p * static_cast<double>(total) + 0.5));
+    long long seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(highestIn(static_cast<int>(i)), maxValue);
+    }
+    return maxValue;
+}
+
+void LatencyHistogram::writeJson(ostream& os) const {
+    os << "{\"count\":" << total << ",\"min\":" << min() << ",\"mean\":" << static_cast<long long>(mean())
+       << ",\"p50\":" << percentile(0.50) << ",\"p90\":" << percentile(0.90) << ",\"p99\":" << percentile(0.99)
+       << ",\"p999\":" << percentile(0.999) << ",\"max\":" << maxValue << "}";
+}
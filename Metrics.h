@@ -0,0 +1,105 @@
+/**
+* @file Metrics.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Histograma de latências (ns) no estilo HDR: faixas log-lineares com erro relativo de até 1/32.
+ * @details Valores abaixo de 32 ficam em faixas unitárias; acima, cada potência de 2 é dividida em 32 faixas
+ *          iguais. Registrar é O(1) sem alocação; percentis devolvem o maior valor da faixa correspondente
+ *          (limitado ao máximo observado).
+ */
+class LatencyHistogram {
+public:
+    void record(std::uint64_t ns);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    long long count() const { return total; }
+    std::uint64_t min() const { return total ? minValue : 0; }
+    std::uint64_t max() const { return maxValue; }
+    double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+
+    /**
+     * @brief Valor no percentil p (0..1); 0 se vazio.
+     */
+    std::uint64_t percentile(double p) const;
+
+    /**
+     * @brief Grava {"count","min","mean","p50","p90","p99","p999","max"} em ns.
+     */
+    void writeJson(std::ostream& os) const;
+
+private:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    static int bucketOf(std::uint64_t v);
+    static std::uint64_t highestIn(int bucket);
+
+    std::array<long long, BUCKETS> counts{};
+    long long total = 0;
+    long double sum = 0;
+    std::uint64_t minValue = UINT64_MAX;
+    std::uint64_t maxValue = 0;
+};
+
+/**
+ * @brief Métricas acumuladas de um tipo de operação: quantidade, soma dos contadores, contadores da última
+ *        operação e histograma de latência.
+ * @details Counters precisa de operator+= e de forEach(f), que chama f(nome, valor) para cada campo.
+ */
+template <class Counters>
+struct OperationMetrics {
+    long long ops = 0;
+    Counters totals{};
+    Counters last{};
+    LatencyHistogram latency;
+
+    void record(const Counters& c, std::uint64_t ns) {
+        ops++;
+        totals += c;
+        last = c;
+        latency.record(ns);
+    }
+
+    void reset() { *this = OperationMetrics{}; }
+
+    /**
+     * @brief {"ops":N,"totals":{...},"last":{...},"latency_ns":{...}}
+     */
+    void writeJson(std::ostream& os) const {
+        os << "{\"ops\":" << ops << ",\"totals\":";
+        writeCounters(os, totals);
+        os << ",\"last\":";
+        writeCounters(os, last);
+        os << ",\"latency_ns\":";
+        latency.writeJson(os);
+        os << "}";
+    }
+
+private:
+    static void writeCounters(std::ostream& os, const Counters& c) {
+        os << "{";
+        bool first = true;
+        c.forEach([&](const char* name, long long value) {
+            os << (first ? "" : ",") << "\"" << name << "\":" << value;
+            first = false;
+        });
+        os << "}";
+    }
+};
+
+#endif
@@ -0,0 +1,55 @@
+/**
+* @file NameIndex.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "NameIndex.h"
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief nome + '\0' + registro big-endian: a ordem dos bytes coincide com a ordem (nome, registro).
+ */
+std::string NameIndex::makeKey(std::string_view nome, int recNo) {
+    string key(nome);
+    key.push_back('\0');
+    uint32_t r = static_cast<uint32_t>(recNo);
+    for (int shift = 24; shift >= 0; shift -= 8) key.push_back(static_cast<char>((r >> shift) & 0xFF));
+    return key;
+}
+
+bool NameIndex::build(DataFile& data, const std::string& path, int pageSize) {
+    vector<pair<string,int>> names;
+    if (!data.listActiveNames(names)) return false;
+    vector<pair<string,int>> entries;
+    entries.reserve(names.size());
+    for (const auto& [nome, recNo] : names) entries.emplace_back(makeKey(nome, recNo), recNo);
+    return StringTree::createEmpty(path, pageSize) && tree.open(path) && tree.bulkLoad(std::move(entries));
+}
+
+bool NameIndex::open(const std::string& path) {
+    return tree.open(path);
+}
+
+bool NameIndex::add(std::string_view nome, int recNo) {
+    return tree.insertB(makeKey(nome, recNo), recNo);
+}
+
+bool NameIndex::remove(std::string_view nome, int recNo) {
+    return tree.deleteB(makeKey(nome, recNo));
+}
+
+std::size_t NameIndex::find(std::string_view nome, std::vector<int>& outRecNos) {
+    outRecNos.clear();
+    string prefix(nome);
+    prefix.push_back('\0');
+    return tree.scanPrefix(prefix, [&](string_view, int recNo) {
+        outRecNos.push_back(recNo);
+        return true;
+    });
+}
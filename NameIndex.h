@@ -0,0 +1,80 @@
+/**
+* @file NameIndex.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include "DataFile.h"
+#include "StringTree.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Índice secundário por nome de funcionario sobre o data.bin (arquivo data.bin.names).
+ * @details Cada entrada do StringTree é a chave composta nome + '\0' + número do registro em big-endian,
+ *          que mantém as chaves únicas com nomes repetidos e agrupa, em ordem de registro, todos os
+ *          funcionarios de um mesmo nome; a busca por nome é uma varredura por esse prefixo.
+ */
+class NameIndex {
+public:
+    static std::string pathFor(const std::string& dataFilename) { return dataFilename + ".names"; }
+
+    /**
+     * @brief Chave composta (nome, registro) gravada no índice.
+     */
+    static std::string makeKey(std::string_view nome, int recNo);
+
+    /**
+     * @brief (Re)constrói o índice a partir dos funcionarios ativos do data.bin, por carga em lote.
+     * @param data Arquivo de dados aberto.
+     * @param path Caminho do índice (sobrescrito).
+     * @param pageSize Tamanho da página do índice.
+     * @return true em caso de sucesso.
+     */
+    bool build(DataFile& data, const std::string& path, int pageSize = STRING_PAGE_DEFAULT);
+
+    /**
+     * @brief Abre um índice já construído.
+     */
+    bool open(const std::string& path);
+
+    void close() { tree.close(); }
+    bool isOpen() const { return tree.isOpen(); }
+
+    /**
+     * @brief Registra o funcionario recém-inserido no data.bin.
+     * @return false se o nome for longo demais ou houver falha de I/O.
+     */
+    bool add(std::string_view nome, int recNo);
+
+    /**
+     * @brief Retira a entrada (nome, registro) do índice.
+     * @return true se a entrada existia.
+     */
+    bool remove(std::string_view nome, int recNo);
+
+    /**
+     * @brief Números dos registros com exatamente esse nome, em ordem crescente.
+     * @param nome Nome procurado.
+     * @param outRecNos Vetor de saída.
+     * @return Quantidade encontrada.
+     */
+    std::size_t find(std::string_view nome, std::vector<int>& outRecNos);
+
+    /**
+     * @brief Acesso ao índice de texto (estatísticas, integridade, contadores).
+     */
+    StringTree& index() { return tree; }
+
+private:
+    StringTree tree;
+};
+
+#endif
@@ -0,0 +1,44 @@
+/**
+* @file Node.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef NODE_H
+#define NODE_H
+
+const int MAX_M = 32;
+const int NO_RECORD = -1;
+const int FREE_NODE = -2; // n de um nó na lista de livres; children[0] = próximo livre
+
+/**
+ * @brief Nó da árvore M-vias persistido no arquivo.
+ * @details n = número de chaves válidas; keys[0..n-1] estritamente crescentes;
+ *          recs[0..n-1] são os números dos registros das chaves em data.bin (NO_RECORD = desconhecido);
+ *          children[0..n] são posições lógicas dos filhos (0 = inexistente).
+ *          Posição 0 do arquivo é reservada ao header da árvore. Key é o tipo da chave e MaxM a maior
+ *          ordem representável (capacidade dos vetores, fixada em tempo de compilação).
+ */
+template <class Key, int MaxM = MAX_M>
+struct BasicNode {
+    int n;
+    Key keys[MaxM];
+    int recs[MaxM];
+    int children[MaxM+1];
+    /**
+     * @brief Constrói nó vazio (n=0) com arrays zerados e recs = NO_RECORD.
+     */
+    BasicNode() : n(0), keys{}, children{} {
+        for (int& r : recs) r = NO_RECORD;
+    }
+};
+
+/**
+ * @brief Nó com chaves int (índice original).
+ */
+using Node = BasicNode<int>;
+
+#endif
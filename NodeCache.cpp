@@ -0,0 +1,16 @@
+/**
+* @file NodeCache.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "NodeCache.tpp"
+
+using namespace std;
+
+template class NodeCache<BasicNode<std::int32_t>>;
+template class NodeCache<BasicNode<std::int64_t>>;
+template class NodeCache<BasicNode<Key16>>;
@@ -0,0 +1,172 @@
+/**
+* @file NodeCache.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef NODECACHE_H
+#define NODECACHE_H
+
+#include "KeyTypes.h"
+#include "Node.h"
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+/**
+ * @brief Cache de nós (buffer pool) de capacidade fixa com substituição LRU.
+ * @details Fica entre MWayTree::readNode/writeNode e o arquivo. Cada entrada guarda uma cópia do nó,
+ *          um contador de pins (entradas fixadas nunca são despejadas) e um bit de sujo. Ao despejar
+ *          uma entrada suja, o callback de write-back é chamado antes de descartá-la. NodeT é o tipo de nó
+ *          da árvore (instanciado para os nós das chaves int32, int64 e Key16).
+ */
+template <class NodeT = Node>
+class NodeCache {
+public:
+    /**
+     * @brief Callback usado para gravar no arquivo um nó sujo despejado ou descarregado.
+     */
+    using WriteBack = std::function<void(int position, const NodeT& node)>;
+
+    /**
+     * @brief Constrói cache com capacidade em número de nós.
+     * @param capacityNodes Quantidade máxima de nós (0 desativa o cache).
+     */
+    explicit NodeCache(std::size_t capacityNodes = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Converte um orçamento em bytes na quantidade de nós que cabe nele.
+     * @param bytes Orçamento de memória.
+     * @return Número de nós (entradas) correspondente.
+     */
+    static std::size_t nodesForBytes(std::size_t bytes);
+
+    /**
+     * @brief Define o callback de write-back para entradas sujas.
+     * @param cb Função chamada com (posição, nó).
+     */
+    void setWriteBack(WriteBack cb);
+
+    /**
+     * @brief Altera a capacidade, despejando entradas excedentes (LRU, não fixadas).
+     * @param capacityNodes Nova capacidade em nós.
+     */
+    void setCapacity(std::size_t capacityNodes);
+
+    std::size_t capacity() const { return cap; }
+    std::size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Procura o nó no cache; em caso de acerto copia para out e promove a entrada (MRU).
+     * @param position Posição lógica do nó.
+     * @param out Saída: cópia do nó.
+     * @return true em caso de acerto.
+     */
+    bool get(int position, NodeT& out);
+
+    /**
+     * @brief Testa se o nó está no cache, sem contar acerto/falta nem promover a entrada.
+     */
+    bool contains(int position) const { return entries.count(position) != 0; }
+
+    /**
+     * @brief Endereço do nó no cache (nullptr se ausente), sem contar acerto/falta nem promover a entrada.
+     * @details Serve só para antecipar a linha de cache do nó; o ponteiro deixa de valer no próximo put().
+     */
+    const NodeT* peek(int position) const {
+        auto it = entries.find(position);
+        return it == entries.end() ? nullptr : &it->second->node;
+    }
+
+    /**
+     * @brief Insere ou atualiza uma entrada, despejando a LRU se necessário.
+     * @param position Posição lógica do nó.
+     * @param node Conteúdo do nó.
+     * @param dirty true se o conteúdo ainda não foi gravado no arquivo.
+     */
+    void put(int position, const NodeT& node, bool dirty);
+
+    /**
+     * @brief Fixa a entrada (se presente), impedindo seu despejo.
+     * @param position Posição lógica do nó.
+     * @return true se a entrada estava no cache.
+     */
+    bool pin(int position);
+
+    /**
+     * @brief Libera um pin previamente obtido com pin().
+     * @param position Posição lógica do nó.
+     */
+    void unpin(int position);
+
+    /**
+     * @brief Remove a entrada sem gravá-la (mesmo se suja).
+     * @param position Posição lógica do nó.
+     */
+    void invalidate(int position);
+
+    /**
+     * @brief Grava todas as entradas sujas via write-back (em ordem crescente de posição) e as marca limpas.
+     * @return Quantidade de nós gravados.
+     */
+    std::size_t flushDirty();
+
+    /**
+     * @brief Quantidade de entradas sujas no momento.
+     */
+    std::size_t dirtyCount() const { return dirty; }
+
+    /**
+     * @brief Descarta todas as entradas (sem write-back).
+     */
+    void clear();
+
+    long long getHits() const { return hits; }
+    long long getMisses() const { return misses; }
+    long long getEvictions() const { return evictions; }
+
+    /**
+     * @brief Zera contadores de acertos/faltas/despejos.
+     */
+    void resetCounters();
+
+    /**
+     * @brief Capacidade padrão em nós.
+     */
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+private:
+    struct Entry {
+        int position;
+        NodeT node;
+        int pins = 0;
+        bool dirty = false;
+    };
+
+    std::size_t cap;
+    std::list<Entry> lru; // frente = MRU, fundo = LRU
+    std::unordered_map<int, typename std::list<Entry>::iterator> entries;
+    WriteBack writeBack;
+    std::size_t dirty = 0;
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+
+    /**
+     * @brief Despeja entradas LRU não fixadas até size() <= limit.
+     * @param limit Tamanho alvo.
+     */
+    void evictTo(std::size_t limit);
+};
+
+// Instanciações em NodeCache.cpp: nós das chaves int32, int64 e Key16 (MaxM = MAX_M);
+// para outro tipo de nó, inclua NodeCache.tpp.
+extern template class NodeCache<BasicNode<std::int32_t>>;
+extern template class NodeCache<BasicNode<std::int64_t>>;
+extern template class NodeCache<BasicNode<Key16>>;
+
+#endif
@@ -0,0 +1,172 @@
+/**
+* @file NodeCache.tpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef NODECACHE_TPP
+#define NODECACHE_TPP
+
+#include "NodeCache.h"
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+template <class NodeT>
+NodeCache<NodeT>::NodeCache(size_t capacityNodes) : cap(capacityNodes) {
+    entries.reserve(cap);
+}
+
+/**
+ * @brief Converte orçamento em bytes para número de entradas (nó + overhead da lista/mapa).
+ * @param bytes Orçamento de memória.
+ * @return Número de nós que cabem no orçamento.
+ */
+template <class NodeT>
+size_t NodeCache<NodeT>::nodesForBytes(size_t bytes) {
+    const size_t perEntry = sizeof(Entry) + 4 * sizeof(void*);
+    return bytes / perEntry;
+}
+
+template <class NodeT>
+void NodeCache<NodeT>::setWriteBack(WriteBack cb) {
+    writeBack = std::move(cb);
+}
+
+template <class NodeT>
+void NodeCache<NodeT>::setCapacity(size_t capacityNodes) {
+    cap = capacityNodes;
+    evictTo(cap);
+}
+
+/**
+ * @brief Consulta o cache; promove a entrada para MRU em caso de acerto.
+ * @param position Posição lógica.
+ * @param out Saída: cópia do nó.
+ * @return true em caso de acerto.
+ */
+template <class NodeT>
+bool NodeCache<NodeT>::get(int position, NodeT& out) {
+    auto it = entries.find(position);
+    if (it == entries.end()) {
+        misses++;
+        return false;
+    }
+    hits++;
+    lru.splice(lru.begin(), lru, it->second);
+    out = it->second->node;
+    return true;
+}
+
+/**
+ * @brief Insere/atualiza entrada como MRU; despeja LRU não fixada se exceder a capacidade.
+ * @param position Posição lógica.
+ * @param node Conteúdo do nó.
+ * @param isDirty true se ainda não persistido.
+ */
+template <class NodeT>
+void NodeCache<NodeT>::put(int position, const NodeT& node, bool isDirty) {
+    if (cap == 0) {
+        if (isDirty && writeBack) writeBack(position, node);
+        return;
+    }
+    auto it = entries.find(position);
+    if (it != entries.end()) {
+        auto e = it->second;
+        e->node = node;
+        if (isDirty && !e->dirty) dirty++;
+        else if (!isDirty && e->dirty) dirty--;
+        e->dirty = isDirty;
+        lru.splice(lru.begin(), lru, e);
+        return;
+    }
+    evictTo(cap - 1);
+    lru.push_front(Entry{position, node, 0, isDirty});
+    entries[position] = lru.begin();
+    if (isDirty) dirty++;
+}
+
+template <class NodeT>
+bool NodeCache<NodeT>::pin(int position) {
+    auto it = entries.find(position);
+    if (it == entries.end()) return false;
+    it->second->pins++;
+    return true;
+}
+
+template <class NodeT>
+void NodeCache<NodeT>::unpin(int position) {
+    auto it = entries.find(position);
+    if (it == entries.end()) return;
+    if (it->second->pins > 0) it->second->pins--;
+}
+
+template <class NodeT>
+void NodeCache<NodeT>::invalidate(int position) {
+    auto it = entries.find(position);
+    if (it == entries.end()) return;
+    if (it->second->dirty) dirty--;
+    lru.erase(it->second);
+    entries.erase(it);
+}
+
+/**
+ * @brief Grava entradas sujas em ordem de posição (escrita sequencial no arquivo).
+ * @return Número de nós gravados.
+ */
+template <class NodeT>
+size_t NodeCache<NodeT>::flushDirty() {
+    if (dirty == 0) return 0;
+    vector<Entry*> pending;
+    pending.reserve(dirty);
+    for (auto& e : lru) {
+        if (e.dirty) pending.push_back(&e);
+    }
+    sort(pending.begin(), pending.end(), [](const Entry* a, const Entry* b) { return a->position < b->position; });
+    for (Entry* e : pending) {
+        if (writeBack) writeBack(e->position, e->node);
+        e->dirty = false;
+    }
+    dirty = 0;
+    return pending.size();
+}
+
+template <class NodeT>
+void NodeCache<NodeT>::clear() {
+    lru.clear();
+    entries.clear();
+    dirty = 0;
+}
+
+template <class NodeT>
+void NodeCache<NodeT>::resetCounters() {
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
+/**
+ * @brief Despeja a partir do fundo da lista (LRU), pulando entradas fixadas; sujas passam pelo write-back.
+ * @param limit Tamanho alvo.
+ */
+template <class NodeT>
+void NodeCache<NodeT>::evictTo(size_t limit) {
+    auto it = lru.end();
+    while (entries.size() > limit && it != lru.begin()) {
+        --it;
+        if (it->pins > 0) continue;
+        if (it->dirty) {
+            if (writeBack) writeBack(it->position, it->node);
+            dirty--;
+        }
+        entries.erase(it->position);
+        it = lru.erase(it);
+        evictions++;
+    }
+}
+
+#endif
@@ -0,0 +1,203 @@
+/**
+* @file NodeFormat.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "NodeFormat.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Layout do formato antigo (versão 1): nó fixo com MAX_M=32 slots, header com n=-1.
+ */
+struct LegacyNode {
+    int n;
+    int keys[32];
+    int children[33];
+};
+
+int alignUp(int bytes, int align) {
+    return (bytes + align - 1) / align * align;
+}
+
+/**
+ * @brief Testa se o layout de chave gravado no header é um dos suportados.
+ */
+bool validKeyLayout(const KeyLayout& key) {
+    switch (key.type) {
+    case KEY_INT32: return key.bytes == 4;
+    case KEY_INT64: return key.bytes == 8;
+    case KEY_FIXED_STRING: return key.bytes >= 1 && key.bytes <= 256;
+    default: return false;
+    }
+}
+
+/**
+ * @brief Alinhamento exigido pelo tipo de chave (texto de largura fixa não exige alinhamento).
+ */
+int alignFor(int keyType) {
+    return keyType == KEY_INT64 ? 8 : (keyType == KEY_FIXED_STRING ? 1 : 4);
+}
+
+}
+
+/**
+ * @brief n (4 bytes), keys alinhado à chave, recs e children alinhados a 4; o total é arredondado ao
+ *        alinhamento da chave para que todos os registros do arquivo fiquem alinhados.
+ */
+int NodeFormat::layoutRecord(int order, int ver, KeyLayout key) {
+    version = ver;
+    m = order;
+    keyType = key.type;
+    keyBytes = key.bytes;
+    keyAlign = key.align < 4 ? 4 : key.align;
+    keyOffset = alignUp(4, keyAlign);
+    recOffset = alignUp(keyOffset + keyBytes * (order - 1), 4);
+    childOffset = recOffset + (ver >= 3 ? 4 * (order - 1) : 0);
+    return alignUp(childOffset + 4 * order, keyAlign);
+}
+
+int NodeFormat::recordBytes(int order, int ver, KeyLayout key) {
+    NodeFormat f;
+    return f.layoutRecord(order, ver, key);
+}
+
+NodeFormat NodeFormat::compact(int order, int ver, KeyLayout key) {
+    NodeFormat f;
+    f.pageSize = 0;
+    f.stride = f.layoutRecord(order, ver, key);
+    f.dataStart = HEADER_BYTES;
+    return f;
+}
+
+NodeFormat NodeFormat::paged(int order, int page, int ver, KeyLayout key) {
+    NodeFormat f;
+    int bytes = f.layoutRecord(order, ver, key);
+    f.pageSize = page;
+    f.stride = (page >= HEADER_BYTES && (f.keyAlign <= 4 || page % f.keyAlign == 0) && bytes <= page) ? page : 0;
+    f.dataStart = page;
+    return f;
+}
+
+/**
+ * @brief Ordem derivada da página: maior m com recordBytes(m) <= page, limitada a maxOrder
+ *        (para chaves int32, recordBytes(m) = 12m-4).
+ * @param page Tamanho da página.
+ * @param key Layout da chave.
+ * @param maxOrder Maior ordem aceita.
+ * @return Ordem ou 0 se a página não comportar m=3.
+ */
+int NodeFormat::orderForPage(int page, KeyLayout key, int maxOrder) {
+    if (page < HEADER_BYTES) return 0;
+    int ord = maxOrder;
+    while (ord >= 3 && recordBytes(ord, FORMAT_VERSION, key) > page) ord--;
+    return ord < 3 ? 0 : ord;
+}
+
+int NodeFormat::positionsIn(long long fileSize) const {
+    if (stride <= 0 || fileSize <= dataStart) return 0;
+    return static_cast<int>((fileSize - dataStart) / stride);
+}
+
+void NodeFormat::encodeHeader(int root, char* buf, int freeHead, int freeCount) const {
+    FileHeader hdr{};
+    hdr.magic = FORMAT_MAGIC;
+    hdr.version = version;
+    hdr.m = m;
+    hdr.root = root;
+    hdr.pageSize = pageSize;
+    hdr.recordSize = stride;
+    hdr.freeHead = freeHead;
+    hdr.freeCount = freeCount;
+    hdr.keyType = keyType;
+    hdr.keyBytes = (keyType == KEY_INT32) ? 0 : keyBytes;
+    memcpy(buf, &hdr, sizeof(hdr));
+}
+
+bool NodeFormat::decodeHeader(const char* buf, NodeFormat& out, int& outRoot, int maxOrder) {
+    FileHeader hdr{};
+    if (!decodeHeader(buf, out, hdr, maxOrder)) return false;
+    outRoot = hdr.root;
+    return true;
+}
+
+bool NodeFormat::decodeHeader(const char* buf, NodeFormat& out, FileHeader& outHdr, int maxOrder) {
+    FileHeader hdr{};
+    memcpy(&hdr, buf, sizeof(hdr));
+    if (hdr.magic != FORMAT_MAGIC || hdr.version < 2 || hdr.version > FORMAT_VERSION) return false;
+    if (hdr.m < 3 || hdr.m > maxOrder) return false;
+    KeyLayout key{hdr.keyType, hdr.keyBytes, alignFor(hdr.keyType)};
+    if (key.type == KEY_INT32 && key.bytes == 0) key.bytes = 4;
+    if (!validKeyLayout(key)) return false;
+    NodeFormat f = (hdr.pageSize > 0) ? paged(hdr.m, hdr.pageSize, hdr.version, key)
+                                      : compact(hdr.m, hdr.version, key);
+    if (f.stride == 0 || f.stride != hdr.recordSize) return false;
+    if (hdr.freeHead < 0 || hdr.freeCount < 0) return false;
+    out = f;
+    outHdr = hdr;
+    return true;
+}
+
+bool NodeFormat::isLegacyFile(const std::string& binFilename) {
+    ifstream in(binFilename, ios::binary);
+    if (!in.is_open()) return false;
+    LegacyNode hdr{};
+    in.read(reinterpret_cast<char*>(&hdr), sizeof(LegacyNode));
+    return in.good() && hdr.n == -1 && hdr.keys[0] >= 3 && hdr.keys[0] <= MAX_M;
+}
+
+/**
+ * @brief Lê todos os nós antigos em memória e regrava no layout versionado (mesmas posições lógicas).
+ * @param legacyBin Caminho do .bin antigo.
+ * @param outBin Caminho de saída (escrito via arquivo temporário + rename).
+ * @param page Tamanho de página (0 = compacto).
+ * @return true em caso de sucesso.
+ */
+bool NodeFormat::convertLegacy(const std::string& legacyBin, const std::string& outBin, int page) {
+    ifstream in(legacyBin, ios::binary);
+    if (!in.is_open()) return false;
+    LegacyNode hdr{};
+    if (!in.read(reinterpret_cast<char*>(&hdr), sizeof(LegacyNode))) return false;
+    if (hdr.n != -1) return false;
+    int ord = hdr.keys[0];
+    if (ord < 3 || ord > MAX_M) return false;
+
+    vector<LegacyNode> nodes;
+    LegacyNode ln{};
+    while (in.read(reinterpret_cast<char*>(&ln), sizeof(LegacyNode))) nodes.push_back(ln);
+    in.close();
+
+    NodeFormat f = (page > 0) ? paged(ord, page) : compact(ord);
+    if (f.stride == 0) return false;
+
+    string tmp = outBin + ".tmp";
+    ofstream out(tmp, ios::binary | ios::trunc);
+    if (!out.is_open()) return false;
+    vector<char> buf(static_cast<size_t>(f.dataStart > f.stride ? f.dataStart : f.stride));
+    f.encodeHeader(hdr.children[0], buf.data());
+    out.write(buf.data(), f.dataStart);
+    for (const auto& l : nodes) {
+        Node node{};
+        node.n = l.n;
+        for (int i = 0; i < ord - 1; ++i) node.keys[i] = l.keys[i];
+        for (int i = 0; i < ord; ++i) node.children[i] = l.children[i];
+        f.encode(node, buf.data());
+        out.write(buf.data(), f.stride);
+    }
+    out.close();
+    if (!out) return false;
+
+    error_code ec;
+    filesystem::rename(tmp, outBin, ec);
+    return !ec;
+}
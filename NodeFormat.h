@@ -0,0 +1,190 @@
+/**
+* @file NodeFormat.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef NODEFORMAT_H
+#define NODEFORMAT_H
+
+#include "KeyTypes.h"
+#include "Node.h"
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+const int FORMAT_MAGIC = 0x5941574D; // "MWAY" em little-endian
+const int FORMAT_VERSION = 3;
+const int HEADER_BYTES = 64;
+
+/**
+ * @brief Header persistido no início do índice (formato versionado).
+ * @details Ocupa HEADER_BYTES no formato compacto; no formato paginado ocupa a primeira página inteira.
+ *          Campos reservados ficam zerados para extensões futuras do formato. keyType/keyBytes ocupam os dois
+ *          primeiros campos antes reservados: índices int32 gravam ambos zerados, como os arquivos anteriores.
+ */
+struct FileHeader {
+    int magic;
+    int version;
+    int m;
+    int root;
+    int pageSize;   // 0 = registros compactos; >0 = cada nó ocupa uma página deste tamanho
+    int recordSize; // bytes entre nós consecutivos (stride)
+    int freeHead;   // primeiro nó da lista de livres (0 = vazia)
+    int freeCount;  // quantidade de nós na lista de livres
+    int keyType;    // KeyType das chaves (0 = int32)
+    int keyBytes;   // largura da chave em bytes (0 = 4, int32)
+    int reserved[6];
+};
+static_assert(sizeof(FileHeader) == HEADER_BYTES, "FileHeader deve ocupar HEADER_BYTES");
+
+/**
+ * @brief Layout em disco dos nós, dimensionado pela ordem m gravada no header.
+ * @details Registro de nó: n (int), keys[m-1], recs[m-1], children[m]; nó lógico p (>=1) fica em
+ *          dataStart + (p-1)*stride. No formato compacto stride = tamanho do registro; no paginado
+ *          stride = pageSize e os nós ficam alinhados à página. A versão 2 (sem recs) continua legível;
+ *          nesse caso os ponteiros de registro são lidos como NO_RECORD. Cada chave ocupa keyBytes; keys
+ *          começa alinhado a keyAlign e o registro é arredondado para keyAlign (com chaves int32 o layout é
+ *          exatamente o original: keyOffset = 4, sem padding).
+ */
+struct NodeFormat {
+    int version = FORMAT_VERSION;
+    int m = 3;
+    int pageSize = 0;
+    int stride = 0;
+    long long dataStart = HEADER_BYTES;
+    int keyType = KEY_INT32;
+    int keyBytes = 4;
+    int keyAlign = 4;
+    int keyOffset = 4;   // início de keys no registro
+    int recOffset = 0;   // início de recs (versão 3)
+    int childOffset = 0; // início de children
+
+    /**
+     * @brief Layout compacto para a ordem m.
+     * @param order Ordem m (já validada).
+     * @param ver Versão do formato (2 ou 3).
+     * @param key Layout da chave (padrão: int32).
+     */
+    static NodeFormat compact(int order, int ver = FORMAT_VERSION, KeyLayout key = {});
+
+    /**
+     * @brief Layout paginado: cada nó ocupa uma página; m é o informado (deve caber na página).
+     * @param order Ordem m.
+     * @param page Tamanho da página em bytes.
+     * @param ver Versão do formato (2 ou 3).
+     * @param key Layout da chave (padrão: int32).
+     * @return Layout; stride = 0 se m não couber na página ou a página não respeitar o alinhamento da chave.
+     */
+    static NodeFormat paged(int order, int page, int ver = FORMAT_VERSION, KeyLayout key = {});
+
+    /**
+     * @brief Maior ordem cujo registro cabe na página (limitada a [3..maxOrder]).
+     * @param page Tamanho da página em bytes.
+     * @param key Layout da chave (padrão: int32).
+     * @param maxOrder Maior ordem aceita (capacidade do nó em memória).
+     * @return Ordem derivada ou 0 se a página for pequena demais.
+     */
+    static int orderForPage(int page, KeyLayout key = {}, int maxOrder = MAX_M);
+
+    /**
+     * @brief Bytes de um registro de nó para a ordem m (com o padding de alinhamento da chave).
+     */
+    static int recordBytes(int order, int ver = FORMAT_VERSION, KeyLayout key = {});
+
+    /**
+     * @brief Layout da chave descrito pelo formato.
+     */
+    KeyLayout keyLayout() const { return {keyType, keyBytes, keyAlign}; }
+
+    /**
+     * @brief Deslocamento em bytes do nó lógico informado.
+     * @param position Posição lógica (>=1).
+     */
+    long long offsetOf(int position) const { return dataStart + static_cast<long long>(position - 1) * stride; }
+
+    /**
+     * @brief Quantidade de nós gravados em um arquivo com o tamanho informado.
+     * @param fileSize Tamanho do arquivo em bytes.
+     */
+    int positionsIn(long long fileSize) const;
+
+    /**
+     * @brief Serializa n, keys[0..m-2], recs[0..m-2] (versão 3) e children[0..m-1] em buf (stride bytes,
+     *        padding zerado). O tipo das chaves do nó deve ter keyBytes bytes.
+     */
+    template <class NodeT>
+    void encode(const NodeT& node, char* buf) const {
+        const std::size_t slots = static_cast<std::size_t>(m - 1);
+        std::memset(buf, 0, static_cast<std::size_t>(stride));
+        std::memcpy(buf, &node.n, 4);
+        std::memcpy(buf + keyOffset, node.keys, sizeof(node.keys[0]) * slots);
+        if (version >= 3) std::memcpy(buf + recOffset, node.recs, 4 * slots);
+        std::memcpy(buf + childOffset, node.children, 4 * static_cast<std::size_t>(m));
+    }
+
+    /**
+     * @brief Desserializa o nó a partir de buf (ao menos recordBytes(m) bytes).
+     */
+    template <class NodeT>
+    void decode(const char* buf, NodeT& node) const {
+        const std::size_t slots = static_cast<std::size_t>(m - 1);
+        std::memcpy(&node.n, buf, 4);
+        std::memcpy(node.keys, buf + keyOffset, sizeof(node.keys[0]) * slots);
+        if (version >= 3) std::memcpy(node.recs, buf + recOffset, 4 * slots);
+        std::memcpy(node.children, buf + childOffset, 4 * static_cast<std::size_t>(m));
+    }
+
+    /**
+     * @brief Monta o header (HEADER_BYTES) com a raiz e a lista de livres informadas; no formato paginado
+     *        o restante da primeira página permanece zerado.
+     */
+    void encodeHeader(int root, char* buf, int freeHead = 0, int freeCount = 0) const;
+
+    /**
+     * @brief Interpreta o header de um índice.
+     * @param buf Primeiros HEADER_BYTES do arquivo.
+     * @param out Saída: layout descrito pelo header.
+     * @param outRoot Saída: posição da raiz.
+     * @param maxOrder Maior ordem aceita (capacidade do nó em memória de quem abre o arquivo).
+     * @return true se magic/versão/ordem/layout (inclusive o da chave) forem válidos.
+     */
+    static bool decodeHeader(const char* buf, NodeFormat& out, int& outRoot, int maxOrder = MAX_M);
+
+    /**
+     * @brief Interpreta o header devolvendo também os demais campos (lista de livres).
+     * @param buf Primeiros HEADER_BYTES do arquivo.
+     * @param out Saída: layout descrito pelo header.
+     * @param outHdr Saída: campos do header.
+     * @param maxOrder Maior ordem aceita.
+     * @return true se válido.
+     */
+    static bool decodeHeader(const char* buf, NodeFormat& out, FileHeader& outHdr, int maxOrder = MAX_M);
+
+    /**
+     * @brief Testa se o arquivo está no formato antigo (nós fixos de MAX_M slots, header com n=-1).
+     * @param binFilename Caminho do .bin.
+     */
+    static bool isLegacyFile(const std::string& binFilename);
+
+    /**
+     * @brief Converte um índice no formato antigo para o formato versionado, preservando posições.
+     * @param legacyBin Caminho do .bin antigo.
+     * @param outBin Caminho do .bin de saída (pode ser igual ao de entrada).
+     * @param page Tamanho de página (0 = compacto).
+     * @return true em caso de sucesso.
+     */
+    static bool convertLegacy(const std::string& legacyBin, const std::string& outBin, int page = 0);
+
+private:
+    /**
+     * @brief Preenche versão, ordem e deslocamentos do registro para o layout de chave informado.
+     * @return Bytes do registro (já arredondados para o alinhamento da chave).
+     */
+    int layoutRecord(int order, int ver, KeyLayout key);
+};
+
+#endif
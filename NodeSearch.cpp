@@ -0,0 +1,166 @@
+/**
+* @file NodeSearch.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "NodeSearch.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NODESEARCH_X86 1
+#endif
+
+using namespace std;
+
+/**
+ * @brief Varredura linear (laço original de mSearch/insertB/deleteRecursive).
+ */
+int slotSearchScalar(const int* keys, int n, int key) {
+    int i = 0;
+    while (i < n && key > keys[i]) i++;
+    return i;
+}
+
+/**
+ * @brief Busca binária sem desvios: o intervalo cai pela metade com um select (cmov), sem laço dependente
+ *        do resultado das comparações.
+ */
+int slotSearchBranchless(const int* keys, int n, int key) {
+    if (n <= 0) return 0;
+    const int* base = keys;
+    int len = n;
+    while (len > 1) {
+        int half = len / 2;
+        base = (base[half - 1] < key) ? base + half : base;
+        len -= half;
+    }
+    return static_cast<int>(base - keys) + (*base < key);
+}
+
+#ifdef NODESEARCH_X86
+
+/**
+ * @brief Compara 4 chaves por vez (key > keys[j..j+3]) e soma os bits do movemask: como as chaves são
+ *        crescentes, a contagem é o slot. O número de iterações depende só de n (sem desvio pelo
+ *        resultado). Lê até o múltiplo de 4 seguinte a n (dentro de MAX_M); lanes além de n são mascaradas.
+ */
+__attribute__((target("sse2")))
+int slotSearchSSE(const int* keys, int n, int key) {
+    const __m128i kv = _mm_set1_epi32(key);
+    int count = 0;
+    for (int j = 0; j < n; j += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + j));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(kv, v)));
+        if (n - j < 4) mask &= (1 << (n - j)) - 1;
+        count += __builtin_popcount(static_cast<unsigned>(mask));
+    }
+    return count;
+}
+
+/**
+ * @brief Versão de 8 chaves por instrução (no máximo 4 iterações para MAX_M = 32).
+ */
+__attribute__((target("avx2")))
+int slotSearchAVX2(const int* keys, int n, int key) {
+    const __m256i kv = _mm256_set1_epi32(key);
+    int count = 0;
+    for (int j = 0; j < n; j += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + j));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(kv, v)));
+        if (n - j < 8) mask &= (1 << (n - j)) - 1;
+        count += __builtin_popcount(static_cast<unsigned>(mask));
+    }
+    return count;
+}
+
+#else
+
+int slotSearchSSE(const int* keys, int n, int key) { return slotSearchScalar(keys, n, key); }
+int slotSearchAVX2(const int* keys, int n, int key) { return slotSearchScalar(keys, n, key); }
+
+#endif
+
+bool searchKernelSupported(SearchKernel kernel) {
+#ifdef NODESEARCH_X86
+    __builtin_cpu_init();
+    if (kernel == SearchKernel::SSE) return __builtin_cpu_supports("sse2");
+    if (kernel == SearchKernel::AVX2) return __builtin_cpu_supports("avx2");
+    return true;
+#else
+    return kernel != SearchKernel::SSE && kernel != SearchKernel::AVX2;
+#endif
+}
+
+namespace {
+
+/**
+ * @brief Auto: AVX2 > SSE > Branchless.
+ */
+SearchKernel resolveAuto() {
+    if (searchKernelSupported(SearchKernel::AVX2)) return SearchKernel::AVX2;
+    if (searchKernelSupported(SearchKernel::SSE)) return SearchKernel::SSE;
+    return SearchKernel::Branchless;
+}
+
+SearchKernel activeKernel = SearchKernel::Scalar;
+
+/**
+ * @brief Kernel inicial: MWAYS_SEARCH_KERNEL, se definido e suportado; senão Auto.
+ */
+SlotSearchFn initialKernel() {
+    SearchKernel k = SearchKernel::Auto;
+    if (const char* env = getenv("MWAYS_SEARCH_KERNEL")) {
+        if (strcmp(env, "scalar") == 0) k = SearchKernel::Scalar;
+        else if (strcmp(env, "branchless") == 0) k = SearchKernel::Branchless;
+        else if (strcmp(env, "sse") == 0) k = SearchKernel::SSE;
+        else if (strcmp(env, "avx2") == 0) k = SearchKernel::AVX2;
+    }
+    if (!searchKernelSupported(k)) k = SearchKernel::Auto;
+    activeKernel = (k == SearchKernel::Auto) ? resolveAuto() : k;
+    return searchKernelFunction(activeKernel);
+}
+
+}
+
+SlotSearchFn searchKernelFunction(SearchKernel kernel) {
+    if (!searchKernelSupported(kernel)) return nullptr;
+    switch (kernel) {
+        case SearchKernel::Auto:       return searchKernelFunction(resolveAuto());
+        case SearchKernel::Scalar:     return slotSearchScalar;
+        case SearchKernel::Branchless: return slotSearchBranchless;
+        case SearchKernel::SSE:        return slotSearchSSE;
+        case SearchKernel::AVX2:       return slotSearchAVX2;
+    }
+    return nullptr;
+}
+
+SlotSearchFn activeSlotSearch = initialKernel();
+
+bool setSearchKernel(SearchKernel kernel) {
+    SlotSearchFn fn = searchKernelFunction(kernel);
+    if (!fn) return false;
+    activeKernel = (kernel == SearchKernel::Auto) ? resolveAuto() : kernel;
+    activeSlotSearch = fn;
+    return true;
+}
+
+SearchKernel activeSearchKernel() {
+    return activeKernel;
+}
+
+const char* searchKernelName(SearchKernel kernel) {
+    switch (kernel) {
+        case SearchKernel::Auto:       return "auto";
+        case SearchKernel::Scalar:     return "scalar";
+        case SearchKernel::Branchless: return "branchless";
+        case SearchKernel::SSE:        return "sse";
+        case SearchKernel::AVX2:       return "avx2";
+    }
+    return "?";
+}
@@ -0,0 +1,103 @@
+/**
+* @file NodeSearch.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef NODESEARCH_H
+#define NODESEARCH_H
+
+#include "Node.h"
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+/**
+ * @brief Kernels de busca dentro do nó (primeiro slot i com keys[i] >= key).
+ * @details Scalar = varredura linear original; Branchless = busca binária sem desvios dependentes dos dados;
+ *          SSE/AVX2 = comparação de 4/8 chaves por instrução com contagem via movemask. Auto escolhe,
+ *          em tempo de execução, o melhor suportado pela CPU (pode ser forçado pela variável de ambiente
+ *          MWAYS_SEARCH_KERNEL = scalar|branchless|sse|avx2).
+ */
+enum class SearchKernel { Auto, Scalar, Branchless, SSE, AVX2 };
+
+/**
+ * @brief Assinatura dos kernels: keys crescentes com n válidas; o vetor deve ser legível até o múltiplo de 8
+ *        seguinte a n (os kernels SIMD leem blocos inteiros).
+ * @return Primeiro i em [0..n] com keys[i] >= key (n se todas forem menores).
+ */
+using SlotSearchFn = int (*)(const int* keys, int n, int key);
+
+int slotSearchScalar(const int* keys, int n, int key);
+int slotSearchBranchless(const int* keys, int n, int key);
+int slotSearchSSE(const int* keys, int n, int key);
+int slotSearchAVX2(const int* keys, int n, int key);
+
+/**
+ * @brief Testa se a CPU suporta o kernel (Auto/Scalar/Branchless sempre suportados).
+ */
+bool searchKernelSupported(SearchKernel kernel);
+
+/**
+ * @brief Função correspondente ao kernel (Auto resolvido pela CPU); nullptr se não suportado.
+ */
+SlotSearchFn searchKernelFunction(SearchKernel kernel);
+
+/**
+ * @brief Seleciona o kernel usado por nodeSlot (ignorado se não suportado).
+ * @return true se o kernel foi ativado.
+ */
+bool setSearchKernel(SearchKernel kernel);
+
+/**
+ * @brief Kernel ativo (já resolvido; nunca Auto).
+ */
+SearchKernel activeSearchKernel();
+
+/**
+ * @brief Nome legível do kernel.
+ */
+const char* searchKernelName(SearchKernel kernel);
+
+extern SlotSearchFn activeSlotSearch;
+
+/**
+ * @brief Primeiro i com !comp(keys[i], key) em keys[0..n-1], para qualquer tipo de chave.
+ * @details Chaves inteiras usam a mesma busca binária sem desvios de slotSearchBranchless (a escolha de metade
+ *          vira cmov); as demais (texto de largura fixa, compostas) usam lower_bound com o comparador.
+ */
+template <class Key, class Compare = std::less<Key>>
+int keySlot(const Key* keys, int n, const Key& key, Compare comp = {}) {
+    if constexpr (std::is_integral_v<Key>) {
+        if (n <= 0) return 0;
+        const Key* base = keys;
+        int len = n;
+        while (len > 1) {
+            int half = len / 2;
+            base = comp(base[half - 1], key) ? base + half : base;
+            len -= half;
+        }
+        return static_cast<int>(base - keys) + (comp(*base, key) ? 1 : 0);
+    } else {
+        return static_cast<int>(std::lower_bound(keys, keys + n, key, comp) - keys);
+    }
+}
+
+/**
+ * @brief Slot da chave no nó: primeiro i com keys[i] >= key.
+ * @details Chaves int com a ordem natural e capacidade múltipla de 8 (exigida pelos kernels SIMD) usam o
+ *          kernel ativo; os demais tipos caem em keySlot.
+ */
+template <class Key, int MaxM, class Compare = std::less<Key>>
+int nodeSlot(const BasicNode<Key, MaxM>& node, const Key& key, Compare comp = {}) {
+    if constexpr (std::is_same_v<Key, int> && std::is_same_v<Compare, std::less<int>> && MaxM % 8 == 0) {
+        return activeSlotSearch(node.keys, node.n, key);
+    } else {
+        return keySlot(node.keys, node.n, key, comp);
+    }
+}
+
+#endif
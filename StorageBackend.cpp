@@ -0,0 +1,352 @@
+/**
+* @file StorageBackend.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "StorageBackend.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define MWAYS_HAVE_IO_URING 1
+#endif
+
+using namespace std;
+
+StorageBackend::~StorageBackend() {
+    if (fd >= 0) ::close(fd);
+}
+
+bool StorageBackend::open(const string& path, bool create) {
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0), 0644);
+    return fd >= 0;
+}
+
+void StorageBackend::close() {
+    if (fd < 0) return;
+    drain();
+    ::close(fd);
+    fd = -1;
+}
+
+long long StorageBackend::size() const {
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) != 0) return 0;
+    return static_cast<long long>(st.st_size);
+}
+
+bool StorageBackend::read(long long offset, void* buffer, size_t length) {
+    char* p = static_cast<char*>(buffer);
+    while (length > 0) {
+        ssize_t got = ::pread(fd, p, length, static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        p += got;
+        offset += got;
+        length -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+bool StorageBackend::write(long long offset, const void* buffer, size_t length) {
+    const char* p = static_cast<const char*>(buffer);
+    while (length > 0) {
+        ssize_t put = ::pwrite(fd, p, length, static_cast<off_t>(offset));
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        p += put;
+        offset += put;
+        length -= static_cast<size_t>(put);
+    }
+    return true;
+}
+
+bool StorageBackend::sync() {
+    return fd >= 0 && ::fsync(fd) == 0;
+}
+
+void StorageBackend::advise(long long offset, size_t length) {
+    if (fd >= 0) ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+}
+
+namespace {
+
+/**
+ * @brief Leituras "assíncronas" executadas por pread no submit(); as conclusões ficam prontas para wait().
+ */
+class PreadBackend : public StorageBackend {
+public:
+    ~PreadBackend() override { close(); }
+
+    bool queueRead(const IoRequest& req) override {
+        if (inFlight() >= IO_QUEUE_DEPTH) return false;
+        queued.push_back(req);
+        return true;
+    }
+
+    void submit() override {
+        for (const IoRequest& r : queued) {
+            long long result = read(r.offset, r.buffer, r.length) ? r.length : -EIO;
+            done.push_back({r.tag, result});
+        }
+        queued.clear();
+    }
+
+    size_t wait(vector<IoCompletion>& out, size_t) override {
+        submit();
+        size_t n = done.size();
+        out.insert(out.end(), done.begin(), done.end());
+        done.clear();
+        return n;
+    }
+
+    size_t inFlight() const override { return queued.size() + done.size(); }
+    bool overlaps() const override { return false; }
+    IoBackend kind() const override { return IoBackend::Pread; }
+
+protected:
+    void drain() override {
+        queued.clear();
+        done.clear();
+    }
+
+private:
+    vector<IoRequest> queued;
+    vector<IoCompletion> done;
+};
+
+#ifdef MWAYS_HAVE_IO_URING
+
+/**
+ * @brief io_uring via chamadas de sistema diretas (sem liburing): anéis SQ/CQ mapeados com mmap, uma SQE
+ *        IORING_OP_READ por leitura e io_uring_enter para submeter e esperar.
+ * @details O anel é criado no construtor (valid() indica sucesso); o descritor do arquivo é o do
+ *          StorageBackend. Cabeças e caudas compartilhadas com o kernel são acessadas com atomic_ref. Se o
+ *          io_uring_enter falhar sem nova tentativa possível, as leituras pendentes concluem com -EIO e o
+ *          backend passa a ler por pread.
+ */
+class UringBackend : public StorageBackend {
+public:
+    UringBackend() {
+        io_uring_params p{};
+        ringFd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(IO_QUEUE_DEPTH), &p));
+        if (ringFd < 0) return;
+        sqBytes = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqBytes = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqBytes = cqBytes = max(sqBytes, cqBytes);
+        sqRing = mapRing(sqBytes, IORING_OFF_SQ_RING);
+        cqRing = single ? sqRing : mapRing(cqBytes, IORING_OFF_CQ_RING);
+        sqesBytes = p.sq_entries * sizeof(io_uring_sqe);
+        void* s = mapRing(sqesBytes, IORING_OFF_SQES);
+        if (!sqRing || !cqRing || !s) {
+            release();
+            return;
+        }
+        sqes = static_cast<io_uring_sqe*>(s);
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sqEntries = p.sq_entries;
+        sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+    }
+
+    ~UringBackend() override {
+        close();
+        release();
+    }
+
+    bool valid() const { return sqes != nullptr; }
+
+    bool queueRead(const IoRequest& req) override {
+        if (inFlight() >= IO_QUEUE_DEPTH) return false;
+        if (!sqes) {
+            done.push_back({req.tag, read(req.offset, req.buffer, req.length) ? req.length : -EIO});
+            return true;
+        }
+        unsigned tail = *sqTail;
+        if (tail - atomic_ref<unsigned>(*sqHead).load(memory_order_acquire) >= sqEntries) return false;
+        unsigned idx = tail & sqMask;
+        io_uring_sqe& sqe = sqes[idx];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.off = static_cast<uint64_t>(req.offset);
+        sqe.addr = reinterpret_cast<uint64_t>(req.buffer);
+        sqe.len = req.length;
+        sqe.user_data = req.tag;
+        sqArray[idx] = idx;
+        atomic_ref<unsigned>(*sqTail).store(tail + 1, memory_order_release);
+        unsubmitted++;
+        pending++;
+        tags.push_back(req.tag);
+        return true;
+    }
+
+    void submit() override {
+        if (sqes) enter(0);
+    }
+
+    size_t wait(vector<IoCompletion>& out, size_t minCompletions) override {
+        size_t want = min(minCompletions, inFlight());
+        size_t got = takeDone(out);
+        if (sqes) {
+            got += reap(out);
+            if (got < want || unsubmitted > 0) {
+                enter(static_cast<unsigned>(want - min(got, want)));
+                if (sqes) got += reap(out);
+                got += takeDone(out);
+            }
+        }
+        return got;
+    }
+
+    size_t inFlight() const override { return pending + done.size(); }
+    bool overlaps() const override { return sqes != nullptr; }
+    IoBackend kind() const override { return sqes ? IoBackend::Uring : IoBackend::Pread; }
+
+protected:
+    void drain() override {
+        vector<IoCompletion> discarded;
+        while (inFlight() > 0) {
+            discarded.clear();
+            wait(discarded, inFlight());
+        }
+    }
+
+private:
+    int ringFd = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    size_t sqBytes = 0;
+    size_t cqBytes = 0;
+    size_t sqesBytes = 0;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned unsubmitted = 0;
+    size_t pending = 0;
+    vector<uint64_t> tags;     // tags das leituras no anel (submetidas ou não), para concluí-las em caso de falha
+    vector<IoCompletion> done; // conclusões fora do anel: -EIO da falha e leituras por pread depois dela
+
+    void* mapRing(size_t bytes, long long offset) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    void release() {
+        if (sqes) munmap(sqes, sqesBytes);
+        if (cqRing && cqRing != sqRing) munmap(cqRing, cqBytes);
+        if (sqRing) munmap(sqRing, sqBytes);
+        if (ringFd >= 0) ::close(ringFd);
+        sqes = nullptr;
+        sqRing = cqRing = nullptr;
+        ringFd = -1;
+    }
+
+    /**
+     * @brief Submete as SQEs pendentes e, com minComplete > 0, espera por essa quantidade de conclusões.
+     */
+    void enter(unsigned minComplete) {
+        if (unsubmitted == 0 && minComplete == 0) return;
+        unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        while (true) {
+            long r = syscall(__NR_io_uring_enter, ringFd, unsubmitted, minComplete, flags, nullptr, 0);
+            if (r >= 0) {
+                unsubmitted -= static_cast<unsigned>(r);
+                if (unsubmitted == 0 || minComplete > 0) return;
+            } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                fail();
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Erro sem nova tentativa no io_uring_enter: colhe o que o kernel já concluiu, conclui as demais
+     *        leituras do anel com -EIO (entregues pelo próximo wait()) e descarta o anel. Daí em diante o
+     *        backend se comporta como Pread.
+     */
+    void fail() {
+        reap(done);
+        for (uint64_t tag : tags) done.push_back({tag, -EIO});
+        tags.clear();
+        pending = 0;
+        unsubmitted = 0;
+        release();
+    }
+
+    size_t takeDone(vector<IoCompletion>& out) {
+        size_t n = done.size();
+        out.insert(out.end(), done.begin(), done.end());
+        done.clear();
+        return n;
+    }
+
+    /**
+     * @brief Move para out as conclusões já publicadas no anel CQ.
+     */
+    size_t reap(vector<IoCompletion>& out) {
+        unsigned head = *cqHead;
+        unsigned tail = atomic_ref<unsigned>(*cqTail).load(memory_order_acquire);
+        size_t n = 0;
+        for (; head != tail; ++head, ++n) {
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            out.push_back({cqe.user_data, cqe.res});
+            auto it = find(tags.begin(), tags.end(), cqe.user_data);
+            if (it != tags.end()) tags.erase(it);
+        }
+        atomic_ref<unsigned>(*cqHead).store(head, memory_order_release);
+        pending -= n;
+        return n;
+    }
+};
+
+#endif
+
+} // namespace
+
+unique_ptr<StorageBackend> makeStorageBackend(IoBackend kind) {
+#ifdef MWAYS_HAVE_IO_URING
+    if (kind == IoBackend::Uring) {
+        auto uring = make_unique<UringBackend>();
+        if (uring->valid()) return uring;
+    }
+#else
+    (void)kind;
+#endif
+    return make_unique<PreadBackend>();
+}
+
+bool parseIoBackend(const string& name, IoBackend& out) {
+    if (name == "pread") out = IoBackend::Pread;
+    else if (name == "uring") out = IoBackend::Uring;
+    else return false;
+    return true;
+}
@@ -0,0 +1,168 @@
+/**
+* @file StorageBackend.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef STORAGEBACKEND_H
+#define STORAGEBACKEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Implementação de I/O dos arquivos do índice e de dados.
+ * @details Pread: leituras submetidas são executadas uma a uma (pread) no momento do submit(). Uring: as
+ *          leituras submetidas ficam em voo juntas no io_uring do kernel e completam fora de ordem.
+ */
+enum class IoBackend { Pread, Uring };
+
+/**
+ * @brief Máximo de leituras em voo por backend (profundidade da fila do io_uring).
+ */
+const std::size_t IO_QUEUE_DEPTH = 64;
+
+/**
+ * @brief Leitura assíncrona: length bytes a partir de offset para buffer; tag identifica a conclusão.
+ */
+struct IoRequest {
+    long long offset;
+    void* buffer;
+    std::uint32_t length;
+    std::uint64_t tag;
+};
+
+/**
+ * @brief Conclusão de uma leitura: bytes lidos (>= 0) ou -errno.
+ */
+struct IoCompletion {
+    std::uint64_t tag;
+    long long result;
+};
+
+/**
+ * @brief Arquivo aberto com leituras/escritas posicionadas e fila de leituras assíncronas.
+ * @details read()/write() são bloqueantes (pread/pwrite) em todas as implementações. Para várias leituras
+ *          independentes (filhos de uma busca em lote, próximas folhas de uma varredura): queueRead() de cada
+ *          uma, submit() para iniciá-las e wait() para colher as conclusões, que devem ser consumidas antes de
+ *          reutilizar os buffers. No máximo IO_QUEUE_DEPTH leituras podem estar em voo (enfileiradas ou
+ *          submetidas e ainda não colhidas).
+ */
+class StorageBackend {
+public:
+    virtual ~StorageBackend();
+
+    StorageBackend(const StorageBackend&) = delete;
+    StorageBackend& operator=(const StorageBackend&) = delete;
+
+    /**
+     * @brief Abre o arquivo para leitura e escrita.
+     * @param path Caminho do arquivo.
+     * @param create true para criar o arquivo se não existir.
+     * @return true se aberto.
+     */
+    bool open(const std::string& path, bool create = false);
+
+    /**
+     * @brief Colhe as leituras pendentes (descartando-as) e fecha o arquivo.
+     */
+    void close();
+
+    bool isOpen() const { return fd >= 0; }
+
+    /**
+     * @brief Tamanho atual do arquivo em bytes (0 se fechado).
+     */
+    long long size() const;
+
+    /**
+     * @brief Leitura bloqueante de exatamente length bytes.
+     * @return false em erro ou fim de arquivo antes de length bytes.
+     */
+    bool read(long long offset, void* buffer, std::size_t length);
+
+    /**
+     * @brief Escrita bloqueante de length bytes (sem fsync).
+     */
+    bool write(long long offset, const void* buffer, std::size_t length);
+
+    /**
+     * @brief fsync do arquivo.
+     */
+    bool sync();
+
+    /**
+     * @brief Sugere ao kernel a leitura antecipada do trecho (posix_fadvise WILLNEED).
+     */
+    void advise(long long offset, std::size_t length);
+
+    /**
+     * @brief Enfileira uma leitura assíncrona (iniciada no próximo submit()/wait()).
+     * @return false se já houver IO_QUEUE_DEPTH leituras em voo.
+     */
+    virtual bool queueRead(const IoRequest& req) = 0;
+
+    /**
+     * @brief Inicia as leituras enfileiradas sem esperar por elas.
+     */
+    virtual void submit() = 0;
+
+    /**
+     * @brief Inicia as leituras enfileiradas e acrescenta a out as conclusões disponíveis, esperando por pelo
+     *        menos minCompletions (limitado ao que estiver em voo).
+     * @return Quantidade de conclusões acrescentadas.
+     */
+    virtual std::size_t wait(std::vector<IoCompletion>& out, std::size_t minCompletions = 1) = 0;
+
+    /**
+     * @brief Leituras enfileiradas ou submetidas ainda não colhidas por wait().
+     */
+    virtual std::size_t inFlight() const = 0;
+
+    /**
+     * @brief true se leituras submetidas correm em paralelo (vale a pena antecipá-las).
+     */
+    virtual bool overlaps() const = 0;
+
+    /**
+     * @brief Tipo efetivo do backend (Uring pode ter caído para Pread).
+     */
+    virtual IoBackend kind() const = 0;
+
+    /**
+     * @brief Nome do backend para relatórios ("pread" ou "uring").
+     */
+    const char* name() const { return kind() == IoBackend::Uring ? "uring" : "pread"; }
+
+protected:
+    StorageBackend() = default;
+
+    /**
+     * @brief Espera e descarta todas as leituras em voo (antes de fechar o arquivo).
+     */
+    virtual void drain() = 0;
+
+    int fd = -1;
+};
+
+/**
+ * @brief Cria o backend pedido; Uring cai para Pread se o io_uring não estiver disponível (kernel antigo,
+ *        seccomp ou compilação sem <linux/io_uring.h>).
+ * @param kind Backend desejado.
+ * @return Backend pronto para open().
+ */
+std::unique_ptr<StorageBackend> makeStorageBackend(IoBackend kind);
+
+/**
+ * @brief Converte "pread" ou "uring" no backend correspondente.
+ * @return false se o nome for desconhecido.
+ */
+bool parseIoBackend(const std::string& name, IoBackend& out);
+
+#endif
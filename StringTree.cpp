@@ -0,0 +1,759 @@
+/**
+* @file StringTree.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "StringTree.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Header do índice (início da página 0).
+ */
+struct StringHeader {
+    int32_t magic;
+    int32_t version;
+    int32_t pageSize;
+    int32_t root;
+    int32_t pages;
+    int32_t freeHead;
+    int32_t freeCount;
+    int32_t reserved;
+    int64_t keys;
+};
+
+// Cabeçalho de página: n (FREE_NODE em página livre), link, tamanho do prefixo, início das células, folha.
+const int PAGE_HEADER = 16;
+const int OFF_COUNT = 0;
+const int OFF_LINK = 4;
+const int OFF_PREFIX = 8;
+const int OFF_HEAP = 10;
+const int OFF_LEAF = 12;
+// Célula: tamanho do sufixo (2) + valor (4), além dos bytes do sufixo; mais 2 bytes do slot.
+const int CELL_OVERHEAD = 2 + 4 + 2;
+
+int32_t load32(const char* p) {
+    int32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint16_t load16(const char* p) {
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void store32(char* p, int32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+void store16(char* p, uint16_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+/**
+ * @brief Comparação byte a byte sem sinal (string_view::compare usa char_traits<char>, que compara como unsigned char).
+ */
+int compareBytes(string_view a, string_view b) {
+    return a.compare(b);
+}
+
+size_t commonPrefix(string_view a, string_view b) {
+    size_t n = min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) i++;
+    return i;
+}
+
+/**
+ * @brief Prefixo comum a todas as chaves de um nó ordenado (= prefixo comum da primeira e da última).
+ */
+size_t nodePrefix(const vector<string>& keys) {
+    if (keys.empty()) return 0;
+    return commonPrefix(keys.front(), keys.back());
+}
+
+/**
+ * @brief Menor separador s com a <= ... < s <= b: o prefixo de b um byte além do prefixo comum com a.
+ */
+string shortestSeparator(string_view a, string_view b) {
+    size_t lcp = commonPrefix(a, b);
+    return string(b.substr(0, min(b.size(), lcp + 1)));
+}
+
+/**
+ * @brief Primeiro slot (0-based) cuja chave é >= key, direto na página; equal indica igualdade nesse slot.
+ * @details Chaves do nó compartilham o prefixo gravado: se key diverge do prefixo, a resposta é 0 ou n sem
+ *          olhar as células; senão a busca binária compara apenas os sufixos.
+ */
+int pageLowerBound(const char* page, string_view key, bool& equal) {
+    equal = false;
+    int n = load32(page + OFF_COUNT);
+    int prefixLen = load16(page + OFF_PREFIX);
+    string_view prefix(page + PAGE_HEADER, static_cast<size_t>(prefixLen));
+    int c = compareBytes(key.substr(0, prefix.size()), prefix);
+    if (c < 0) return 0;
+    if (c > 0) return n;
+    string_view rest = key.substr(prefix.size());
+    const char* slots = page + PAGE_HEADER + prefixLen;
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        const char* cell = page + load16(slots + 2 * mid);
+        string_view suffix(cell + 2, load16(cell));
+        int cmp = compareBytes(suffix, rest);
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            equal = cmp == 0;
+            hi = mid;
+        }
+    }
+    if (lo == n) equal = false;
+    return lo;
+}
+
+int cellValue(const char* page, int slot) {
+    int prefixLen = load16(page + OFF_PREFIX);
+    const char* cell = page + load16(page + PAGE_HEADER + prefixLen + 2 * slot);
+    return load32(cell + 2 + load16(cell));
+}
+
+/**
+ * @brief Índice do filho que cobre key: número de separadores <= key.
+ */
+int childSlot(const char* page, string_view key) {
+    bool equal = false;
+    int i = pageLowerBound(page, key, equal);
+    return equal ? i + 1 : i;
+}
+
+int childAt(const char* page, int i) {
+    return i == 0 ? load32(page + OFF_LINK) : cellValue(page, i - 1);
+}
+
+int childAt(const StringNode& node, size_t i) {
+    return i == 0 ? node.link : node.values[i - 1];
+}
+
+off_t pageOffset(int pos, int pageSize) {
+    return static_cast<off_t>(pos) * pageSize;
+}
+
+}
+
+StringTree::~StringTree() {
+    close();
+}
+
+bool StringTree::createEmpty(const std::string& filename, int pageSize) {
+    if (pageSize < STRING_PAGE_MIN || pageSize > STRING_PAGE_MAX) return false;
+    int out = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) return false;
+    vector<char> header(static_cast<size_t>(pageSize), 0);
+    StringHeader h{STRING_MAGIC, STRING_VERSION, pageSize, 0, 1, 0, 0, 0, 0};
+    memcpy(header.data(), &h, sizeof(h));
+    bool ok = ::pwrite(out, header.data(), header.size(), 0) == static_cast<ssize_t>(header.size());
+    ::close(out);
+    return ok;
+}
+
+bool StringTree::open(const std::string& filename) {
+    close();
+    fd = ::open(filename.c_str(), O_RDWR);
+    if (fd < 0) return false;
+    StringHeader h{};
+    off_t end = ::lseek(fd, 0, SEEK_END);
+    bool ok = ::pread(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) &&
+              h.magic == STRING_MAGIC && h.version == STRING_VERSION &&
+              h.pageSize >= STRING_PAGE_MIN && h.pageSize <= STRING_PAGE_MAX &&
+              h.pages >= 1 && end >= pageOffset(h.pages, h.pageSize) &&
+              h.root >= 0 && h.root < h.pages && h.freeHead >= 0 && h.freeHead < h.pages &&
+              h.freeCount >= 0 && h.keys >= 0;
+    if (!ok) {
+        close();
+        return false;
+    }
+    pageSize = h.pageSize;
+    root = h.root;
+    pages = h.pages;
+    freeHead = h.freeHead;
+    freeCount = h.freeCount;
+    keyCount = h.keys;
+    page.assign(static_cast<size_t>(pageSize), 0);
+    return true;
+}
+
+void StringTree::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+bool StringTree::writeHeader() {
+    StringHeader h{STRING_MAGIC, STRING_VERSION, pageSize, root, pages, freeHead, freeCount, 0, keyCount};
+    return ::pwrite(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h));
+}
+
+bool StringTree::readPage(int pos) {
+    if (pos <= 0 || pos >= pages) return false;
+    reads++;
+    return ::pread(fd, page.data(), page.size(), pageOffset(pos, pageSize)) == static_cast<ssize_t>(page.size());
+}
+
+/**
+ * @brief Lê a página e reconstrói as chaves completas (prefixo + sufixo); rejeita páginas livres ou corrompidas.
+ */
+bool StringTree::readNode(int pos, StringNode& node) {
+    if (!readPage(pos)) return false;
+    const char* p = page.data();
+    int n = load32(p + OFF_COUNT);
+    int prefixLen = load16(p + OFF_PREFIX);
+    int slotsEnd = PAGE_HEADER + prefixLen + 2 * n;
+    if (n < 0 || slotsEnd > pageSize) return false;
+    node.leaf = p[OFF_LEAF] != 0;
+    node.link = load32(p + OFF_LINK);
+    node.keys.resize(static_cast<size_t>(n));
+    node.values.resize(static_cast<size_t>(n));
+    string_view prefix(p + PAGE_HEADER, static_cast<size_t>(prefixLen));
+    for (int i = 0; i < n; ++i) {
+        int at = load16(p + PAGE_HEADER + prefixLen + 2 * i);
+        if (at < slotsEnd || at + 6 > pageSize) return false;
+        int len = load16(p + at);
+        if (at + 6 + len > pageSize) return false;
+        string& key = node.keys[static_cast<size_t>(i)];
+        key.assign(prefix);
+        key.append(p + at + 2, static_cast<size_t>(len));
+        node.values[static_cast<size_t>(i)] = load32(p + at + 2 + len);
+    }
+    return true;
+}
+
+/**
+ * @brief Bytes ocupados pelo nó codificado: cabeçalho, prefixo comum uma vez e, por chave, slot + célula com o sufixo.
+ */
+int StringTree::encodedSize(const StringNode& node) const {
+    size_t prefixLen = nodePrefix(node.keys);
+    size_t bytes = PAGE_HEADER + prefixLen;
+    for (const string& k : node.keys) bytes += CELL_OVERHEAD + k.size() - prefixLen;
+    return static_cast<int>(bytes);
+}
+
+/**
+ * @brief Codifica o nó (células gravadas do fim da página para o início, na ordem das chaves) e grava.
+ */
+bool StringTree::writeNode(int pos, const StringNode& node) {
+    fill(page.begin(), page.end(), 0);
+    char* p = page.data();
+    size_t prefixLen = nodePrefix(node.keys);
+    int n = static_cast<int>(node.keys.size());
+    store32(p + OFF_COUNT, n);
+    store32(p + OFF_LINK, node.link);
+    store16(p + OFF_PREFIX, static_cast<uint16_t>(prefixLen));
+    p[OFF_LEAF] = node.leaf ? 1 : 0;
+    if (prefixLen > 0) memcpy(p + PAGE_HEADER, node.keys.front().data(), prefixLen);
+    char* slots = p + PAGE_HEADER + prefixLen;
+    int heap = pageSize;
+    for (int i = 0; i < n; ++i) {
+        const string& key = node.keys[static_cast<size_t>(i)];
+        size_t len = key.size() - prefixLen;
+        heap -= static_cast<int>(2 + len + 4);
+        store16(p + heap, static_cast<uint16_t>(len));
+        memcpy(p + heap + 2, key.data() + prefixLen, len);
+        store32(p + heap + 2 + len, node.values[static_cast<size_t>(i)]);
+        store16(slots + 2 * i, static_cast<uint16_t>(heap));
+    }
+    store16(p + OFF_HEAP, static_cast<uint16_t>(heap));
+    writes++;
+    return ::pwrite(fd, p, page.size(), pageOffset(pos, pageSize)) == static_cast<ssize_t>(page.size());
+}
+
+/**
+ * @brief Reaproveita a primeira página da lista de livres ou estende o arquivo.
+ * @return Posição da página, ou 0 em falha de leitura da lista.
+ */
+int StringTree::allocate() {
+    if (freeHead != 0) {
+        int pos = freeHead;
+        if (!readPage(pos) || load32(page.data() + OFF_COUNT) != FREE_NODE) return 0;
+        freeHead = load32(page.data() + OFF_LINK);
+        freeCount--;
+        return pos;
+    }
+    return pages++;
+}
+
+bool StringTree::freePage(int pos) {
+    fill(page.begin(), page.end(), 0);
+    store32(page.data() + OFF_COUNT, FREE_NODE);
+    store32(page.data() + OFF_LINK, freeHead);
+    freeHead = pos;
+    freeCount++;
+    writes++;
+    return ::pwrite(fd, page.data(), page.size(), pageOffset(pos, pageSize)) == static_cast<ssize_t>(page.size());
+}
+
+/**
+ * @brief Divide o nó pelo meio em bytes (não em chaves): node fica com a metade esquerda e right com a direita.
+ * @details Folha: sep é o separador mais curto entre as metades (compressão de sufixo); o encadeamento fica
+ *          a cargo de quem chama. Interno: o separador do meio sobe para o pai e seu filho vira o link de right.
+ */
+void StringTree::splitNode(StringNode& node, StringNode& right, std::string& sep) const {
+    size_t n = node.keys.size();
+    size_t prefixLen = nodePrefix(node.keys);
+    size_t total = 0;
+    for (const string& k : node.keys) total += CELL_OVERHEAD + k.size() - prefixLen;
+    // Folha: cada metade fica com ao menos uma chave; interno: o separador do meio sai do nó.
+    size_t lo = 1;
+    size_t hi = node.leaf ? n - 1 : n - 2;
+    size_t k = lo;
+    size_t acc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        acc += CELL_OVERHEAD + node.keys[i].size() - prefixLen;
+        if (acc * 2 >= total) {
+            k = i + 1;
+            break;
+        }
+    }
+    k = clamp(k, lo, max(lo, hi));
+
+    right = StringNode{};
+    right.leaf = node.leaf;
+    if (node.leaf) {
+        right.keys.assign(make_move_iterator(node.keys.begin() + k), make_move_iterator(node.keys.end()));
+        right.values.assign(node.values.begin() + k, node.values.end());
+        node.keys.resize(k);
+        node.values.resize(k);
+        sep = shortestSeparator(node.keys.back(), right.keys.front());
+    } else {
+        sep = std::move(node.keys[k]);
+        right.link = node.values[k];
+        right.keys.assign(make_move_iterator(node.keys.begin() + k + 1), make_move_iterator(node.keys.end()));
+        right.values.assign(node.values.begin() + k + 1, node.values.end());
+        node.keys.resize(k);
+        node.values.resize(k);
+    }
+}
+
+/**
+ * @brief Grava o nó na própria posição ou, se não couber na página, divide e informa o pai via up.
+ */
+bool StringTree::store(int pos, StringNode& node, Change& up) {
+    if (encodedSize(node) <= pageSize) {
+        up.underflow = encodedSize(node) < pageSize / 4;
+        return writeNode(pos, node);
+    }
+    StringNode right;
+    splitNode(node, right, up.sep);
+    int rightPos = allocate();
+    if (rightPos == 0) return false;
+    if (node.leaf) {
+        right.link = node.link;
+        node.link = rightPos;
+    }
+    up.split = true;
+    up.right = rightPos;
+    return writeNode(pos, node) && writeNode(rightPos, right);
+}
+
+bool StringTree::insertRecursive(int pos, std::string_view key, int rec, Change& up, bool& inserted) {
+    StringNode node;
+    if (!readNode(pos, node)) return false;
+    auto it = upper_bound(node.keys.begin(), node.keys.end(), key,
+                          [](string_view a, const string& b) { return compareBytes(a, b) < 0; });
+    size_t c = static_cast<size_t>(it - node.keys.begin());
+    if (node.leaf) {
+        if (c > 0 && node.keys[c - 1] == key) {
+            inserted = false;
+            return true;
+        }
+        node.keys.insert(node.keys.begin() + c, string(key));
+        node.values.insert(node.values.begin() + c, rec);
+        inserted = true;
+        return store(pos, node, up);
+    }
+    Change sub;
+    if (!insertRecursive(childAt(node, c), key, rec, sub, inserted)) return false;
+    if (!sub.split) return true;
+    node.keys.insert(node.keys.begin() + c, std::move(sub.sep));
+    node.values.insert(node.values.begin() + c, sub.right);
+    return store(pos, node, up);
+}
+
+bool StringTree::insertB(std::string_view key, int recPos) {
+    resetCounters();
+    if (fd < 0 || static_cast<int>(key.size()) > maxKeyBytes()) return false;
+    if (root == 0) {
+        StringNode leaf;
+        leaf.keys.emplace_back(key);
+        leaf.values.push_back(recPos);
+        int pos = allocate();
+        if (pos == 0 || !writeNode(pos, leaf)) return false;
+        root = pos;
+        keyCount = 1;
+        return writeHeader();
+    }
+    Change up;
+    bool inserted = false;
+    if (!insertRecursive(root, key, recPos, up, inserted)) return false;
+    if (up.split) {
+        StringNode top;
+        top.leaf = false;
+        top.link = root;
+        top.keys.push_back(std::move(up.sep));
+        top.values.push_back(up.right);
+        int pos = allocate();
+        if (pos == 0 || !writeNode(pos, top)) return false;
+        root = pos;
+    }
+    if (!inserted) return true;
+    keyCount++;
+    return writeHeader();
+}
+
+/**
+ * @brief Carga em lote: uma página aberta por nível; quando a próxima chave não cabe no limite, a página é
+ *        gravada e o separador (mais curto possível, nas folhas) sobe para o nível de cima, criado sob demanda.
+ */
+bool StringTree::bulkLoad(std::vector<std::pair<std::string,int>> entries, double fillFactor) {
+    resetCounters();
+    if (fd < 0 || root != 0) return false;
+    stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return compareBytes(a.first, b.first) < 0; });
+    entries.erase(unique(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first == b.first; }),
+                  entries.end());
+    for (const auto& e : entries)
+        if (static_cast<int>(e.first.size()) > maxKeyBytes()) return false;
+    if (entries.empty()) return true;
+    const int limit = static_cast<int>(pageSize * clamp(fillFactor, 0.5, 1.0));
+
+    struct Level { int first; int pos; StringNode node; };
+    vector<Level> levels;
+    int pos = allocate();
+    levels.push_back({pos, pos, StringNode{}});
+
+    // Insere (sep, filho) no nível l; página cheia é gravada e o separador sobe com a nova página à direita.
+    auto promote = [&](size_t l, string sep, int child) {
+        while (true) {
+            if (l == levels.size()) {
+                int top = allocate();
+                Level up{top, top, StringNode{}};
+                up.node.leaf = false;
+                up.node.link = levels[l - 1].first;
+                levels.push_back(std::move(up));
+            }
+            StringNode& cur = levels[l].node;
+            cur.keys.push_back(sep);
+            cur.values.push_back(child);
+            if (encodedSize(cur) <= limit) return true;
+            cur.keys.pop_back();
+            cur.values.pop_back();
+            if (!writeNode(levels[l].pos, cur)) return false;
+            int next = allocate();
+            cur = StringNode{};
+            cur.leaf = false;
+            cur.link = child;
+            levels[l].pos = next;
+            child = next;
+            l++;
+        }
+    };
+
+    for (auto& [key, rec] : entries) {
+        levels[0].node.keys.push_back(std::move(key));
+        levels[0].node.values.push_back(rec);
+        if (encodedSize(levels[0].node) <= limit || levels[0].node.keys.size() == 1) continue;
+        StringNode next;
+        next.keys.push_back(std::move(levels[0].node.keys.back()));
+        next.values.push_back(rec);
+        levels[0].node.keys.pop_back();
+        levels[0].node.values.pop_back();
+        int nextPos = allocate();
+        levels[0].node.link = nextPos;
+        if (!writeNode(levels[0].pos, levels[0].node)) return false;
+        string sep = shortestSeparator(levels[0].node.keys.back(), next.keys.front());
+        levels[0].node = std::move(next);
+        levels[0].pos = nextPos;
+        if (!promote(1, std::move(sep), nextPos)) return false;
+    }
+    for (const Level& lv : levels)
+        if (!writeNode(lv.pos, lv.node)) return false;
+    root = levels.back().pos;
+    keyCount = static_cast<long long>(entries.size());
+    return writeHeader();
+}
+
+/**
+ * @brief Corrige o filho c (pouco ocupado) junto do irmão adjacente: funde se o resultado couber na página,
+ *        senão redistribui pelos bytes e troca o separador no pai.
+ * @return false em falha de I/O.
+ */
+bool StringTree::fixChild(StringNode& parent, int c) {
+    if (parent.keys.empty()) return true;
+    size_t a = c > 0 ? static_cast<size_t>(c - 1) : 0;
+    int leftPos = childAt(parent, a);
+    int rightPos = childAt(parent, a + 1);
+    StringNode left, right;
+    if (!readNode(leftPos, left) || !readNode(rightPos, right)) return false;
+
+    StringNode merged;
+    merged.leaf = left.leaf;
+    merged.keys = std::move(left.keys);
+    merged.values = std::move(left.values);
+    if (merged.leaf) {
+        merged.link = right.link;
+    } else {
+        merged.link = left.link;
+        merged.keys.push_back(parent.keys[a]);
+        merged.values.push_back(right.link);
+    }
+    merged.keys.insert(merged.keys.end(), make_move_iterator(right.keys.begin()), make_move_iterator(right.keys.end()));
+    merged.values.insert(merged.values.end(), right.values.begin(), right.values.end());
+
+    if (encodedSize(merged) <= pageSize) {
+        parent.keys.erase(parent.keys.begin() + a);
+        parent.values.erase(parent.values.begin() + a);
+        return writeNode(leftPos, merged) && freePage(rightPos);
+    }
+    StringNode newRight;
+    string sep;
+    splitNode(merged, newRight, sep);
+    if (merged.leaf) {
+        newRight.link = merged.link;
+        merged.link = rightPos;
+    }
+    parent.keys[a] = std::move(sep);
+    return writeNode(leftPos, merged) && writeNode(rightPos, newRight);
+}
+
+bool StringTree::deleteRecursive(int pos, std::string_view key, int* recPos, Change& up, bool& found) {
+    StringNode node;
+    if (!readNode(pos, node)) return false;
+    auto it = upper_bound(node.keys.begin(), node.keys.end(), key,
+                          [](string_view a, const string& b) { return compareBytes(a, b) < 0; });
+    size_t c = static_cast<size_t>(it - node.keys.begin());
+    if (node.leaf) {
+        found = c > 0 && node.keys[c - 1] == key;
+        if (!found) return true;
+        if (recPos) *recPos = node.values[c - 1];
+        node.keys.erase(node.keys.begin() + (c - 1));
+        node.values.erase(node.values.begin() + (c - 1));
+        return store(pos, node, up);
+    }
+    Change sub;
+    if (!deleteRecursive(childAt(node, c), key, recPos, sub, found)) return false;
+    if (!found) return true;
+    if (sub.split) {
+        // Um separador mais longo após redistribuição abaixo pode dividir o filho.
+        node.keys.insert(node.keys.begin() + c, std::move(sub.sep));
+        node.values.insert(node.values.begin() + c, sub.right);
+    } else if (sub.underflow) {
+        if (!fixChild(node, static_cast<int>(c))) return false;
+    } else {
+        return true;
+    }
+    return store(pos, node, up);
+}
+
+/**
+ * @brief Raiz interna sem separadores cede lugar ao único filho; folha raiz vazia deixa a árvore vazia.
+ */
+bool StringTree::collapseRoot() {
+    StringNode top;
+    if (!readNode(root, top)) return false;
+    if (!top.keys.empty()) return true;
+    int old = root;
+    root = top.leaf ? 0 : top.link;
+    return freePage(old);
+}
+
+bool StringTree::deleteB(std::string_view key, int* recPos) {
+    resetCounters();
+    if (fd < 0 || root == 0) return false;
+    Change up;
+    bool found = false;
+    if (!deleteRecursive(root, key, recPos, up, found) || !found) return false;
+    if (up.split) {
+        StringNode top;
+        top.leaf = false;
+        top.link = root;
+        top.keys.push_back(std::move(up.sep));
+        top.values.push_back(up.right);
+        int pos = allocate();
+        if (pos == 0 || !writeNode(pos, top)) return false;
+        root = pos;
+    } else if (!collapseRoot()) {
+        return false;
+    }
+    keyCount--;
+    return writeHeader();
+}
+
+/**
+ * @brief Desce pela página crua (sem reconstruir chaves) até a folha da chave.
+ */
+std::tuple<int, int, bool> StringTree::mSearch(std::string_view key, int* recPos) {
+    resetCounters();
+    if (fd < 0 || root == 0) return {0, 0, false};
+    int pos = root;
+    while (readPage(pos)) {
+        const char* p = page.data();
+        if (p[OFF_LEAF] != 0) {
+            bool equal = false;
+            int i = pageLowerBound(p, key, equal);
+            if (equal && recPos) *recPos = cellValue(p, i);
+            return {pos, equal ? i + 1 : i, equal};
+        }
+        pos = childAt(p, childSlot(p, key));
+    }
+    return {0, 0, false};
+}
+
+std::size_t StringTree::scanPrefix(std::string_view prefix, const std::function<bool(std::string_view, int)>& visit) {
+    resetCounters();
+    if (fd < 0 || root == 0) return 0;
+    int pos = root;
+    bool equal = false;
+    int i = 0;
+    while (readPage(pos)) {
+        const char* p = page.data();
+        if (p[OFF_LEAF] != 0) {
+            i = pageLowerBound(p, prefix, equal);
+            break;
+        }
+        pos = childAt(p, childSlot(p, prefix));
+    }
+    size_t visited = 0;
+    StringNode leaf;
+    while (pos != 0 && readNode(pos, leaf)) {
+        for (size_t k = static_cast<size_t>(i); k < leaf.keys.size(); ++k) {
+            const string& key = leaf.keys[k];
+            if (key.compare(0, prefix.size(), prefix) != 0) return visited;
+            visited++;
+            if (!visit(key, leaf.values[k])) return visited;
+        }
+        pos = leaf.link;
+        i = 0;
+    }
+    return visited;
+}
+
+/**
+ * @brief DFS com faixa [lo, hi) herdada dos separadores; folhas precisam aparecer, em ordem, no encadeamento.
+ */
+bool StringTree::verifyIntegrity(bool verbose) {
+    auto fail = [verbose](const string& msg) {
+        if (verbose) cout << "Indice de texto inconsistente: " << msg << endl;
+        return false;
+    };
+    if (fd < 0) return fail("arquivo fechado");
+    vector<char> seen(static_cast<size_t>(pages), 0);
+    vector<int> leafOrder;
+    long long keys = 0;
+    int leafDepth = -1;
+
+    struct Frame { int pos; int depth; string lo; bool hasLo; string hi; bool hasHi; };
+    vector<Frame> stack;
+    if (root != 0) stack.push_back({root, 0, "", false, "", false});
+    while (!stack.empty()) {
+        Frame f = std::move(stack.back());
+        stack.pop_back();
+        if (f.pos <= 0 || f.pos >= pages || seen[static_cast<size_t>(f.pos)])
+            return fail("pagina " + to_string(f.pos) + " invalida ou repetida");
+        seen[static_cast<size_t>(f.pos)] = 1;
+        StringNode node;
+        if (!readNode(f.pos, node)) return fail("pagina " + to_string(f.pos) + " ilegivel");
+        if (encodedSize(node) > pageSize) return fail("pagina " + to_string(f.pos) + " excede o tamanho");
+        if (node.keys.empty() && !(f.pos == root && node.leaf)) return fail("pagina " + to_string(f.pos) + " vazia");
+        for (size_t i = 0; i < node.keys.size(); ++i) {
+            const string& k = node.keys[i];
+            if (i > 0 && compareBytes(node.keys[i - 1], k) >= 0) return fail("chaves fora de ordem na pagina " + to_string(f.pos));
+            if ((f.hasLo && compareBytes(k, f.lo) < 0) || (f.hasHi && compareBytes(k, f.hi) >= 0))
+                return fail("chave fora da faixa na pagina " + to_string(f.pos));
+        }
+        if (node.leaf) {
+            if (leafDepth < 0) leafDepth = f.depth;
+            if (f.depth != leafDepth) return fail("folhas em profundidades diferentes");
+            leafOrder.push_back(f.pos);
+            keys += static_cast<long long>(node.keys.size());
+            continue;
+        }
+        // Empilha da direita para a esquerda para visitar as folhas em ordem crescente.
+        for (size_t i = node.keys.size() + 1; i-- > 0;) {
+            Frame child{childAt(node, i), f.depth + 1, f.lo, f.hasLo, f.hi, f.hasHi};
+            if (i > 0) { child.lo = node.keys[i - 1]; child.hasLo = true; }
+            if (i < node.keys.size()) { child.hi = node.keys[i]; child.hasHi = true; }
+            stack.push_back(std::move(child));
+        }
+    }
+    for (size_t i = 0; i < leafOrder.size(); ++i) {
+        StringNode leaf;
+        if (!readNode(leafOrder[i], leaf)) return fail("folha ilegivel");
+        int expected = i + 1 < leafOrder.size() ? leafOrder[i + 1] : 0;
+        if (leaf.link != expected) return fail("encadeamento de folhas quebrado na pagina " + to_string(leafOrder[i]));
+    }
+    if (keys != keyCount) return fail("contagem de chaves difere do header");
+
+    int freeSeen = 0;
+    for (int pos = freeHead; pos != 0; ++freeSeen) {
+        if (pos <= 0 || pos >= pages || seen[static_cast<size_t>(pos)] || !readPage(pos) ||
+            load32(page.data() + OFF_COUNT) != FREE_NODE)
+            return fail("lista de livres invalida");
+        seen[static_cast<size_t>(pos)] = 1;
+        pos = load32(page.data() + OFF_LINK);
+    }
+    if (freeSeen != freeCount) return fail("contagem de livres difere do header");
+    for (int pos = 1; pos < pages; ++pos)
+        if (!seen[static_cast<size_t>(pos)]) return fail("pagina " + to_string(pos) + " inacessivel");
+    return true;
+}
+
+StringTreeStats StringTree::getStats() {
+    StringTreeStats s;
+    if (fd < 0 || root == 0) return s;
+    vector<int> level{root};
+    while (!level.empty()) {
+        s.height++;
+        vector<int> next;
+        for (int pos : level) {
+            StringNode node;
+            if (!readNode(pos, node)) return s;
+            size_t prefixLen = nodePrefix(node.keys);
+            if (node.leaf) {
+                s.leaves++;
+                s.keys += static_cast<long long>(node.keys.size());
+                s.storedBytes += static_cast<long long>(prefixLen);
+                for (const string& k : node.keys) {
+                    s.keyBytes += static_cast<long long>(k.size());
+                    s.storedBytes += static_cast<long long>(k.size() - prefixLen);
+                }
+                continue;
+            }
+            s.internals++;
+            for (const string& k : node.keys) s.separatorBytes += static_cast<long long>(k.size());
+            for (size_t i = 0; i <= node.keys.size(); ++i) next.push_back(childAt(node, i));
+        }
+        level.swap(next);
+    }
+    return s;
+}
+
+void StringTree::resetCounters() {
+    reads = 0;
+    writes = 0;
+}
+
+std::pair<long long,long long> StringTree::getCounters() const {
+    return {reads, writes};
+}
@@ -0,0 +1,207 @@
+/**
+* @file StringTree.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef STRINGTREE_H
+#define STRINGTREE_H
+
+#include "Node.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+const int STRING_MAGIC = 0x52545357; // "WSTR" em little-endian
+const int STRING_VERSION = 1;
+const int STRING_PAGE_DEFAULT = 4096;
+const int STRING_PAGE_MIN = 1024;
+const int STRING_PAGE_MAX = 32768;
+
+/**
+ * @brief Nó do índice de chaves de texto, já descomprimido (chaves completas).
+ * @details Em folhas, keys são as chaves e values os números dos registros; link é a próxima folha (0 = última).
+ *          Em nós internos, keys são separadores, link é o filho mais à esquerda e values[i] o filho à direita
+ *          de keys[i]: chaves < keys[0] ficam em link; chaves em [keys[i], keys[i+1]) em values[i].
+ */
+struct StringNode {
+    bool leaf = true;
+    int link = 0;
+    std::vector<std::string> keys;
+    std::vector<int> values;
+};
+
+/**
+ * @brief Estatísticas de ocupação do índice de texto.
+ */
+struct StringTreeStats {
+    int height = 0;
+    int leaves = 0;
+    int internals = 0;
+    long long keys = 0;
+    long long keyBytes = 0;    // soma dos tamanhos completos das chaves nas folhas
+    long long storedBytes = 0; // bytes de chave efetivamente gravados nas folhas (prefixo uma vez + sufixos)
+    long long separatorBytes = 0; // bytes dos separadores (já truncados) nos nós internos
+};
+
+/**
+ * @brief Índice B+ em disco para chaves de bytes de tamanho variável (nomes, departamentos, chaves compostas).
+ * @details Página 0 guarda o header; cada nó ocupa uma página com slots: cabeçalho de 16 bytes, o prefixo
+ *          comum a todas as chaves do nó (gravado uma única vez), o vetor de slots (deslocamentos de 2 bytes,
+ *          em ordem de chave) e, a partir do fim da página, as células com o sufixo de cada chave e o valor.
+ *          Com isso o número de chaves por nó é limitado pelos bytes da página, e não por uma ordem m fixa.
+ *          Todas as chaves ficam nas folhas (encadeadas para varreduras); os nós internos guardam apenas
+ *          separadores, e o separador promovido numa divisão de folha é o menor prefixo da primeira chave da
+ *          direita que ainda é maior que a última da esquerda (compressão de sufixo). Remoções fundem ou
+ *          redistribuem nós com menos de 1/4 da página ocupada. A busca compara primeiro o prefixo do nó e
+ *          depois faz busca binária só sobre os sufixos, direto na página lida.
+ */
+class StringTree {
+public:
+    StringTree() = default;
+
+    /**
+     * @brief Destrutor: fecha o arquivo.
+     */
+    ~StringTree();
+
+    StringTree(const StringTree&) = delete;
+    StringTree& operator=(const StringTree&) = delete;
+
+    /**
+     * @brief Cria um índice vazio (apenas header).
+     * @param filename Caminho do arquivo.
+     * @param pageSize Tamanho da página em bytes [STRING_PAGE_MIN..STRING_PAGE_MAX].
+     * @return true em caso de sucesso.
+     */
+    static bool createEmpty(const std::string& filename, int pageSize = STRING_PAGE_DEFAULT);
+
+    /**
+     * @brief Abre o índice e valida o header.
+     * @return true se aberto e válido.
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Fecha o arquivo (o header já está gravado a cada alteração).
+     */
+    void close();
+
+    bool isOpen() const { return fd >= 0; }
+
+    /**
+     * @brief Maior chave aceita (1/8 da página, descontado o cabeçalho da célula): garante que qualquer divisão
+     *        produz duas metades que cabem na página.
+     */
+    int maxKeyBytes() const { return pageSize / 8 - 16; }
+
+    int getPageSize() const { return pageSize; }
+    long long size() const { return keyCount; }
+
+    /**
+     * @brief Busca a chave.
+     * @param key Chave (bytes quaisquer).
+     * @param recPos (Opcional) saída: registro associado à chave.
+     * @return (folha, slot, found): se found=true, slot é 1-based; senão, posição de inserção na folha.
+     */
+    std::tuple<int, int, bool> mSearch(std::string_view key, int* recPos = nullptr);
+
+    /**
+     * @brief Insere a chave (duplicatas são ignoradas); divide nós que passarem da página.
+     * @param key Chave (até maxKeyBytes bytes).
+     * @param recPos Registro associado.
+     * @return false se a chave for longa demais ou houver falha de I/O.
+     */
+    bool insertB(std::string_view key, int recPos = NO_RECORD);
+
+    /**
+     * @brief Carga em lote numa árvore vazia: ordena os pares e enche cada página até fillFactor dos bytes,
+     *        gravando cada nó uma única vez (folhas e separadores em sequência, da esquerda para a direita).
+     * @param entries Pares (chave, registro) em qualquer ordem; de chaves repetidas vale o primeiro par.
+     * @param fillFactor Fração da página ocupada por nó [0.5..1].
+     * @return false se o índice não estiver aberto e vazio, se alguma chave for longa demais ou em falha de I/O.
+     */
+    bool bulkLoad(std::vector<std::pair<std::string,int>> entries, double fillFactor = 1.0);
+
+    /**
+     * @brief Remove a chave, fundindo ou redistribuindo nós pouco ocupados.
+     * @param key Chave a remover.
+     * @param recPos (Opcional) saída: registro associado à chave removida.
+     * @return true se a chave existia.
+     */
+    bool deleteB(std::string_view key, int* recPos = nullptr);
+
+    /**
+     * @brief Visita em ordem crescente as chaves que começam com prefix (pelas folhas encadeadas).
+     * @param prefix Prefixo procurado (vazio = todas as chaves).
+     * @param visit Recebe (chave, registro); retornar false interrompe.
+     * @return Quantidade de chaves visitadas.
+     */
+    std::size_t scanPrefix(std::string_view prefix, const std::function<bool(std::string_view, int)>& visit);
+
+    /**
+     * @brief Verifica ordem das chaves, faixas dos separadores, ocupação das páginas, profundidade das folhas,
+     *        encadeamento das folhas, contagem de chaves e lista de livres.
+     * @param verbose Se true, imprime o primeiro problema encontrado.
+     * @return true se íntegro.
+     */
+    bool verifyIntegrity(bool verbose = false);
+
+    /**
+     * @brief Percorre a árvore e resume ocupação e economia da compressão.
+     */
+    StringTreeStats getStats();
+
+    void resetCounters();
+
+    /**
+     * @brief Páginas lidas e gravadas desde o último reset (cada operação pública zera os contadores).
+     * @return Par (reads, writes).
+     */
+    std::pair<long long,long long> getCounters() const;
+
+private:
+    /**
+     * @brief Resultado de uma alteração num nó, repassado ao pai.
+     */
+    struct Change {
+        bool split = false;     // o nó foi dividido: pai insere sep com o novo nó à direita
+        std::string sep;
+        int right = 0;
+        bool underflow = false; // o nó ficou com menos de 1/4 da página
+    };
+
+    int fd = -1;
+    int pageSize = STRING_PAGE_DEFAULT;
+    int root = 0;
+    int pages = 1;
+    int freeHead = 0;
+    int freeCount = 0;
+    long long keyCount = 0;
+    std::vector<char> page;
+    long long reads = 0;
+    long long writes = 0;
+
+    bool readPage(int pos);
+    bool readNode(int pos, StringNode& node);
+    bool writeNode(int pos, const StringNode& node);
+    bool writeHeader();
+    int allocate();
+    bool freePage(int pos);
+    int encodedSize(const StringNode& node) const;
+    bool store(int pos, StringNode& node, Change& up);
+    void splitNode(StringNode& node, StringNode& right, std::string& sep) const;
+    bool fixChild(StringNode& parent, int c);
+    bool insertRecursive(int pos, std::string_view key, int rec, Change& up, bool& inserted);
+    bool deleteRecursive(int pos, std::string_view key, int* recPos, Change& up, bool& found);
+    bool collapseRoot();
+};
+
+#endif
@@ -0,0 +1,93 @@
+/**
+* @file TextChunks.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "TextChunks.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+TextChunks::TextChunks(int threads, size_t chunk)
+    : threadCount(threads > 0 ? threads : max(1, static_cast<int>(thread::hardware_concurrency()))),
+      chunkBytes(max<size_t>(chunk, 1)) {}
+
+TextChunks::~TextChunks() {
+    close();
+}
+
+bool TextChunks::open(const std::string& filename) {
+    close();
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(st.st_size);
+    if (length == 0) return true;
+    void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        close();
+        return false;
+    }
+    base = static_cast<char*>(p);
+    madvise(base, length, MADV_SEQUENTIAL);
+    return true;
+}
+
+void TextChunks::close() {
+    if (base) munmap(base, length);
+    base = nullptr;
+    length = 0;
+    offset = 0;
+    released = 0;
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+/**
+ * @brief Corta a rodada em blocos de ~chunkBytes estendidos até o próximo '\n'; libera as páginas da rodada
+ *        anterior (já consumida pelo chamador).
+ */
+size_t TextChunks::nextRound(vector<string_view>& chunks) {
+    chunks.clear();
+    if (base) {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t upto = offset / page * page;
+        if (upto > released) {
+            madvise(base + released, upto - released, MADV_DONTNEED);
+            released = upto;
+        }
+    }
+    while (offset < length && chunks.size() < static_cast<size_t>(threadCount)) {
+        size_t end = min(length, offset + chunkBytes);
+        if (end < length) {
+            const void* nl = memchr(base + end, '\n', length - end);
+            end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - base) + 1 : length;
+        }
+        chunks.emplace_back(base + offset, end - offset);
+        offset = end;
+    }
+    return chunks.size();
+}
+
+void TextChunks::parallelFor(size_t count, const function<void(size_t)>& fn) {
+    if (count == 0) return;
+    vector<thread> workers;
+    workers.reserve(count - 1);
+    for (size_t i = 0; i + 1 < count; ++i) workers.emplace_back(fn, i);
+    fn(count - 1);
+    for (thread& t : workers) t.join();
+}
@@ -0,0 +1,168 @@
+/**
+* @file TextChunks.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef TEXTCHUNKS_H
+#define TEXTCHUNKS_H
+
+#include "KeyTypes.h"
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Tamanho alvo de cada bloco de texto processado por uma thread (bytes).
+ */
+const std::size_t TEXT_CHUNK_BYTES = std::size_t(4) << 20;
+
+/**
+ * @brief Arquivo texto mapeado (mmap) e percorrido em rodadas de blocos de linhas completas.
+ * @details Cada rodada entrega até threads() blocos consecutivos de ~chunkBytes, sempre cortados após um '\n',
+ *          para serem interpretados em paralelo (parallelFor) e consumidos em ordem pelo chamador. A memória
+ *          de trabalho fica limitada a uma rodada: as páginas já consumidas são devolvidas ao kernel
+ *          (MADV_DONTNEED) ao pedir a rodada seguinte.
+ */
+class TextChunks {
+public:
+    /**
+     * @brief Configura o particionamento.
+     * @param threads Blocos por rodada (0 = núcleos disponíveis).
+     * @param chunkBytes Tamanho alvo de cada bloco.
+     */
+    explicit TextChunks(int threads = 0, std::size_t chunkBytes = TEXT_CHUNK_BYTES);
+
+    /**
+     * @brief Destrutor: desfaz o mapeamento.
+     */
+    ~TextChunks();
+
+    TextChunks(const TextChunks&) = delete;
+    TextChunks& operator=(const TextChunks&) = delete;
+
+    /**
+     * @brief Mapeia o arquivo para leitura sequencial (arquivo vazio é aceito).
+     * @return false se o arquivo não puder ser aberto ou mapeado.
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Desfaz o mapeamento e fecha o descritor.
+     */
+    void close();
+
+    int threads() const { return threadCount; }
+
+    /**
+     * @brief Próxima rodada de blocos.
+     * @param chunks Saída: blocos da rodada, em ordem de arquivo (cada um termina em '\n' ou no fim do arquivo).
+     * @return Quantidade de blocos (0 no fim do arquivo).
+     */
+    std::size_t nextRound(std::vector<std::string_view>& chunks);
+
+    /**
+     * @brief Executa fn(0..count-1) em paralelo (count-1 threads auxiliares e a thread chamadora).
+     */
+    static void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+private:
+    int threadCount;
+    std::size_t chunkBytes;
+    int fd = -1;
+    char* base = nullptr;
+    std::size_t length = 0;
+    std::size_t offset = 0;
+    std::size_t released = 0;
+};
+
+/**
+ * @brief Próxima linha de text (sem o '\n'); avança text.
+ * @return false se text estiver vazio.
+ */
+inline bool nextLine(std::string_view& text, std::string_view& line) {
+    if (text.empty()) return false;
+    std::size_t nl = text.find('\n');
+    if (nl == std::string_view::npos) {
+        line = text;
+        text = {};
+    } else {
+        line = text.substr(0, nl);
+        text.remove_prefix(nl + 1);
+    }
+    return true;
+}
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Próximo token separado por espaços; avança line.
+ * @return false se não houver mais tokens.
+ */
+inline bool nextToken(std::string_view& line, std::string_view& token) {
+    std::size_t a = 0;
+    while (a < line.size() && isBlank(line[a])) a++;
+    if (a == line.size()) {
+        line = {};
+        return false;
+    }
+    std::size_t b = a;
+    while (b < line.size() && !isBlank(line[b])) b++;
+    token = line.substr(a, b - a);
+    line.remove_prefix(b);
+    return true;
+}
+
+/**
+ * @brief true se a linha só tem espaços.
+ */
+inline bool blankLine(std::string_view line) {
+    for (char c : line) if (!isBlank(c)) return false;
+    return true;
+}
+
+/**
+ * @brief Próximo inteiro de line com a semântica de operator>>: ignora espaços e consome só o prefixo que
+ *        forma o número ('+' ou '-' inicial e dígitos), deixando o restante para a próxima leitura (em
+ *        "0x" lê 0 e sobra "x"; em "3-4" lê 3 e depois -4).
+ * @return false se line não começar por um inteiro ou se ele não couber em T (casos em que o stream falha).
+ */
+template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+bool extractValue(std::string_view& line, T& out) {
+    std::size_t a = 0;
+    while (a < line.size() && isBlank(line[a])) a++;
+    line.remove_prefix(a);
+    std::string_view num = line;
+    if (!num.empty() && num[0] == '+') {
+        num.remove_prefix(1);
+        if (!num.empty() && (num[0] == '+' || num[0] == '-')) return false;
+    }
+    auto [end, ec] = std::from_chars(num.data(), num.data() + num.size(), out);
+    if (ec != std::errc()) return false;
+    line.remove_prefix(static_cast<std::size_t>(end - line.data()));
+    return true;
+}
+
+/**
+ * @brief Próximo token de line como chave de largura fixa (truncado em N bytes, como operator>>).
+ */
+template <int N>
+bool extractValue(std::string_view& line, FixedString<N>& out) {
+    std::string_view token;
+    if (!nextToken(line, token)) return false;
+    out = FixedString<N>(token);
+    return true;
+}
+
+#endif
@@ -0,0 +1,16 @@
+/**
+* @file TreeCursor.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "TreeCursor.tpp"
+
+using namespace std;
+
+template class TreeCursor<std::int32_t>;
+template class TreeCursor<std::int64_t>;
+template class TreeCursor<Key16>;
@@ -0,0 +1,152 @@
+/**
+* @file TreeCursor.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef TREECURSOR_H
+#define TREECURSOR_H
+
+#include "MWayTree.h"
+#include "DataFile.h"
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Cursor ordenado sobre o índice (avanço e retrocesso).
+ * @details Mantém uma pilha explícita com o caminho raiz-nó corrente, como a pilha 'branch' de mSearch,
+ *          mas guardando a cópia de cada nó e o índice corrente nele: no topo, o índice da chave
+ *          posicionada; nos ancestrais, o filho por onde se desceu. Subir reaproveita a cópia do pai,
+ *          então uma varredura lê cada nó uma única vez. Opcionalmente antecipa a leitura das próximas
+ *          folhas (em voo no io_uring, ou posix_fadvise com pread) e busca o registro correspondente em data.bin.
+ *          O cursor é invalidado por inserções/remoções na árvore (deve ser reposicionado com seek).
+ *          Os parâmetros são os da árvore; fetch() só se aplica a chaves int (chave dos registros de data.bin).
+ */
+template <class Key = int, class Compare = std::less<Key>, int MaxM = MAX_M>
+class TreeCursor {
+public:
+    /**
+     * @brief Cria o cursor (inválido até o primeiro seek).
+     * @param tree Índice aberto.
+     * @param data (Opcional) arquivo de dados para fetch().
+     */
+    explicit TreeCursor(MWayTree<Key, Compare, MaxM>& tree, DataFile* data = nullptr);
+
+    TreeCursor(const TreeCursor&) = delete;
+    TreeCursor& operator=(const TreeCursor&) = delete;
+
+    /**
+     * @brief Ativa a leitura antecipada de até 'siblings' folhas seguintes ao descer (0 desativa).
+     * @details Só folhas são antecipadas: um irmão interno só seria usado depois de toda a subárvore corrente,
+     *          tempo em que o cache de nós já o teria despejado.
+     * @param siblings Quantidade de folhas irmãs à frente na direção da varredura.
+     */
+    void setPrefetch(int siblings);
+
+    /**
+     * @brief Limita a antecipação crescente aos filhos que podem conter chaves <= hi (varreduras [lo, hi]).
+     * @param hi Maior chave que a varredura vai visitar.
+     */
+    void setPrefetchBound(const Key& hi) { prefetchBound = hi; }
+
+    /**
+     * @brief Posiciona na menor chave >= key.
+     * @return true se existe tal chave.
+     */
+    bool seek(const Key& key);
+
+    /**
+     * @brief Posiciona na maior chave <= key (ponto de partida de varreduras decrescentes).
+     * @return true se existe tal chave.
+     */
+    bool seekFloor(const Key& key);
+
+    /**
+     * @brief Posiciona na menor chave da árvore.
+     */
+    bool seekFirst();
+
+    /**
+     * @brief Posiciona na maior chave da árvore.
+     */
+    bool seekLast();
+
+    /**
+     * @brief Avança para a próxima chave em ordem crescente.
+     * @return false ao passar do fim (cursor fica inválido).
+     */
+    bool next();
+
+    /**
+     * @brief Recua para a chave anterior.
+     * @return false ao passar do início (cursor fica inválido).
+     */
+    bool prev();
+
+    bool valid() const { return !path.empty(); }
+
+    /**
+     * @brief Chave corrente (cursor válido).
+     */
+    const Key& key() const { return path.back().node.keys[path.back().idx]; }
+
+    /**
+     * @brief Ponteiro de registro da chave corrente (NO_RECORD se desconhecido).
+     */
+    int record() const { return path.back().node.recs[path.back().idx]; }
+
+    /**
+     * @brief Lê de data.bin o registro da chave corrente (leitura posicionada; varredura sequencial
+     *        se o ponteiro for desconhecido ou não conferir).
+     * @param out Saída: registro.
+     * @return true se encontrado (sempre false para chaves que não são int).
+     */
+    bool fetch(Record& out);
+
+    /**
+     * @brief Nós lidos desde a criação do cursor.
+     */
+    long long getNodeReads() const { return nodeReads; }
+
+    /**
+     * @brief Leituras de registros em data.bin feitas por fetch().
+     */
+    long long getDataReads() const { return dataReads; }
+
+private:
+    using Node = BasicNode<Key, MaxM>;
+
+    struct Frame {
+        int pos;
+        Node node;
+        int idx;
+    };
+
+    MWayTree<Key, Compare, MaxM>& tree;
+    DataFile* data;
+    std::vector<Frame> path;
+    int prefetchSiblings = 0;
+    std::vector<int> prefetchPositions;
+    std::optional<Key> prefetchBound;
+    std::size_t leafDepth = 0; // profundidade das folhas (0 até a primeira ser lida)
+    long long nodeReads = 0;
+    long long dataReads = 0;
+
+    void push(int pos, int idx);
+    void descendLeftmost(int pos);
+    void descendRightmost(int pos);
+    bool ascendForward();
+    bool ascendBackward();
+    void prefetch(const Node& parent, int from, int step);
+};
+
+// Instanciações em TreeCursor.cpp: chaves int32, int64 e Key16 com std::less e MaxM = MAX_M;
+// para outro comparador ou outro MaxM, inclua TreeCursor.tpp.
+extern template class TreeCursor<std::int32_t>;
+extern template class TreeCursor<std::int64_t>;
+extern template class TreeCursor<Key16>;
+
+#endif
@@ -0,0 +1,215 @@
+/**
+* @file TreeCursor.tpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef TREECURSOR_TPP
+#define TREECURSOR_TPP
+
+#include "TreeCursor.h"
+#include "NodeSearch.h"
+#include <type_traits>
+
+using namespace std;
+
+template <class Key, class Compare, int MaxM>
+TreeCursor<Key, Compare, MaxM>::TreeCursor(MWayTree<Key, Compare, MaxM>& tree_, DataFile* data_) : tree(tree_), data(data_) {
+}
+
+template <class Key, class Compare, int MaxM>
+void TreeCursor<Key, Compare, MaxM>::setPrefetch(int siblings) {
+    prefetchSiblings = siblings < 0 ? 0 : siblings;
+}
+
+/**
+ * @brief Empilha o nó da posição informada (uma leitura via cache da árvore).
+ */
+template <class Key, class Compare, int MaxM>
+void TreeCursor<Key, Compare, MaxM>::push(int pos, int idx) {
+    path.push_back(Frame{pos, tree.readNode(pos), idx});
+    nodeReads++;
+    if (path.back().node.children[0] == 0) leafDepth = path.size();
+}
+
+/**
+ * @brief Antecipa a leitura dos próximos irmãos: children[from], children[from+step], ... quando são folhas
+ *        (parent no topo do caminho, um nível acima de leafDepth).
+ * @param parent Nó pai já carregado.
+ * @param from Primeiro filho a antecipar.
+ * @param step +1 (varredura crescente) ou -1 (decrescente).
+ */
+template <class Key, class Compare, int MaxM>
+void TreeCursor<Key, Compare, MaxM>::prefetch(const Node& parent, int from, int step) {
+    if (prefetchSiblings == 0 || path.size() + 1 != leafDepth) return;
+    prefetchPositions.clear();
+    for (int i = 0, c = from; i < prefetchSiblings && c >= 0 && c <= parent.n; ++i, c += step) {
+        if (parent.children[c] == 0) break;
+        if (step > 0 && c > 0 && prefetchBound && Compare{}(*prefetchBound, parent.keys[c - 1])) break;
+        prefetchPositions.push_back(parent.children[c]);
+    }
+    tree.prefetchNodes(prefetchPositions);
+}
+
+/**
+ * @brief Desce pelos filhos mais à esquerda a partir de pos; o topo fica na primeira chave da folha.
+ */
+template <class Key, class Compare, int MaxM>
+void TreeCursor<Key, Compare, MaxM>::descendLeftmost(int pos) {
+    while (pos != 0) {
+        push(pos, 0);
+        const Node& node = path.back().node;
+        if (node.children[0] != 0) prefetch(node, 1, 1);
+        pos = node.children[0];
+    }
+}
+
+/**
+ * @brief Desce pelos filhos mais à direita; o topo fica na última chave da folha.
+ */
+template <class Key, class Compare, int MaxM>
+void TreeCursor<Key, Compare, MaxM>::descendRightmost(int pos) {
+    while (pos != 0) {
+        push(pos, 0);
+        Frame& fr = path.back();
+        fr.idx = fr.node.n;
+        if (fr.node.children[fr.idx] != 0) prefetch(fr.node, fr.idx - 1, -1);
+        pos = fr.node.children[fr.idx];
+    }
+    if (!path.empty()) path.back().idx = path.back().node.n - 1;
+}
+
+/**
+ * @brief Topo esgotado para a direita: sobe até um ancestral cuja chave segue o filho por onde se desceu.
+ * @return false se a varredura terminou.
+ */
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::ascendForward() {
+    while (!path.empty()) {
+        Frame& fr = path.back();
+        if (fr.idx < fr.node.n) return true;
+        path.pop_back();
+    }
+    return false;
+}
+
+/**
+ * @brief Topo esgotado para a esquerda: sobe até um ancestral com chave antes do filho por onde se desceu.
+ * @return false se a varredura terminou.
+ */
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::ascendBackward() {
+    while (!path.empty()) {
+        Frame& fr = path.back();
+        if (fr.idx >= 0) return true;
+        path.pop_back();
+        if (!path.empty()) path.back().idx--;
+    }
+    return false;
+}
+
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::seekFirst() {
+    path.clear();
+    descendLeftmost(tree.root);
+    return ascendForward();
+}
+
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::seekLast() {
+    path.clear();
+    descendRightmost(tree.root);
+    return ascendBackward();
+}
+
+/**
+ * @brief Desce como mSearch, empilhando o caminho; pára na chave igual ou no primeiro slot maior.
+ * @param key Chave procurada.
+ * @return true se o cursor ficou em uma chave >= key.
+ */
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::seek(const Key& key) {
+    path.clear();
+    int current = tree.root;
+    while (current != 0) {
+        push(current, 0);
+        Frame& fr = path.back();
+        int i = nodeSlot(fr.node, key, Compare{});
+        fr.idx = i;
+        if (i < fr.node.n && !Compare{}(key, fr.node.keys[i])) return true;
+        current = fr.node.children[i];
+        if (current != 0) prefetch(fr.node, i + 1, 1);
+    }
+    return ascendForward();
+}
+
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::seekFloor(const Key& key) {
+    if (!seek(key)) return seekLast();
+    if (Compare{}(key, this->key())) return prev();
+    return true;
+}
+
+/**
+ * @brief Sucessor: em nó interno desce ao filho idx+1 e vai à esquerda; em folha avança ou sobe.
+ */
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::next() {
+    if (path.empty()) return false;
+    Frame& fr = path.back();
+    int child = fr.node.children[fr.idx + 1];
+    fr.idx++;
+    if (child != 0) {
+        prefetch(fr.node, fr.idx + 1, 1);
+        descendLeftmost(child);
+    }
+    return ascendForward();
+}
+
+/**
+ * @brief Antecessor: em nó interno desce ao filho idx e vai à direita; em folha recua ou sobe.
+ */
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::prev() {
+    if (path.empty()) return false;
+    Frame& fr = path.back();
+    int child = fr.node.children[fr.idx];
+    if (child != 0) {
+        prefetch(fr.node, fr.idx - 1, -1);
+        descendRightmost(child);
+    } else {
+        fr.idx--;
+    }
+    return ascendBackward();
+}
+
+/**
+ * @brief Registro da chave corrente em data.bin; as chaves dos registros são int, então os demais tipos de
+ *        chave não têm registro associado.
+ */
+template <class Key, class Compare, int MaxM>
+bool TreeCursor<Key, Compare, MaxM>::fetch(Record& out) {
+    if (!data || path.empty()) return false;
+    if constexpr (std::is_same_v<Key, int>) {
+        int k = key();
+        int rec = record();
+        bool hit = false;
+        if (rec != NO_RECORD) {
+            hit = data->readAt(rec, out) && out.key == k;
+            dataReads += data->getCounters().first;
+        }
+        if (!hit) {
+            hit = data->find(k, out);
+            dataReads += data->getCounters().first;
+        }
+        return hit;
+    } else {
+        (void)out;
+        return false;
+    }
+}
+
+#endif
@@ -0,0 +1,199 @@
+/**
+* @file WriteAheadLog.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "WriteAheadLog.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+const uint32_t FRAME_MAGIC = 0x46574C57; // "WLWF"
+const uint32_t FRAME_PAGE = 1;
+const uint32_t FRAME_COMMIT = 2;
+const uint32_t MAX_FRAME_PAYLOAD = 1u << 20;
+
+/**
+ * @brief Cabeçalho de quadro (32 bytes); checksum cobre o cabeçalho (com checksum = 0) e o payload.
+ */
+struct FrameHeader {
+    uint32_t magic;
+    uint32_t type;
+    uint64_t txn;
+    int64_t offset;
+    uint32_t length;
+    uint32_t checksum;
+};
+static_assert(sizeof(FrameHeader) == 32, "FrameHeader deve ocupar 32 bytes");
+
+/**
+ * @brief FNV-1a de 32 bits.
+ */
+uint32_t fnv1a(const char* data, size_t len, uint32_t h = 2166136261u) {
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t frameChecksum(FrameHeader fh, const char* payload) {
+    fh.checksum = 0;
+    uint32_t h = fnv1a(reinterpret_cast<const char*>(&fh), sizeof(fh));
+    return fnv1a(payload, fh.length, h);
+}
+
+/**
+ * @brief write() completo (repete em escritas parciais).
+ */
+bool writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t w = ::write(fd, data, len);
+        if (w <= 0) return false;
+        data += w;
+        len -= static_cast<size_t>(w);
+    }
+    return true;
+}
+
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+}
+
+bool WriteAheadLog::open(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return false;
+    struct stat st{};
+    bytes = (fstat(fd, &st) == 0) ? static_cast<long long>(st.st_size) : 0;
+    pending.clear();
+    unsynced = false;
+    return true;
+}
+
+void WriteAheadLog::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    pending.clear();
+}
+
+void WriteAheadLog::appendFrame(int type, long long offset, const char* payload, int length) {
+    FrameHeader fh{FRAME_MAGIC, static_cast<uint32_t>(type), nextTxn, offset, static_cast<uint32_t>(length), 0};
+    fh.checksum = frameChecksum(fh, payload);
+    const char* h = reinterpret_cast<const char*>(&fh);
+    pending.insert(pending.end(), h, h + sizeof(fh));
+    pending.insert(pending.end(), payload, payload + length);
+}
+
+void WriteAheadLog::logPage(long long offset, const char* data, int length) {
+    appendFrame(FRAME_PAGE, offset, data, length);
+}
+
+bool WriteAheadLog::commitTxn() {
+    if (fd < 0) return false;
+    appendFrame(FRAME_COMMIT, 0, nullptr, 0);
+    bool ok = writeAll(fd, pending.data(), pending.size());
+    bytes += static_cast<long long>(pending.size());
+    pending.clear();
+    nextTxn++;
+    txns++;
+    unsynced = true;
+    return ok;
+}
+
+bool WriteAheadLog::sync() {
+    if (fd < 0 || !unsynced) return true;
+    syncs++;
+    unsynced = false;
+    return ::fdatasync(fd) == 0;
+}
+
+bool WriteAheadLog::reset() {
+    if (fd < 0) return true;
+    if (::ftruncate(fd, 0) != 0) return false;
+    bytes = 0;
+    unsynced = false;
+    return ::fdatasync(fd) == 0;
+}
+
+/**
+ * @brief Lê o log inteiro, valida quadro a quadro e aplica (pwrite) cada transação ao encontrar seu commit.
+ * @details Para no primeiro quadro inválido (magic, tamanho ou checksum): dali em diante é cauda rasgada.
+ *          Quadros sem commit no fim do log são descartados. Após aplicar, fsync do índice e truncagem do log.
+ */
+int WriteAheadLog::replay(const std::string& walPath, const std::string& indexPath) {
+    int wfd = ::open(walPath.c_str(), O_RDWR);
+    if (wfd < 0) return 0;
+    struct stat st{};
+    if (fstat(wfd, &st) != 0) {
+        ::close(wfd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        ::close(wfd);
+        return 0;
+    }
+    vector<char> log(static_cast<size_t>(st.st_size));
+    size_t got = 0;
+    while (got < log.size()) {
+        ssize_t r = ::pread(wfd, log.data() + got, log.size() - got, static_cast<off_t>(got));
+        if (r <= 0) break;
+        got += static_cast<size_t>(r);
+    }
+    log.resize(got);
+
+    int ifd = ::open(indexPath.c_str(), O_RDWR);
+    if (ifd < 0) {
+        ::close(wfd);
+        return -1;
+    }
+
+    struct PageRef { int64_t offset; size_t at; uint32_t length; };
+    vector<PageRef> txnPages;
+    uint64_t txnId = 0;
+    int applied = 0;
+    bool ok = true;
+    size_t p = 0;
+    while (ok && p + sizeof(FrameHeader) <= log.size()) {
+        FrameHeader fh{};
+        memcpy(&fh, log.data() + p, sizeof(fh));
+        if (fh.magic != FRAME_MAGIC || fh.length > MAX_FRAME_PAYLOAD) break;
+        size_t payloadAt = p + sizeof(fh);
+        if (payloadAt + fh.length > log.size()) break;
+        if (frameChecksum(fh, log.data() + payloadAt) != fh.checksum) break;
+        if (fh.txn != txnId) {
+            txnPages.clear();
+            txnId = fh.txn;
+        }
+        if (fh.type == FRAME_PAGE) {
+            txnPages.push_back({fh.offset, payloadAt, fh.length});
+        } else if (fh.type == FRAME_COMMIT) {
+            for (const auto& pg : txnPages) {
+                ssize_t w = ::pwrite(ifd, log.data() + pg.at, pg.length, static_cast<off_t>(pg.offset));
+                if (w != static_cast<ssize_t>(pg.length)) ok = false;
+            }
+            txnPages.clear();
+            applied++;
+        } else {
+            break;
+        }
+        p = payloadAt + fh.length;
+    }
+
+    if (ok && applied > 0) ok = ::fsync(ifd) == 0;
+    ::close(ifd);
+    if (ok) ok = ::ftruncate(wfd, 0) == 0 && ::fdatasync(wfd) == 0;
+    ::close(wfd);
+    return ok ? applied : -1;
+}
@@ -0,0 +1,106 @@
+/**
+* @file WriteAheadLog.h
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Log de redo (somente anexação) das páginas do índice.
+ * @details Cada operação vira uma transação: quadros com a imagem completa de cada nó/header alterado
+ *          (deslocamento no arquivo + bytes) seguidos de um quadro de commit. Os quadros de uma transação
+ *          são anexados com um único write(); fdatasync (sync) é feito por operação ou em grupo, conforme o
+ *          chamador. Cada quadro leva checksum, de modo que uma escrita rasgada no fim do log é descartada
+ *          na recuperação. replay() reaplica, em ordem, apenas as transações com commit íntegro; como as
+ *          imagens são completas, reaplicar é idempotente.
+ */
+class WriteAheadLog {
+public:
+    WriteAheadLog() = default;
+
+    /**
+     * @brief Destrutor: fecha o log (sem fdatasync).
+     */
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Abre (ou cria) o log para anexação.
+     * @param path Caminho do arquivo de log.
+     * @return true em caso de sucesso.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Fecha o descritor.
+     */
+    void close();
+
+    bool isOpen() const { return fd >= 0; }
+
+    /**
+     * @brief Acrescenta à transação corrente a imagem dos bytes em 'offset' do índice.
+     */
+    void logPage(long long offset, const char* bytes, int length);
+
+    /**
+     * @brief Fecha a transação corrente: anexa quadros + commit ao log com um único write().
+     * @return false em falha de escrita.
+     */
+    bool commitTxn();
+
+    /**
+     * @brief Torna durável tudo o que foi anexado (fdatasync), se houver pendências.
+     * @return false em falha.
+     */
+    bool sync();
+
+    bool hasUnsynced() const { return unsynced; }
+
+    /**
+     * @brief Esvazia o log após um checkpoint (o índice já contém e persistiu todas as transações).
+     * @return false em falha.
+     */
+    bool reset();
+
+    /**
+     * @brief Bytes atualmente no log.
+     */
+    long long size() const { return bytes; }
+
+    long long getSyncs() const { return syncs; }
+    long long getTransactions() const { return txns; }
+
+    /**
+     * @brief Recuperação: reaplica no índice as transações confirmadas do log e o esvazia.
+     * @param walPath Caminho do log (ausente ou vazio = nada a fazer).
+     * @param indexPath Caminho do índice.
+     * @return Transações reaplicadas, ou -1 em falha de I/O.
+     */
+    static int replay(const std::string& walPath, const std::string& indexPath);
+
+private:
+    int fd = -1;
+    std::vector<char> pending;
+    std::uint64_t nextTxn = 1;
+    long long bytes = 0;
+    long long syncs = 0;
+    long long txns = 0;
+    bool unsynced = false;
+
+    void appendFrame(int type, long long offset, const char* payload, int length);
+};
+
+#endif
@@ -0,0 +1,84 @@
+/**
+* @file BatchSearchBench.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "MWayTree.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Busca em lote (mSearchMany) contra um laço de mSearch, com lotes de tamanhos crescentes.
+ * @details Carrega N chaves pares por bulkLoad e consulta chaves aleatórias (metade ausentes) com cache de
+ *          nós pequeno e sem leitura mapeada, de modo que cada acesso a nó passa por readNode. Mostra ns por
+ *          chave e acessos a nós por chave (leituras físicas + acertos de cache) nos dois caminhos. Com io=uring,
+ *          as leituras dos filhos de um lote ficam em voo juntas.
+ *          Uso: bench_batch_search [chaves (padrão 1000000)] [m (padrão 16)] [arquivo (padrão bench_batch.bin)]
+ *                                  [io: pread|uring (padrão pread)]
+ */
+int main(int argc, char** argv) {
+    const int keys = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int order = argc > 2 ? atoi(argv[2]) : 16;
+    const string bin = argc > 3 ? argv[3] : "bench_batch.bin";
+    IoBackend io = IoBackend::Pread;
+    if (argc > 4 && !parseIoBackend(argv[4], io)) {
+        printf("backend de I/O desconhecido: %s\n", argv[4]);
+        return 2;
+    }
+
+    vector<pair<int,int>> entries;
+    entries.reserve(keys);
+    for (int i = 0; i < keys; ++i) entries.emplace_back(2 * i, i);
+    MWayTree tree(order);
+    if (!MWayTree<>::createEmpty(bin, order) || !tree.openBinary(bin) || !tree.bulkLoad(entries)) {
+        printf("falha ao preparar %s\n", bin.c_str());
+        return 1;
+    }
+    tree.setMappedReads(false);
+    tree.setCacheCapacity(64);
+    tree.setIoBackend(io);
+    printf("io=%s\n", tree.getIoBackend() == IoBackend::Uring ? "uring" : "pread");
+
+    mt19937 rng(99);
+    printf("%8s %14s %14s %14s %14s\n", "lote", "ns/chave", "nos/chave", "ns/chave lote", "nos/chave lote");
+    for (int batch : {16, 256, 4096, 65536}) {
+        vector<int> probe(batch);
+        for (int& k : probe) k = static_cast<int>(rng() % (2u * keys));
+
+        long long single = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (int k : probe) {
+            tree.mSearch(k);
+            IndexCounters ic = tree.getCounters();
+            single += ic.reads + ic.cacheHits;
+        }
+        auto t1 = chrono::steady_clock::now();
+        auto result = tree.mSearchMany(probe);
+        auto t2 = chrono::steady_clock::now();
+        IndexCounters ic = tree.getCounters();
+
+        for (int i = 0; i < batch; ++i) {
+            if (get<2>(result[i]) != (get<2>(tree.mSearch(probe[i])))) {
+                printf("divergencia na chave %d\n", probe[i]);
+                return 1;
+            }
+        }
+        double ns1 = chrono::duration<double, nano>(t1 - t0).count() / batch;
+        double ns2 = chrono::duration<double, nano>(t2 - t1).count() / batch;
+        printf("%8d %14.0f %14.2f %14.0f %14.2f\n", batch, ns1, double(single) / batch, ns2,
+               double(ic.reads + ic.cacheHits) / batch);
+    }
+    tree.closeBinary();
+    remove(bin.c_str());
+    return 0;
+}
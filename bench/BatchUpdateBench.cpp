@@ -0,0 +1,97 @@
+/**
+* @file BatchUpdateBench.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "MWayTree.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Árvore de partida: chaves múltiplas de 4 carregadas por bulkLoad (80% de ocupação).
+ */
+bool prepare(MWayTree<>& tree, const string& bin, int order, int base) {
+    vector<pair<int,int>> entries;
+    for (int i = 0; i < base; ++i) entries.emplace_back(4 * i, i);
+    return MWayTree<>::createEmpty(bin, order) && tree.openBinary(bin) && tree.bulkLoad(entries, 0.8);
+}
+
+}
+
+/**
+ * @brief Inserções e remoções em lote (insertMany/deleteMany) contra laços de insertB/deleteB.
+ * @details Sobre a mesma árvore de partida, aplica um lote de chaves novas aleatórias e depois remove um
+ *          lote de chaves existentes, em WriteThrough, somando as escritas físicas no índice (W) e o tempo.
+ *          Uso: bench_batch_update [chaves iniciais (padrão 200000)] [lote (padrão 20000)] [m (padrão 16)]
+ */
+int main(int argc, char** argv) {
+    const int base = argc > 1 ? atoi(argv[1]) : 200000;
+    const int batch = argc > 2 ? atoi(argv[2]) : 20000;
+    const int order = argc > 3 ? atoi(argv[3]) : 16;
+    const string bin = "bench_batch_update.bin";
+
+    mt19937 rng(5);
+    vector<pair<int,int>> adds;
+    for (int i = 0; i < batch; ++i) adds.emplace_back(static_cast<int>(rng() % (4u * base)) | 1, i);
+    vector<int> dels;
+    for (int i = 0; i < batch; ++i) dels.push_back(4 * static_cast<int>(rng() % base));
+
+    printf("%-12s %12s %12s %12s\n", "modo", "operacao", "W indice", "ms");
+    for (int mode = 0; mode < 2; ++mode) {
+        MWayTree tree(order);
+        if (!prepare(tree, bin, order, base)) {
+            printf("falha ao preparar %s\n", bin.c_str());
+            return 1;
+        }
+        const char* name = mode == 0 ? "por chave" : "em lote";
+
+        long long writes = 0;
+        auto t0 = chrono::steady_clock::now();
+        if (mode == 0) {
+            for (const auto& [k, r] : adds) {
+                tree.insertB(k, r);
+                writes += tree.getCounters().writes;
+            }
+        } else {
+            tree.insertMany(adds);
+            writes = tree.getCounters().writes;
+        }
+        auto t1 = chrono::steady_clock::now();
+        printf("%-12s %12s %12lld %12.1f\n", name, "insercao", writes,
+               chrono::duration<double, milli>(t1 - t0).count());
+
+        writes = 0;
+        t0 = chrono::steady_clock::now();
+        if (mode == 0) {
+            for (int k : dels) {
+                tree.deleteB(k);
+                writes += tree.getCounters().writes;
+            }
+        } else {
+            tree.deleteMany(dels);
+            writes = tree.getCounters().writes;
+        }
+        t1 = chrono::steady_clock::now();
+        printf("%-12s %12s %12lld %12.1f\n", name, "remocao", writes,
+               chrono::duration<double, milli>(t1 - t0).count());
+        if (!tree.verifyIntegrity(false)) {
+            printf("falha de integridade (%s)\n", name);
+            return 1;
+        }
+        tree.closeBinary();
+    }
+    remove(bin.c_str());
+    return 0;
+}
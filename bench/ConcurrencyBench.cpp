@@ -0,0 +1,154 @@
+/**
+* @file ConcurrencyBench.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "ConcurrentTree.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Executa 'ops' operações por thread; 'writePct'% são escritas (metade inserção, metade remoção).
+ * @return Operações por segundo (todas as threads).
+ */
+template <class Search, class Insert, class Remove>
+double runWorkload(int threads, int ops, int writePct, int keySpace, Search search, Insert insert, Remove remove) {
+    vector<thread> pool;
+    auto t0 = chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([=]() {
+            mt19937 rng(1234 + t);
+            for (int i = 0; i < ops; ++i) {
+                int key = static_cast<int>(rng() % static_cast<unsigned>(keySpace));
+                int dice = static_cast<int>(rng() % 100);
+                if (dice < writePct / 2) insert(key);
+                else if (dice < writePct) remove(key);
+                else search(key);
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return double(threads) * ops / secs;
+}
+
+/**
+ * @brief Estresse: cada thread insere e remove apenas chaves k com k % threads == t e mantém o próprio
+ *        modelo; ao final o conteúdo da árvore deve coincidir com a união dos modelos.
+ */
+bool stress(MWayTree<>& tree, int threads, int ops, int keySpace) {
+    vector<vector<char>> present(threads, vector<char>(keySpace, 0));
+    for (int k = 0; k < keySpace; ++k) present[k % threads][k] = get<2>(tree.mSearch(k));
+    {
+        ConcurrentTree ct(tree);
+        if (!ct.isOpen()) return false;
+        vector<thread> pool;
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t]() {
+                mt19937 rng(777 + t);
+                vector<char>& mine = present[t];
+                for (int i = 0; i < ops; ++i) {
+                    int key = static_cast<int>(rng() % static_cast<unsigned>(keySpace / threads)) * threads + t;
+                    int dice = static_cast<int>(rng() % 3);
+                    if (dice == 0) {
+                        if (ct.insert(key, key) == static_cast<bool>(mine[key])) mine[key] = 2;
+                        else if (mine[key] != 2) mine[key] = 1;
+                    } else if (dice == 1) {
+                        int rec = -1;
+                        bool had = ct.remove(key, &rec);
+                        if (had != static_cast<bool>(mine[key])) mine[key] = 2;
+                        else if (mine[key] != 2) mine[key] = 0;
+                    } else if (get<2>(ct.search(key)) != static_cast<bool>(mine[key])) {
+                        mine[key] = 2;
+                    }
+                }
+            });
+        }
+        for (auto& th : pool) th.join();
+    }
+    if (!tree.verifyIntegrity()) return false;
+    for (int k = 0; k < keySpace; ++k) {
+        char want = present[k % threads][k];
+        if (want == 2 || get<2>(tree.mSearch(k)) != static_cast<bool>(want)) {
+            printf("divergencia na chave %d\n", k);
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+/**
+ * @brief Vazão de ConcurrentTree (leituras otimistas com versão por nó) contra um MWayTree protegido por um
+ *        mutex global.
+ * @details Carrega N chaves pares por bulkLoad e, para 1, 2, 4, ... threads (até hardware_concurrency),
+ *          mede operações por segundo em quatro cargas: somente leitura, 99/1, 90/10 e 50/50 (leitura/escrita,
+ *          escritas divididas entre inserção e remoção de chaves aleatórias em [0, 2N)). Ao final executa o
+ *          teste de estresse com todas as threads e verifica a integridade da árvore.
+ *          Uso: bench_concurrency [chaves (padrão 200000)] [m (padrão 32)] [ops/thread (padrão 100000)]
+ *               [arquivo (padrão bench_concurrency.bin)]
+ */
+int main(int argc, char** argv) {
+    const int keys = argc > 1 ? atoi(argv[1]) : 200000;
+    const int order = argc > 2 ? atoi(argv[2]) : 32;
+    const int ops = argc > 3 ? atoi(argv[3]) : 100000;
+    const string bin = argc > 4 ? argv[4] : "bench_concurrency.bin";
+    const int maxThreads = max(1u, thread::hardware_concurrency());
+
+    vector<pair<int,int>> entries;
+    entries.reserve(keys);
+    for (int i = 0; i < keys; ++i) entries.emplace_back(2 * i, i);
+    MWayTree tree(order);
+    if (!MWayTree<>::createEmpty(bin, order) || !tree.openBinary(bin) || !tree.bulkLoad(entries)) {
+        printf("falha ao preparar %s\n", bin.c_str());
+        return 1;
+    }
+
+    struct Load { const char* name; int writePct; };
+    printf("%-10s %8s %16s %16s %10s %10s\n", "carga", "threads", "mutex (ops/s)", "otimista (ops/s)", "restarts",
+           "retries");
+    for (Load load : {Load{"leitura", 0}, Load{"99/1", 1}, Load{"90/10", 10}, Load{"50/50", 50}}) {
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            mutex global;
+            double base = runWorkload(threads, ops, load.writePct, 2 * keys,
+                [&](int k) { lock_guard<mutex> g(global); tree.mSearch(k); },
+                [&](int k) { lock_guard<mutex> g(global); if (!get<2>(tree.mSearch(k))) tree.insertB(k, k); },
+                [&](int k) { lock_guard<mutex> g(global); tree.deleteB(k); });
+            tree.sync();
+
+            double optimistic;
+            ConcurrentStats st;
+            {
+                ConcurrentTree ct(tree);
+                optimistic = runWorkload(threads, ops, load.writePct, 2 * keys,
+                    [&](int k) { ct.search(k); },
+                    [&](int k) { ct.insert(k, k); },
+                    [&](int k) { ct.remove(k); });
+                st = ct.getStats();
+            }
+            printf("%-10s %8d %16.0f %16.0f %10lld %10lld\n", load.name, threads, base, optimistic, st.restarts,
+                   st.retries);
+        }
+    }
+
+    bool ok = stress(tree, maxThreads, ops, 2 * keys);
+    printf("estresse com %d threads: %s\n", maxThreads, ok ? "OK" : "FALHOU");
+    tree.closeBinary();
+    remove(bin.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/**
+* @file InterleavedSearchBench.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "MWayTree.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Buscas intercaladas (mSearchInterleaved) contra um laço de mSearch, com larguras crescentes.
+ * @details Carrega N chaves pares por bulkLoad e consulta chaves aleatórias (metade ausentes) em dois modos:
+ *          leitura mapeada (as esperas são faltas de cache do processador, cobertas pelo prefetch de cada
+ *          nível) e cache de nós pequeno sem mapeamento (a maior parte dos nós vem de leituras físicas, em voo
+ *          juntas com io=uring). Mostra ns por chave, a aceleração sobre o laço e nós acessados por chave.
+ *          Uso: bench_interleaved_search [chaves (padrão 1000000)] [m (padrão 16)]
+ *                                        [arquivo (padrão bench_interleaved.bin)] [io: pread|uring (padrão pread)]
+ */
+int main(int argc, char** argv) {
+    const int keys = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int order = argc > 2 ? atoi(argv[2]) : 16;
+    const string bin = argc > 3 ? argv[3] : "bench_interleaved.bin";
+    IoBackend io = IoBackend::Pread;
+    if (argc > 4 && !parseIoBackend(argv[4], io)) {
+        printf("backend de I/O desconhecido: %s\n", argv[4]);
+        return 2;
+    }
+
+    vector<pair<int,int>> entries;
+    entries.reserve(keys);
+    for (int i = 0; i < keys; ++i) entries.emplace_back(2 * i, i);
+    MWayTree tree(order);
+    if (!MWayTree<>::createEmpty(bin, order) || !tree.openBinary(bin) || !tree.bulkLoad(entries)) {
+        printf("falha ao preparar %s\n", bin.c_str());
+        return 1;
+    }
+    tree.setIoBackend(io);
+    printf("io=%s\n", tree.getIoBackend() == IoBackend::Uring ? "uring" : "pread");
+
+    mt19937 rng(7);
+    const int probes = 200000;
+    vector<int> probe(probes);
+    for (int& k : probe) k = static_cast<int>(rng() % (2u * keys));
+
+    for (bool mapped : {true, false}) {
+        tree.setMappedReads(mapped);
+        tree.setCacheCapacity(mapped ? NodeCache<>::DEFAULT_CAPACITY : 64);
+        printf("%s\n", mapped ? "modo mapeado" : "modo cache (64 nos)");
+        printf("%8s %14s %14s %14s\n", "largura", "ns/chave", "aceleracao", "nos/chave");
+
+        long long single = 0;
+        vector<tuple<int, int, bool>> expected(probes);
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < probes; ++i) {
+            expected[i] = tree.mSearch(probe[i]);
+            IndexCounters ic = tree.getCounters();
+            single += ic.reads + ic.cacheHits + ic.mappedReads;
+        }
+        auto t1 = chrono::steady_clock::now();
+        double base = chrono::duration<double, nano>(t1 - t0).count() / probes;
+        printf("%8s %14.0f %14.2f %14.2f\n", "mSearch", base, 1.0, double(single) / probes);
+
+        for (int width : {1, 4, 8, 16, 32, 64}) {
+            auto t2 = chrono::steady_clock::now();
+            auto result = tree.mSearchInterleaved(probe, nullptr, width);
+            auto t3 = chrono::steady_clock::now();
+            IndexCounters ic = tree.getCounters();
+            for (int i = 0; i < probes; ++i) {
+                if (result[i] != expected[i]) {
+                    printf("divergencia na chave %d (largura %d)\n", probe[i], width);
+                    return 1;
+                }
+            }
+            double ns = chrono::duration<double, nano>(t3 - t2).count() / probes;
+            printf("%8d %14.0f %14.2f %14.2f\n", width, ns, base / ns,
+                   double(ic.reads + ic.cacheHits + ic.mappedReads) / probes);
+        }
+    }
+    tree.closeBinary();
+    remove(bin.c_str());
+    return 0;
+}
@@ -0,0 +1,455 @@
+/**
+* @file MwaysBench.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "DataFile.h"
+#include "MWayTree.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Parâmetros da execução (flags --nome=valor).
+ */
+struct Options {
+    int keys = 100000;        // chaves carregadas na fase de carga em lote
+    int ops = 20000;          // operações por fase (busca, inserção, remoção)
+    int scans = 2000;         // varreduras na fase de intervalo
+    int rangeLen = 100;       // chaves por varredura
+    int batch = 64;           // chaves por lote na fase batch_lookup
+    int order = 16;
+    double fill = 0.8;        // ocupação da carga em lote
+    double theta = 0.99;      // parâmetro da Zipf
+    size_t cacheNodes = 0;    // 0 = capacidade padrão do cache
+    bool writeBack = false;
+    bool mapped = false;
+    IoBackend io = IoBackend::Pread;
+    unsigned seed = 42;
+    string workload = "all";
+    string format = "json";
+    string out;               // vazio = stdout
+    string dir = ".";
+};
+
+/**
+ * @brief Resultado de uma fase: tempo total, latências por operação e I/O acumulado.
+ */
+struct PhaseResult {
+    PhaseResult(string w, string p) : workload(std::move(w)), phase(std::move(p)) {}
+
+    string workload;
+    string phase;
+    long long ops = 0;
+    double seconds = 0;
+    vector<long long> latencyNs;
+    long long logical = 0;    // nós consultados (acertos + faltas do cache + visitas mapeadas)
+    long long physical = 0;   // leituras + escritas de nós no arquivo do índice
+    long long dataIo = 0;     // leituras + escritas de registros em data.bin
+    long long indexBytes = 0;
+    long long dataBytes = 0;
+    bool timed = true;          // false: fase sem latência por operação (percentis saem null)
+    bool logicalCounted = true; // false: fase fora do cache de nós (index_logical_per_op sai null)
+};
+
+/**
+ * @brief Gerador Zipf por CDF pré-calculada: rank 0 é o mais popular.
+ */
+class Zipf {
+public:
+    Zipf(int n, double theta) : cdf(static_cast<size_t>(n)) {
+        double sum = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += 1.0 / pow(static_cast<double>(i + 1), theta);
+            cdf[static_cast<size_t>(i)] = sum;
+        }
+        for (double& c : cdf) c /= sum;
+    }
+
+    int operator()(mt19937_64& rng) const {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+        auto it = lower_bound(cdf.begin(), cdf.end(), u);
+        return static_cast<int>(min<ptrdiff_t>(it - cdf.begin(), static_cast<ptrdiff_t>(cdf.size()) - 1));
+    }
+
+private:
+    vector<double> cdf;
+};
+
+/**
+ * @brief Sequências de chaves de cada fase, geradas antes da medição.
+ * @details As chaves carregadas são pares (2*i); inserções usam ímpares, então nunca colidem com a carga.
+ *          uniform: todas as fases sorteiam uniformemente. zipfian: ranks Zipf sobre uma permutação das
+ *          chaves (as populares ficam espalhadas). sequential: buscas e remoções em ordem crescente e
+ *          inserções após a maior chave. delete-heavy: sorteio uniforme, com max(ops, metade) das chaves
+ *          removidas (no máximo todas, cada uma uma vez) e um quarto das inserções.
+ */
+struct Workload {
+    vector<int> lookups;
+    vector<int> scanStarts;
+    vector<int> inserts;
+    vector<int> deletes;
+};
+
+Workload makeWorkload(const string& name, const Options& o) {
+    Workload w;
+    mt19937_64 rng(o.seed);
+    const int n = o.keys;
+    auto loaded = [](int i) { return 2 * i; };
+    auto pick = [&](int bound) { return static_cast<int>(rng() % static_cast<unsigned long long>(bound)); };
+
+    if (name == "sequential") {
+        for (int i = 0; i < o.ops; ++i) w.lookups.push_back(loaded(i % n));
+        for (int i = 0; i < o.scans; ++i) w.scanStarts.push_back(loaded((i * o.rangeLen) % n));
+        for (int i = 0; i < o.ops; ++i) w.inserts.push_back(2 * n + 2 * i + 1);
+        for (int i = 0; i < min(o.ops, n); ++i) w.deletes.push_back(loaded(i));
+        return w;
+    }
+    if (name == "zipfian") {
+        Zipf zipf(n, o.theta);
+        vector<int> perm(static_cast<size_t>(n));
+        iota(perm.begin(), perm.end(), 0);
+        shuffle(perm.begin(), perm.end(), rng);
+        auto hot = [&]() { return perm[static_cast<size_t>(zipf(rng))]; };
+        for (int i = 0; i < o.ops; ++i) w.lookups.push_back(loaded(hot()));
+        for (int i = 0; i < o.scans; ++i) w.scanStarts.push_back(loaded(hot()));
+        for (int i = 0; i < o.ops; ++i) w.inserts.push_back(loaded(hot()) + 1);
+        for (int i = 0; i < o.ops; ++i) w.deletes.push_back(loaded(hot()));
+        return w;
+    }
+    const bool heavy = name == "delete-heavy";
+    for (int i = 0; i < o.ops; ++i) w.lookups.push_back(loaded(pick(n)));
+    for (int i = 0; i < o.scans; ++i) w.scanStarts.push_back(loaded(pick(n)));
+    for (int i = 0; i < (heavy ? o.ops / 4 : o.ops); ++i) w.inserts.push_back(2 * pick(n) + 1);
+    if (heavy) {
+        vector<int> perm(static_cast<size_t>(n));
+        iota(perm.begin(), perm.end(), 0);
+        shuffle(perm.begin(), perm.end(), rng);
+        const int removals = min(n, max(o.ops, n / 2));
+        for (int i = 0; i < removals; ++i) w.deletes.push_back(loaded(perm[static_cast<size_t>(i)]));
+    } else {
+        for (int i = 0; i < o.ops; ++i) w.deletes.push_back(loaded(pick(n)));
+    }
+    return w;
+}
+
+long long fileBytes(const string& path) {
+    error_code ec;
+    auto size = filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<long long>(size);
+}
+
+long long percentile(const vector<long long>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t i = static_cast<size_t>(ceil(p * static_cast<double>(sorted.size())));
+    return sorted[min(sorted.size() - 1, i == 0 ? 0 : i - 1)];
+}
+
+/**
+ * @brief Executa uma operação medindo a latência e somando os contadores do índice e do data.bin.
+ */
+template <class Op>
+void measure(PhaseResult& r, MWayTree<>& tree, DataFile& data, Op&& op) {
+    tree.resetCounters();
+    data.resetCounters();
+    auto t0 = chrono::steady_clock::now();
+    op();
+    auto t1 = chrono::steady_clock::now();
+    r.latencyNs.push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+    IndexCounters c = tree.getCounters();
+    r.logical += c.cacheHits + c.cacheMisses + c.mappedReads;
+    r.physical += c.reads + c.writes;
+    auto [dr, dw] = data.getCounters();
+    r.dataIo += dr + dw;
+    r.ops++;
+}
+
+class Reporter {
+public:
+    explicit Reporter(const Options& o) : opts(o) {
+        if (!o.out.empty()) {
+            file = fopen(o.out.c_str(), "w");
+            if (file) sink = file;
+        }
+        if (opts.format == "csv")
+            fprintf(sink, "workload,phase,keys,order,ops,seconds,ops_per_sec,p50_us,p99_us,p999_us,"
+                          "index_logical_per_op,index_physical_per_op,data_io_per_op,index_bytes,data_bytes\n");
+    }
+
+    ~Reporter() {
+        if (file) fclose(file);
+    }
+
+    bool ok() const { return opts.out.empty() || file != nullptr; }
+
+    /**
+     * @brief Uma linha por fase: JSON Lines (padrão) ou CSV com cabeçalho.
+     */
+    void emit(PhaseResult& r) {
+        sort(r.latencyNs.begin(), r.latencyNs.end());
+        double ops = static_cast<double>(max(1LL, r.ops));
+        double rate = r.seconds > 0 ? static_cast<double>(r.ops) / r.seconds : 0;
+        string p50 = value(r.timed, percentile(r.latencyNs, 0.50) / 1000.0);
+        string p99 = value(r.timed, percentile(r.latencyNs, 0.99) / 1000.0);
+        string p999 = value(r.timed, percentile(r.latencyNs, 0.999) / 1000.0);
+        string logical = value(r.logicalCounted, r.logical / ops);
+        if (opts.format == "csv") {
+            fprintf(sink, "%s,%s,%d,%d,%lld,%.6f,%.1f,%s,%s,%s,%s,%.3f,%.3f,%lld,%lld\n",
+                    r.workload.c_str(), r.phase.c_str(), opts.keys, opts.order, r.ops, r.seconds, rate,
+                    p50.c_str(), p99.c_str(), p999.c_str(), logical.c_str(), r.physical / ops, r.dataIo / ops,
+                    r.indexBytes, r.dataBytes);
+        } else {
+            fprintf(sink, "{\"workload\":\"%s\",\"phase\":\"%s\",\"keys\":%d,\"order\":%d,\"ops\":%lld,"
+                          "\"seconds\":%.6f,\"ops_per_sec\":%.1f,\"p50_us\":%s,\"p99_us\":%s,\"p999_us\":%s,"
+                          "\"index_logical_per_op\":%s,\"index_physical_per_op\":%.3f,\"data_io_per_op\":%.3f,"
+                          "\"index_bytes\":%lld,\"data_bytes\":%lld}\n",
+                    r.workload.c_str(), r.phase.c_str(), opts.keys, opts.order, r.ops, r.seconds, rate,
+                    p50.c_str(), p99.c_str(), p999.c_str(), logical.c_str(), r.physical / ops, r.dataIo / ops,
+                    r.indexBytes, r.dataBytes);
+        }
+        fflush(sink);
+    }
+
+private:
+    const Options& opts;
+
+    /**
+     * @brief Valor com 3 casas ou, se a fase não o mede, null (JSON) / campo vazio (CSV).
+     */
+    string value(bool measured, double v) const {
+        if (!measured) return opts.format == "csv" ? "" : "null";
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.3f", v);
+        return buf;
+    }
+
+    FILE* file = nullptr;
+    FILE* sink = stdout;
+};
+
+/**
+ * @brief Roda as seis fases de uma carga sobre arquivos novos: carga em lote, busca pontual, busca em lote,
+ *        varredura de intervalo, inserção e remoção (índice + data.bin).
+ */
+bool runWorkload(const string& name, const Options& o, Reporter& report) {
+    const string bin = o.dir + "/mways_bench.bin";
+    const string dat = o.dir + "/mways_bench.dat";
+    Workload w = makeWorkload(name, o);
+
+    MWayTree tree(o.order);
+    DataFile data;
+    auto finish = [&](PhaseResult& r, chrono::steady_clock::time_point t0) {
+        tree.sync();
+        r.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        r.indexBytes = fileBytes(bin);
+        r.dataBytes = fileBytes(dat);
+        report.emit(r);
+    };
+
+    // Carga em lote: data.bin gravado em sequência e índice construído bottom-up. Não há latência por chave
+    // e bulkLoad não passa pelo cache de nós: percentis e nós consultados saem null.
+    {
+        PhaseResult r{name, "bulk_load"};
+        r.timed = false;
+        r.logicalCounted = false;
+        auto t0 = chrono::steady_clock::now();
+        ofstream out(dat, ios::binary | ios::trunc);
+        vector<pair<int,int>> entries;
+        entries.reserve(static_cast<size_t>(o.keys));
+        for (int i = 0; i < o.keys; ++i) {
+            Record rec{};
+            rec.key = 2 * i;
+            rec.active = 1;
+            snprintf(rec.payload, sizeof(rec.payload), "Funcionario %d | bench", rec.key);
+            out.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+            entries.emplace_back(rec.key, i);
+        }
+        out.close();
+        tree.setIoBackend(o.io);
+        data.setIoBackend(o.io);
+        if (!out || !MWayTree<>::createEmpty(bin, o.order) || !tree.openBinary(bin) || !data.open(dat)) {
+            fprintf(stderr, "falha ao criar %s/%s\n", bin.c_str(), dat.c_str());
+            return false;
+        }
+        if (o.cacheNodes > 0) tree.setCacheCapacity(o.cacheNodes);
+        tree.setWriteMode(o.writeBack ? WriteMode::WriteBack : WriteMode::WriteThrough);
+        tree.setMappedReads(o.mapped);
+        tree.resetCounters();
+        if (!tree.bulkLoad(entries, o.fill)) return false;
+        IndexCounters c = tree.getCounters();
+        r.ops = o.keys;
+        r.physical = c.reads + c.writes;
+        r.dataIo = o.keys;
+        finish(r, t0);
+    }
+
+    {
+        PhaseResult r{name, "lookup"};
+        auto t0 = chrono::steady_clock::now();
+        for (int k : w.lookups) {
+            measure(r, tree, data, [&] {
+                int rec = NO_RECORD;
+                Record out{};
+                if (get<2>(tree.mSearch(k, nullptr, &rec)) && rec != NO_RECORD) data.readAt(rec, out);
+            });
+        }
+        finish(r, t0);
+    }
+
+    // Busca em lote: mSearchMany e readMany por lote (leituras em voo juntas com --io=uring); latências por
+    // lote, ops e I/O por chave.
+    {
+        PhaseResult r{name, "batch_lookup"};
+        auto t0 = chrono::steady_clock::now();
+        vector<int> recs;
+        vector<Record> rows;
+        vector<char> ok;
+        for (size_t i = 0; i < w.lookups.size(); i += static_cast<size_t>(o.batch)) {
+            span<const int> keys(w.lookups.data() + i, min(w.lookups.size() - i, static_cast<size_t>(o.batch)));
+            measure(r, tree, data, [&] {
+                tree.mSearchMany(keys, &recs);
+                recs.erase(remove(recs.begin(), recs.end(), NO_RECORD), recs.end());
+                data.readMany(recs, rows, ok);
+            });
+        }
+        r.ops = static_cast<long long>(w.lookups.size());
+        finish(r, t0);
+    }
+
+    {
+        PhaseResult r{name, "range_scan"};
+        auto t0 = chrono::steady_clock::now();
+        for (int lo : w.scanStarts) {
+            measure(r, tree, data, [&] {
+                tree.rangeScan(lo, lo + 2 * (o.rangeLen - 1), [](const int&, int) { return true; });
+            });
+        }
+        finish(r, t0);
+    }
+
+    {
+        PhaseResult r{name, "insert"};
+        auto t0 = chrono::steady_clock::now();
+        for (int k : w.inserts) {
+            measure(r, tree, data, [&] {
+                Record rec{};
+                rec.key = k;
+                snprintf(rec.payload, sizeof(rec.payload), "Funcionario %d | bench", k);
+                int recNo = 0;
+                if (data.insert(rec, recNo)) tree.insertB(k, recNo);
+            });
+        }
+        finish(r, t0);
+    }
+
+    {
+        PhaseResult r{name, "delete"};
+        auto t0 = chrono::steady_clock::now();
+        for (int k : w.deletes) {
+            measure(r, tree, data, [&] {
+                int rec = NO_RECORD;
+                if (tree.deleteB(k, &rec) && rec != NO_RECORD) data.removeAt(rec, k);
+            });
+        }
+        finish(r, t0);
+    }
+
+    bool ok = tree.verifyIntegrity(false);
+    if (!ok) fprintf(stderr, "falha de integridade (%s)\n", name.c_str());
+    tree.closeBinary();
+    data.close();
+    remove(bin.c_str());
+    remove(dat.c_str());
+    remove(HashIndex::pathFor(dat).c_str());
+    return ok;
+}
+
+bool parseOptions(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == string::npos) return false;
+        string name = arg.substr(2, eq - 2);
+        string value = arg.substr(eq + 1);
+        if (name == "keys") o.keys = atoi(value.c_str());
+        else if (name == "ops") o.ops = atoi(value.c_str());
+        else if (name == "scans") o.scans = atoi(value.c_str());
+        else if (name == "range") o.rangeLen = atoi(value.c_str());
+        else if (name == "batch") o.batch = atoi(value.c_str());
+        else if (name == "order") o.order = atoi(value.c_str());
+        else if (name == "fill") o.fill = atof(value.c_str());
+        else if (name == "theta") o.theta = atof(value.c_str());
+        else if (name == "cache") o.cacheNodes = static_cast<size_t>(atoll(value.c_str()));
+        else if (name == "write-back") o.writeBack = value == "1";
+        else if (name == "mapped") o.mapped = value == "1";
+        else if (name == "io") {
+            if (!parseIoBackend(value, o.io)) return false;
+        }
+        else if (name == "seed") o.seed = static_cast<unsigned>(atoi(value.c_str()));
+        else if (name == "workload") o.workload = value;
+        else if (name == "format") o.format = value;
+        else if (name == "out") o.out = value;
+        else if (name == "dir") o.dir = value;
+        else return false;
+    }
+    return o.keys > 0 && o.ops >= 0 && o.scans >= 0 && o.rangeLen > 0 && o.batch > 0 && o.order >= 3 && o.order <= MAX_M &&
+           (o.format == "json" || o.format == "csv");
+}
+
+}
+
+/**
+ * @brief Harness de desempenho do índice e do arquivo de dados.
+ * @details Para cada carga (uniform, zipfian, sequential, delete-heavy) cria arquivos novos e mede as fases
+ *          bulk_load, lookup, batch_lookup, range_scan, insert e delete: vazão, latências p50/p99/p999, I/O lógico e
+ *          físico do índice e I/O do data.bin por operação e o tamanho final dos arquivos. Cada fase gera
+ *          uma linha JSON (ou CSV), pronta para comparar execuções.
+ *          Uso: mways_bench [--keys=N] [--ops=N] [--scans=N] [--range=N] [--batch=N] [--order=M] [--fill=F] [--theta=T]
+ *                           [--cache=NOS] [--write-back=1] [--mapped=1] [--io=pread|uring] [--seed=S]
+ *                           [--workload=all|uniform|zipfian|sequential|delete-heavy] [--format=json|csv]
+ *                           [--out=ARQUIVO] [--dir=PASTA]
+ */
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        fprintf(stderr, "uso: mways_bench [--keys=N] [--ops=N] [--scans=N] [--range=N] [--batch=N] [--order=M] [--fill=F] "
+                        "[--theta=T] [--cache=NOS] [--write-back=1] [--mapped=1] [--io=pread|uring] [--seed=S] "
+                        "[--workload=all|uniform|zipfian|sequential|delete-heavy] [--format=json|csv] "
+                        "[--out=ARQUIVO] [--dir=PASTA]\n");
+        return 2;
+    }
+    vector<string> workloads{"uniform", "zipfian", "sequential", "delete-heavy"};
+    if (o.workload != "all") {
+        if (find(workloads.begin(), workloads.end(), o.workload) == workloads.end()) {
+            fprintf(stderr, "carga desconhecida: %s\n", o.workload.c_str());
+            return 2;
+        }
+        workloads = {o.workload};
+    }
+    Reporter report(o);
+    if (!report.ok()) {
+        fprintf(stderr, "falha ao abrir %s\n", o.out.c_str());
+        return 1;
+    }
+    for (const string& name : workloads)
+        if (!runWorkload(name, o, report)) return 1;
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+* @file NodeSearchBench.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "NodeSearch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Microbenchmark dos kernels de busca no nó.
+ * @details Para cada m, monta um conjunto de nós cheios (m-1 chaves crescentes aleatórias) maior que a L1
+ *          e mede ns por busca de cada kernel, com chaves de consulta aleatórias. Antes de medir, confere
+ *          que todos os kernels devolvem o mesmo slot que o escalar.
+ *          Uso: bench_node_search [buscas por medida (padrão 4000000)]
+ */
+int main(int argc, char** argv) {
+    const long long queries = argc > 1 ? atoll(argv[1]) : 4000000;
+    const int nodeCount = 4096;
+    const SearchKernel kernels[] = {SearchKernel::Scalar, SearchKernel::Branchless, SearchKernel::SSE,
+                                    SearchKernel::AVX2};
+
+    printf("kernel ativo (auto): %s\n", searchKernelName(activeSearchKernel()));
+    printf("%4s", "m");
+    for (SearchKernel k : kernels) printf(" %12s", searchKernelName(k));
+    printf("   (ns/busca)\n");
+
+    mt19937 rng(12345);
+    for (int m : {4, 8, 16, 24, 32}) {
+        vector<Node> nodes(nodeCount);
+        for (Node& node : nodes) {
+            node.n = m - 1;
+            int k = static_cast<int>(rng() % 16);
+            for (int i = 0; i < node.n; ++i) {
+                node.keys[i] = k;
+                k += 1 + static_cast<int>(rng() % 16);
+            }
+        }
+        vector<int> probes(1 << 16);
+        for (int& p : probes) p = static_cast<int>(rng() % (16u * static_cast<unsigned>(m)));
+
+        for (SearchKernel k : kernels) {
+            SlotSearchFn fn = searchKernelFunction(k);
+            if (!fn) continue;
+            for (size_t q = 0; q < probes.size(); ++q) {
+                const Node& node = nodes[q % nodes.size()];
+                if (fn(node.keys, node.n, probes[q]) != slotSearchScalar(node.keys, node.n, probes[q])) {
+                    printf("divergencia: kernel %s, m=%d\n", searchKernelName(k), m);
+                    return 1;
+                }
+            }
+        }
+
+        printf("%4d", m);
+        for (SearchKernel k : kernels) {
+            SlotSearchFn fn = searchKernelFunction(k);
+            if (!fn) {
+                printf(" %12s", "n/d");
+                continue;
+            }
+            long long sink = 0;
+            auto t0 = chrono::steady_clock::now();
+            for (long long q = 0; q < queries; ++q) {
+                const Node& node = nodes[static_cast<size_t>(q * 2654435761LL) % nodes.size()];
+                sink += fn(node.keys, node.n, probes[static_cast<size_t>(q) & (probes.size() - 1)]);
+            }
+            auto t1 = chrono::steady_clock::now();
+            double ns = chrono::duration<double, nano>(t1 - t0).count() / static_cast<double>(queries);
+            printf(" %12.2f", ns);
+            if (sink == -1) printf("!");
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+* @file WalBench.cpp
+ * @authors
+ *   Francisco Eduardo Fontenele - 15452569
+ *   Vinicius Botte - 15522900
+ *
+ * AED II - Trabalho 1
+ */
+
+#include "MWayTree.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+struct WalCase {
+    const char* name;
+    WalMode mode;
+    int batch;
+};
+
+}
+
+/**
+ * @brief Benchmark de durabilidade: inserções aleatórias sob cada política do WAL.
+ * @details Compara o modo sem log (WriteThrough, sem fsync: referência sem garantia) com fsync por operação
+ *          e commit em grupo de tamanhos crescentes (cache grande, para que despejos não forcem fdatasync). Mostra operações/s, fdatasyncs no log e escritas no índice.
+ *          Uso: bench_wal [operações (padrão 5000)] [m (padrão 5)] [arquivo (padrão bench_wal.bin)]
+ */
+int main(int argc, char** argv) {
+    const int ops = argc > 1 ? atoi(argv[1]) : 5000;
+    const int order = argc > 2 ? atoi(argv[2]) : 5;
+    const string bin = argc > 3 ? argv[3] : "bench_wal.bin";
+
+    const WalCase cases[] = {
+        {"sem WAL", WalMode::Off, 0},
+        {"fsync/op", WalMode::FsyncPerOp, 0},
+        {"grupo 8", WalMode::GroupCommit, 8},
+        {"grupo 64", WalMode::GroupCommit, 64},
+        {"grupo 512", WalMode::GroupCommit, 512},
+    };
+
+    printf("%-10s %10s %12s %10s %12s\n", "modo", "ops", "ops/s", "fsyncs", "W indice");
+    for (const WalCase& c : cases) {
+        if (!MWayTree<>::createEmpty(bin, order)) {
+            printf("falha ao criar %s\n", bin.c_str());
+            return 1;
+        }
+        MWayTree tree(order);
+        if (!tree.openBinary(bin) || !tree.setWalMode(c.mode)) {
+            printf("falha ao abrir %s\n", bin.c_str());
+            return 1;
+        }
+        tree.setBatchSize(c.batch);
+        tree.setCacheCapacity(1 << 16); // sem despejos: cada fdatasync vem da política de commit
+
+        mt19937 rng(7);
+        long long writes = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < ops; ++i) {
+            tree.insertB(static_cast<int>(rng() % 1000000), i);
+            writes += tree.getCounters().writes;
+        }
+        tree.commit();
+        auto t1 = chrono::steady_clock::now();
+        double secs = chrono::duration<double>(t1 - t0).count();
+        printf("%-10s %10d %12.0f %10lld %12lld\n", c.name, ops, ops / secs, tree.getWalSyncs(), writes);
+        tree.closeBinary();
+    }
+    return 0;
+}
@@ -9,6 +9,10 @@
 
 #include "MWayTree.h"
 #include "DataFile.h"
+#include "Compactor.h"
+#include "TreeCursor.h"
+#include "CommandLine.h"
+#include "ImportPipeline.h"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -65,6 +69,15 @@ static int readIntInRange(const string& prompt, int minV, int maxV) {
     }
 }
 
+/**
+ * @brief Exibe o resumo da importação: leituras da entrada e bytes gravados por arquivo.
+ */
+static void printImportStats(const ImportStats& is) {
+    cout << "Importacao: " << is.inputPasses << " leitura(s) da entrada (" << is.inputBytes << " bytes), "
+         << is.bytesWritten() << " bytes gravados (dados=" << is.dataBytes << ", indice=" << is.indexBytes
+         << ", ordenacao=" << is.sortBytes << ")." << endl;
+}
+
 /**
  * @brief Lê qualquer inteiro com re-prompt até validar.
  * @param prompt Mensagem exibida.
@@ -110,25 +123,29 @@ static char readYesNo(const string& prompt) {
  * @param tree Árvore índice aberta.
  * @param data Arquivo de dados aberto.
  */
-void runSearchInterface(MWayTree& tree, DataFile& data) {
+void runSearchInterface(MWayTree<>& tree, DataFile& data) {
     while (true) {
         int key = readAnyInt("Chave de busca: ");
-        auto [node, pos, found] = tree.mSearch(key);
-        auto [idxR, idxW] = tree.getCounters();
+        int recPos = NO_RECORD;
+        auto [node, pos, found] = tree.mSearch(key, nullptr, &recPos);
+        IndexCounters ic = tree.getCounters();
         cout << " " << key << " (" << node << "," << pos << "," << (found ? "true" : "false") << ")" << endl;
-        cout << "I/O indice: R=" << idxR << " W=" << idxW << endl;
+        cout << "I/O indice: R=" << ic.reads << " W=" << ic.writes
+             << " (cache: hits=" << ic.cacheHits << " misses=" << ic.cacheMisses
+             << ", mmap: nos=" << ic.mappedReads << ")" << endl;
 
         if (found) {
             Record rec{};
-            if (data.find(key, rec)) {
-                auto [dR, dW] = data.getCounters();
+            bool hit = recPos != NO_RECORD && data.readAt(recPos, rec) && rec.key == key;
+            if (!hit) hit = data.find(key, rec);
+            auto [dR, dW] = data.getCounters();
+            auto [hR, hW] = data.getHashCounters();
+            if (hit) {
                 cout << "Registro: key=" << rec.key << " payload=\"" << rec.payload << "\" active=" << rec.active << endl;
-                cout << "I/O dados: R=" << dR << " W=" << dW << endl;
             } else {
-                auto [dR, dW] = data.getCounters();
                 cout << "Registro nao encontrado no arquivo principal." << endl;
-                cout << "I/O dados: R=" << dR << " W=" << dW << endl;
             }
+            cout << "I/O dados: R=" << dR << " W=" << dW << " (hash: R=" << hR << " W=" << hW << ")" << endl;
         }
 
         char c = readYesNo("Continuar busca (s/n)? ");
@@ -138,9 +155,12 @@ void runSearchInterface(MWayTree& tree, DataFile& data) {
 
 /**
  * @brief Ponto de entrada: menu para criar/abrir índice e operar (buscar, inserir, remover, verificar).
+ * @details Com argumentos, executa o modo não interativo (subcomandos, ver CommandLine.h).
  * @return Código de retorno do processo (0 em sucesso).
  */
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1) return runCommandLine(argc, argv);
+
     cout << "Selecione uma opcao de inicializacao:" << endl;
     cout << "1. Abrir indice existente (mvias.bin)" << endl;
     cout << "2. Criar indice a partir de um .txt" << endl;
@@ -166,8 +186,15 @@ int main() {
             cout << "Indice inexistente. Crie primeiro pelo menu." << endl;
             return 1;
         }
+        if (NodeFormat::isLegacyFile(binPath.string())) {
+            cout << "mvias.bin no formato antigo; convertendo para o formato versionado..." << endl;
+            if (!NodeFormat::convertLegacy(binPath.string(), binPath.string())) {
+                cout << "Falha ao converter mvias.bin." << endl;
+                return 1;
+            }
+        }
         int mHdr = 0, rHdr = 0;
-        if (!MWayTree::readHeader(binPath.string(), mHdr, rHdr)) {
+        if (!MWayTree<>::readHeader(binPath.string(), mHdr, rHdr)) {
             cout << "Header invalido em mvias.bin." << endl;
             return 1;
         }
@@ -188,20 +215,24 @@ int main() {
         textFile = TEXT_FILES[choice - 1];
         std::filesystem::path textPath = cwd / textFile;
 
-        if (!MWayTree::createFromText(textPath.string(), binPath.string(), order)) {
-            cout << "Falha ao criar indice a partir de " << textPath.string() << endl;
-            return 1;
-        }
-        if (!DataFile::createFromText(textPath.string(), dataPath.string())) {
-            cout << "Falha ao criar arquivo de dados a partir de " << textPath.string() << endl;
+        ImportStats is;
+        if (!importNodeText(textPath.string(), binPath.string(), dataPath.string(), order, is)) {
+            cout << "Falha ao criar indice e arquivo de dados a partir de " << textPath.string() << endl;
             return 1;
         }
+        printImportStats(is);
     } else if (init == 3) {
         order = readIntInRange(string("Informe a ordem m (3..") + to_string(MAX_M) + "): ", 3, MAX_M);
-        if (!MWayTree::createEmpty(binPath.string(), order)) {
+        int pageSize = readIntInRange("Tamanho de pagina em bytes (0 = compacto, 64..65536): ", 0, 65536);
+        if (!MWayTree<>::createEmpty(binPath.string(), order, pageSize)) {
             cout << "Falha ao criar indice vazio." << endl;
             return 1;
         }
+        if (pageSize > 0) {
+            int rHdr = 0;
+            MWayTree<>::readHeader(binPath.string(), order, rHdr);
+            cout << "Indice paginado: m derivado da pagina = " << order << endl;
+        }
         if (!std::filesystem::exists(dataPath)) {
             ofstream d(dataPath, ios::binary | ios::trunc);
             d.close();
@@ -213,14 +244,13 @@ int main() {
             cout << "Arquivo employees.txt nao encontrado em " << empPath.string() << endl;
             return 1;
         }
-        if (!DataFile::createFromEmployees(empPath.string(), dataPath.string())) {
-            cout << "Falha ao criar arquivo de dados a partir de employees.txt" << endl;
-            return 1;
-        }
-        if (!MWayTree::createEmpty(binPath.string(), order)) {
-            cout << "Falha ao criar indice vazio." << endl;
+        ImportStats is;
+        if (!importEmployees(empPath.string(), binPath.string(), dataPath.string(), order, is)) {
+            cout << "Falha ao criar indice e arquivo de dados a partir de employees.txt" << endl;
             return 1;
         }
+        cout << "Indice criado a partir de employees.txt com " << is.records << " registros (carga em lote)." << endl;
+        printImportStats(is);
     }
 
     MWayTree tree(order);
@@ -229,29 +259,22 @@ int main() {
         return 1;
     }
 
+    if (tree.getRecoveredTransactions() > 0) {
+        cout << "Recuperacao: " << tree.getRecoveredTransactions() << " transacoes reaplicadas do log." << endl;
+    }
+    tree.setWalMode(WalMode::FsyncPerOp);
+    tree.setMappedReads(true);
+
     DataFile data;
     if (!data.open(dataPath.string())) {
         cout << "Falha ao abrir arquivo de dados " << dataPath.string() << endl;
         tree.closeBinary();
         return 1;
     }
-
-    if (init == 4) {
-        vector<int> keys;
-        if (!data.listActiveKeys(keys)) {
-            cout << "Falha ao ler chaves de employees em " << dataPath.string() << endl;
-            data.close();
-            tree.closeBinary();
-            return 1;
-        }
-        for (int k : keys) {
-            tree.insertB(k);
-        }
-        cout << "Indice criado a partir de employees.txt com " << keys.size() << " registros." << endl;
-    }
+    data.setHashIndex(true);
 
     while (true) {
-        tree.displayTree(binPath.string());
+        tree.displayTree();
 
         cout << "Selecione uma opcao:" << endl;
         cout << "1. Buscar chave" << endl;
@@ -259,9 +282,11 @@ int main() {
         cout << "3. Imprimir arquivo principal" << endl;
         cout << "4. Remover chave" << endl;
         cout << "5. Verificar integridade" << endl;
-        cout << "6. Sair" << endl;
+        cout << "6. Compactar indice e arquivo principal" << endl;
+        cout << "7. Listar intervalo de chaves" << endl;
+        cout << "8. Sair" << endl;
 
-        int opt = readIntInRange("Escolha (1-6): ", 1, 6);
+        int opt = readIntInRange("Escolha (1-8): ", 1, 8);
 
         switch (opt) {
             case 1: {
@@ -270,32 +295,37 @@ int main() {
             }
             case 2: {
                 int key = readAnyInt("Chave para inserir: ");
-                Record rec{};
-                bool existsInData = data.find(key, rec);
+                int recPos = NO_RECORD;
+                bool existsInIdx = get<2>(tree.mSearch(key, nullptr, &recPos));
 
-                tree.insertB(key);
-                auto [iR, iW] = tree.getCounters();
-                cout << "I/O indice (insercao): R=" << iR << " W=" << iW << endl;
-
-                if (!existsInData) {
-                    if (employeesMode) {
+                if (!existsInIdx) {
+                    Record rec{};
+                    bool existsInData = data.find(key, rec, recPos);
+                    if (existsInData) {
+                        cout << "Registro ja existe no arquivo principal (registro " << recPos
+                             << "). Indexando o registro existente." << endl;
+                    } else if (employeesMode) {
                         string nome = readLine("Nome do funcionario: ");
                         string depto = readLine("Departamento: ");
-                        data.insertEmployee(key, nome, depto);
+                        data.insertEmployee(key, nome, depto, recPos);
                     } else {
                         Record newRec{};
                         newRec.key = key;
                         char dept = "ABCDE"[key % 5];
                         std::snprintf(newRec.payload, sizeof(newRec.payload),
                                       "Funcionario %d | depto=%c", key, dept);
-                        data.insert(newRec);
+                        data.insert(newRec, recPos);
                     }
                     auto [dR, dW] = data.getCounters();
-                    cout << "I/O dados (insercao): R=" << dR << " W=" << dW << endl;
+                    auto [hR, hW] = data.getHashCounters();
+
+                    tree.insertB(key, recPos);
+                    IndexCounters ic = tree.getCounters();
+                    cout << "I/O indice (insercao): R=" << ic.reads << " W=" << ic.writes
+                         << " (cache: hits=" << ic.cacheHits << " misses=" << ic.cacheMisses << ")" << endl;
+                    cout << "I/O dados (insercao): R=" << dR << " W=" << dW << " (hash: R=" << hR << " W=" << hW << ")" << endl;
                 } else {
-                    auto [dR, dW] = data.getCounters();
-                    cout << "Registro ja existe no arquivo principal. Nao inserido." << endl;
-                    cout << "I/O dados (find): R=" << dR << " W=" << dW << endl;
+                    cout << "Chave ja existe no indice (registro " << recPos << "). Nao inserida." << endl;
                 }
                 break;
             }
@@ -306,15 +336,18 @@ int main() {
             case 4: {
                 int key = readAnyInt("Chave para remover: ");
 
-                bool removedIdx = tree.deleteB(key);
-                auto [iR, iW] = tree.getCounters();
-                cout << "I/O indice (remocao): R=" << iR << " W=" << iW << endl;
+                int recPos = NO_RECORD;
+                bool removedIdx = tree.deleteB(key, &recPos);
+                IndexCounters ic = tree.getCounters();
+                cout << "I/O indice (remocao): R=" << ic.reads << " W=" << ic.writes
+                     << " (cache: hits=" << ic.cacheHits << " misses=" << ic.cacheMisses << ")" << endl;
 
                 if (removedIdx) {
-                    bool removedData = data.remove(key);
+                    bool removedData = (recPos != NO_RECORD) ? data.removeAt(recPos, key) : data.remove(key);
                     auto [dR, dW] = data.getCounters();
+                    auto [hR, hW] = data.getHashCounters();
                     cout << "Remocao no arquivo principal: " << (removedData ? "ok" : "nao encontrado") << endl;
-                    cout << "I/O dados (remocao): R=" << dR << " W=" << dW << endl;
+                    cout << "I/O dados (remocao): R=" << dR << " W=" << dW << " (hash: R=" << hR << " W=" << hW << ")" << endl;
                 } else {
                     cout << "Chave nao encontrada no indice." << endl;
                 }
@@ -323,9 +356,52 @@ int main() {
             case 5: {
                 bool ok = tree.verifyIntegrity(true);
                 cout << "Integridade: " << (ok ? "ok" : "falha") << endl;
+                FreeSpaceStats fs = tree.getFreeSpaceStats();
+                cout << "Nos: " << fs.totalNodes << " (livres: " << fs.freeNodes << ", "
+                     << fs.freeBytes << " de " << fs.fileBytes << " bytes)" << endl;
                 break;
             }
             case 6: {
+                int lay = readIntInRange("Ordem dos nos (1 = BFS, 2 = van Emde Boas): ", 1, 2);
+                Compactor compactor(tree, data, lay == 1 ? CompactLayout::BreadthFirst : CompactLayout::VanEmdeBoas);
+                if (!compactor.run()) {
+                    cout << "Falha na compactacao." << endl;
+                    break;
+                }
+                const CompactStats& cs = compactor.getStats();
+                cout << "Indice: " << cs.nodesBefore << " -> " << cs.nodesAfter << " nos ("
+                     << cs.indexBytesBefore << " -> " << cs.indexBytesAfter << " bytes)" << endl;
+                cout << "Dados: " << cs.recordsBefore << " -> " << cs.recordsAfter << " registros ("
+                     << cs.dataBytesBefore << " -> " << cs.dataBytesAfter << " bytes)" << endl;
+                break;
+            }
+            case 7: {
+                int lo = readAnyInt("Chave inicial: ");
+                int hi = readAnyInt("Chave final: ");
+                char desc = readYesNo("Ordem decrescente (s/n)? ");
+                tree.resetCounters();
+                TreeCursor cur(tree, &data);
+                cur.setPrefetch(2);
+                int count = 0;
+                if (desc == 's') {
+                    for (bool ok = cur.seekFloor(hi); ok && cur.key() >= lo; ok = cur.prev(), ++count) {
+                        Record rec{};
+                        if (cur.fetch(rec)) cout << "key=" << rec.key << " | payload=\"" << rec.payload << "\"" << endl;
+                        else cout << "key=" << cur.key() << " | (registro nao encontrado)" << endl;
+                    }
+                } else {
+                    for (bool ok = cur.seek(lo); ok && cur.key() <= hi; ok = cur.next(), ++count) {
+                        Record rec{};
+                        if (cur.fetch(rec)) cout << "key=" << rec.key << " | payload=\"" << rec.payload << "\"" << endl;
+                        else cout << "key=" << cur.key() << " | (registro nao encontrado)" << endl;
+                    }
+                }
+                IndexCounters ic = tree.getCounters();
+                cout << count << " chave(s). Nos lidos: " << cur.getNodeReads() << " (R=" << ic.reads
+                     << " cache hits=" << ic.cacheHits << ") | Leituras de dados: " << cur.getDataReads() << endl;
+                break;
+            }
+            case 8: {
                 data.close();
                 tree.closeBinary();
                 return 0;